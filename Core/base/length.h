@@ -31,6 +31,11 @@ struct Length {
   inline bool IsPercentage() const { return type_ == kLengthPercentage; }
   inline bool IsAuto() const { return type_ == kLengthAuto; }
 
+  bool operator==(const Length& other) const {
+    return type_ == other.type_ && value_ == other.value_;
+  }
+  bool operator!=(const Length& other) const { return !(*this == other); }
+
   float GetComputedValue(float parentValue) const {
     switch (type_) {
       case kLengthFixed:
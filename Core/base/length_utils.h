@@ -3,29 +3,32 @@
 #ifndef STARLIGHT_BASE_LENGTH_UTILS_H_
 #define STARLIGHT_BASE_LENGTH_UTILS_H_
 
-#include <string>
+#include <string_view>
 #include "base/length.h"
 #include "base/string_utils.h"
 
 namespace base {
 
-bool ToLength(const std::string& value, Length& len) {
-  if (value.compare("auto") == 0) {
+/**
+ * `auto` and `px` values are parsed, `len` stays untouched for others.
+ * parses in place without copying `value`.
+ */
+inline bool ToLength(std::string_view value, Length& len) {
+  if (value == "auto") {
     len.SetTypeAndValue(kLengthAuto, .0f);
+    return true;
   }
   if (value.empty())
     return false;
 
   bool is_px = false;
-  std::string px_str = value;
-  size_t start = value.length() - 2;
-  if (start > 0 && value.find("px", start - 1) != std::string::npos) {
+  if (value.size() > 2 && value.substr(value.size() - 2) == "px") {
     is_px = true;
-    px_str = value.substr(0, start);
+    value.remove_suffix(2);
   }
 
   float f;
-  if (!base::StringToFloat(px_str, f)) {
+  if (!base::StringToFloat(value, f)) {
     return false;
   }
   if (is_px) {
@@ -1,11 +1,7 @@
 // Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
 
-#include <ctype.h>
-#include <errno.h>
-#include <limits>
-#include <cstdint>
-#include <stdint.h>
-#include <limits.h>
+#include <charconv>
+#include <system_error>
 
 #include "base/string_utils.h"
 
@@ -13,68 +9,72 @@
 namespace base {
 #endif
 
-bool SplitString(const std::string& target,
-                 char separator,
-                 std::vector<std::string>& result) {
-  typedef std::string::size_type size_t;
-  size_t i = 0;
-  size_t value_start = INT_MAX;
-  while (i < target.size()) {
-    bool last_c = i == target.size() - 1;
-    if (target[i] != separator && value_start == INT_MAX) {
-      value_start = i;
-    } else if (target[i] == separator || i == target.size() - 1) {
-      size_t sub_num = last_c ? target.size() - value_start : i - value_start;
-      if (value_start != INT_MAX) {
-        result.push_back(target.substr(value_start, sub_num));
-        value_start = INT_MAX;
-      }
+namespace {
+
+/**
+ * whole input has to be a number. unlike strto*, from_chars takes no leading
+ * '+', skip it so that the same inputs are accepted.
+ */
+template <typename T, typename... Args>
+bool FromChars(std::string_view input, T& output, Args... args) {
+  if (!input.empty() && input[0] == '+') {
+    input.remove_prefix(1);
+    if (!input.empty() && input[0] == '-') {
+      return false;
     }
-    i++;
   }
-  return !result.empty();
+  T value;
+  const char* end = input.data() + input.size();
+  std::from_chars_result result =
+      std::from_chars(input.data(), end, value, args...);
+  if (result.ec != std::errc() || result.ptr != end) {
+    return false;
+  }
+  output = value;
+  return true;
+}
+
+}  // namespace
+
+size_t SplitString(std::string_view target,
+                   char separator,
+                   std::string_view* result,
+                   size_t max_count) {
+  size_t count = 0;
+  size_t value_start = 0;
+  while (count < max_count && value_start < target.size()) {
+    size_t value_end = target.find(separator, value_start);
+    if (value_end == std::string_view::npos) {
+      value_end = target.size();
+    }
+    if (value_end > value_start) {
+      result[count++] = target.substr(value_start, value_end - value_start);
+    }
+    value_start = value_end + 1;
+  }
+  return count;
+}
+
+std::string_view TrimString(std::string_view input) {
+  const char* whitespace = " \t\n\r\f\v";
+  size_t start = input.find_first_not_of(whitespace);
+  if (start == std::string_view::npos) {
+    return std::string_view();
+  }
+  size_t end = input.find_last_not_of(whitespace);
+  return input.substr(start, end - start + 1);
 }
 
-bool StringToFloat(const std::string& input, float& output) {
-  int old_error = errno;
-  errno = 0;
-  char* endptr = NULL;
-  float d = strtof(input.c_str(), &endptr);
-  bool valid = (errno == 0 && !input.empty() &&
-                input.c_str() + input.length() == endptr && !isspace(input[0]));
-  if (errno == 0)
-    errno = old_error;
-  if (valid)
-    output = d;
-  return valid;
+bool StringToFloat(std::string_view input, float& output) {
+  return FromChars(input, output);
 }
 
-bool StringToDouble(const std::string& input, double& output) {
-  int old_error = errno;
-  errno = 0;
-  char* endptr = NULL;
-  double d = strtod(input.c_str(), &endptr);
-  bool valid = (errno == 0 && !input.empty() &&
-                input.c_str() + input.length() == endptr && !isspace(input[0]));
-  if (errno == 0)
-    errno = old_error;
-  if (valid)
-    output = d;
-  return valid;
+bool StringToDouble(std::string_view input, double& output) {
+  return FromChars(input, output);
 }
 
-bool StringToInt(const std::string& input, int64_t& output, uint8_t base) {
-  int old_error = errno;
-  errno = 0;
-  char* endptr = NULL;
-  int64_t i = strtoll(input.c_str(), &endptr, base);
-  bool valid = (errno == 0 && !input.empty() &&
-                input.c_str() + input.length() == endptr && !isspace(input[0]));
-  if (errno == 0)
-    errno = old_error;
-  if (valid)
-    output = i;
-  return valid;
+bool StringToInt(std::string_view input, int64_t& output, uint8_t base) {
+  return FromChars(input, output, static_cast<int>(base));
 }
 
 #ifdef __cplusplus
@@ -3,19 +3,27 @@
 #ifndef STARLIGHT_BASE_STRING_UTILS_H_
 #define STARLIGHT_BASE_STRING_UTILS_H_
 
-#include <string>
-#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 
 #ifdef __cplusplus
 namespace base {
 #endif
 
-bool SplitString(const std::string& target,
-                 char separator,
-                 std::vector<std::string>& result);
-bool StringToFloat(const std::string& input, float& output);
-bool StringToDouble(const std::string& input, double& output);
-bool StringToInt(const std::string& input, int64_t& output, uint8_t base = 10);
+/**
+ * splits `target` into its non-empty parts in place, storing at most
+ * `max_count` of them into `result`. returns the number of stored parts.
+ */
+size_t SplitString(std::string_view target,
+                   char separator,
+                   std::string_view* result,
+                   size_t max_count);
+// `input` without leading and trailing whitespace
+std::string_view TrimString(std::string_view input);
+bool StringToFloat(std::string_view input, float& output);
+bool StringToDouble(std::string_view input, double& output);
+bool StringToInt(std::string_view input, int64_t& output, uint8_t base = 10);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,135 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include "base/thread_pool.h"
+
+namespace base {
+
+thread_local ThreadPool* ThreadPool::current_ = nullptr;
+thread_local size_t ThreadPool::current_queue_index_ = 0;
+
+ThreadPool::ThreadPool(size_t thread_count)
+    : queued_count_(0), sleeping_count_(0), stopping_(false) {
+  for (size_t i = 0; i <= thread_count; ++i) {
+    queues_.emplace_back(new TaskQueue());
+  }
+  for (size_t i = 0; i < thread_count; ++i) {
+    workers_.emplace_back(&ThreadPool::WorkerMain, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stopping_ = true;
+  }
+  sleep_condition_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+ThreadPool::Scope::Scope(ThreadPool* pool)
+    : previous_(current_), previous_queue_index_(current_queue_index_) {
+  current_ = pool;
+  current_queue_index_ = pool ? pool->queues_.size() - 1 : 0;
+}
+
+ThreadPool::Scope::~Scope() {
+  current_ = previous_;
+  current_queue_index_ = previous_queue_index_;
+}
+
+void ThreadPool::Push(Task task) {
+  size_t queue_index =
+      current_ == this ? current_queue_index_ : queues_.size() - 1;
+  {
+    std::lock_guard<std::mutex> lock(queues_[queue_index]->mutex_);
+    queues_[queue_index]->tasks_.push_back(std::move(task));
+  }
+  queued_count_.fetch_add(1);
+  if (sleeping_count_.load() == 0) {
+    // a worker about to sleep either sees the new task or is counted
+    return;
+  }
+  // a worker between its last look at the queues and going to sleep holds
+  // the mutex, so the notification can not get lost
+  { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+  sleep_condition_.notify_one();
+}
+
+bool ThreadPool::PopTask(size_t queue_index, bool newest, Task& task) {
+  TaskQueue& queue = *queues_[queue_index];
+  std::lock_guard<std::mutex> lock(queue.mutex_);
+  if (queue.tasks_.empty()) {
+    return false;
+  }
+  if (newest) {
+    task = std::move(queue.tasks_.back());
+    queue.tasks_.pop_back();
+  } else {
+    task = std::move(queue.tasks_.front());
+    queue.tasks_.pop_front();
+  }
+  queued_count_.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+/**
+ * newest own task first, it is the one whose data is still in cache. others
+ * are stolen oldest first, those usually are the largest pieces of work.
+ */
+bool ThreadPool::RunPendingTask() {
+  if (queued_count_.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+  size_t own_index =
+      current_ == this ? current_queue_index_ : queues_.size() - 1;
+  Task task;
+  bool found = PopTask(own_index, true, task);
+  for (size_t i = 1; !found && i < queues_.size(); ++i) {
+    found = PopTask((own_index + i) % queues_.size(), false, task);
+  }
+  if (!found) {
+    return false;
+  }
+  task.function_();
+  task.group_->pending_count_.fetch_sub(1, std::memory_order_acq_rel);
+  return true;
+}
+
+void ThreadPool::WorkerMain(size_t index) {
+  current_ = this;
+  current_queue_index_ = index;
+  while (true) {
+    if (RunPendingTask()) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    sleeping_count_.fetch_add(1);
+    sleep_condition_.wait(
+        lock, [this] { return stopping_ || queued_count_.load() > 0; });
+    sleeping_count_.fetch_sub(1);
+    if (stopping_) {
+      return;
+    }
+  }
+}
+
+void TaskGroup::Fork(std::function<void()> function) {
+  pending_count_.fetch_add(1, std::memory_order_relaxed);
+  pool_->Push(ThreadPool::Task{std::move(function), this});
+}
+
+/**
+ * the waiting thread helps with queued tasks, also those of other groups,
+ * until the last task of this group has finished
+ */
+void TaskGroup::Wait() {
+  while (pending_count_.load(std::memory_order_acquire) > 0) {
+    if (!pool_->RunPendingTask()) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+}  // namespace base
\ No newline at end of file
@@ -0,0 +1,130 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#ifndef STARLIGHT_BASE_THREAD_POOL_H_
+#define STARLIGHT_BASE_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace base {
+
+class TaskGroup;
+
+/**
+ * work-stealing pool for fork-join work. every worker owns a queue which it
+ * takes its newest task from, idle workers steal the oldest task of another
+ * queue. threads outside the pool share one more queue. a thread waiting for
+ * its tasks runs queued ones meanwhile, so tasks may fork and wait themselves.
+ */
+class ThreadPool {
+ public:
+  // `thread_count` workers in addition to the threads which wait for tasks
+  explicit ThreadPool(size_t thread_count);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * pool of the calling worker, or of the innermost Scope on a thread outside
+   * the pool. null if there is none.
+   */
+  static ThreadPool* Current() { return current_; }
+
+  // makes the pool current for a thread outside of it
+  class Scope {
+   public:
+    explicit Scope(ThreadPool* pool);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    ThreadPool* previous_;
+    size_t previous_queue_index_;
+  };
+
+  size_t thread_count() const { return workers_.size(); }
+
+ private:
+  friend class TaskGroup;
+
+  struct Task {
+    std::function<void()> function_;
+    TaskGroup* group_;
+  };
+
+  struct TaskQueue {
+    std::mutex mutex_;
+    std::deque<Task> tasks_;
+  };
+
+  bool NeedsTasks() const {
+    return queued_count_.load(std::memory_order_relaxed) < workers_.size();
+  }
+  void Push(Task task);
+  // runs one queued task, preferring the calling thread's own queue
+  bool RunPendingTask();
+  bool PopTask(size_t queue_index, bool newest, Task& task);
+  void WorkerMain(size_t index);
+
+  static thread_local ThreadPool* current_;
+  // queue of the calling thread inside `current_`
+  static thread_local size_t current_queue_index_;
+
+  std::vector<std::thread> workers_;
+  // one per worker, the last one for threads outside the pool
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::atomic<size_t> queued_count_;
+  std::atomic<size_t> sleeping_count_;
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_condition_;
+  bool stopping_;
+};
+
+/**
+ * tasks forked from one place. without a pool tasks run right away on the
+ * calling thread. Wait() returns once all tasks of the group have run.
+ */
+class TaskGroup {
+ public:
+  explicit TaskGroup(ThreadPool* pool) : pool_(pool), pending_count_(0) {}
+  ~TaskGroup() { Wait(); }
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  /**
+   * `fork` false runs the task on the calling thread although there is a
+   * pool. tasks also run right away while the pool has enough queued ones to
+   * keep its workers busy, queueing costs more than running them in place.
+   */
+  template <typename Function>
+  void Run(Function function, bool fork = true) {
+    if (pool_ == nullptr || !fork || !pool_->NeedsTasks()) {
+      function();
+      return;
+    }
+    Fork(std::function<void()>(std::move(function)));
+  }
+
+  void Wait();
+
+ private:
+  friend class ThreadPool;
+
+  // kept out of line, most tasks run right away
+  void Fork(std::function<void()> function);
+
+  ThreadPool* pool_;
+  std::atomic<size_t> pending_count_;
+};
+
+}  // namespace base
+
+#endif
\ No newline at end of file
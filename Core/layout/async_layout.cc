@@ -0,0 +1,120 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include "layout/async_layout.h"
+
+#include <utility>
+
+namespace starlight {
+
+AsyncLayout::AsyncLayout(LayoutNode* root)
+    : root_(root),
+      constraints_(.0f, .0f, kLayoutModeUndefined, kLayoutModeUndefined),
+      has_request_(false),
+      running_(false),
+      stopping_(false),
+      frame_ready_(false),
+      front_(0),
+      thread_(&AsyncLayout::LayoutMain, this) {}
+
+AsyncLayout::~AsyncLayout() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  condition_.notify_all();
+  thread_.join();
+}
+
+void AsyncLayout::Mutate(std::function<void()> mutation) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  mutations_.push_back(std::move(mutation));
+}
+
+void AsyncLayout::RequestLayout(const LayoutConstraints& constraints) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    constraints_ = constraints;
+    has_request_ = true;
+  }
+  condition_.notify_all();
+}
+
+/**
+ * the back frame is never written while it is ready, publishing clears the
+ * flag first. a flip therefore always exposes a complete frame.
+ */
+bool AsyncLayout::Commit() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!frame_ready_) {
+    return false;
+  }
+  front_ = 1 - front_;
+  frame_ready_ = false;
+  return true;
+}
+
+void AsyncLayout::WaitUntilIdle() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.wait(lock, [this] { return !has_request_ && !running_; });
+}
+
+/**
+ * mutations are swapped out under the lock and applied without it, the host
+ * keeps queueing meanwhile. a pass is checked for newer requests once it is
+ * done instead of being stopped halfway: measure caches filled by the
+ * superseded pass stay valid for what the mutations did not touch, so the
+ * next pass only redoes the dirty part.
+ */
+void AsyncLayout::LayoutMain() {
+  std::vector<std::function<void()>> mutations;
+  LayoutConstraints constraints(.0f,
+                                .0f,
+                                kLayoutModeUndefined,
+                                kLayoutModeUndefined);
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      running_ = false;
+      condition_.notify_all();
+      condition_.wait(lock, [this] { return stopping_ || has_request_; });
+      if (stopping_) {
+        return;
+      }
+      mutations.swap(mutations_);
+      constraints = constraints_;
+      has_request_ = false;
+      running_ = true;
+    }
+    for (std::function<void()>& mutation : mutations) {
+      mutation();
+    }
+    mutations.clear();
+    root_->ReLayout(constraints);
+
+    int back = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (has_request_ || stopping_) {
+        continue;
+      }
+      frame_ready_ = false;
+      back = 1 - front_;
+    }
+    Publish(root_, back);
+    std::lock_guard<std::mutex> lock(mutex_);
+    frame_ready_ = true;
+  }
+}
+
+void AsyncLayout::Publish(LayoutNode* node, int buffer) {
+  LayoutResult& result = node->frame_results_[buffer];
+  result.offset_top_ = node->offset_top_;
+  result.offset_left_ = node->offset_left_;
+  result.offset_width_ = node->offset_width_;
+  result.offset_height_ = node->offset_height_;
+  for (LayoutNode* child = node->first_child_; child; child = child->next_) {
+    Publish(child, buffer);
+  }
+}
+
+}  // namespace starlight
\ No newline at end of file
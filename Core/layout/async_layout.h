@@ -0,0 +1,76 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#ifndef STARLIGHT_LAYOUT_ASYNC_LAYOUT_H_
+#define STARLIGHT_LAYOUT_ASYNC_LAYOUT_H_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "layout/layout_node.h"
+
+namespace starlight {
+
+/**
+ * lays out the tree of `root` on a thread of its own. the host queues
+ * mutations instead of touching the tree, the layout thread applies them in
+ * order before each pass and publishes the results of the pass into the back
+ * frame of every node. Commit swaps the last finished frame in, results read
+ * with GetResult stay put until the next Commit.
+ *
+ * once bound, the tree, its nodes and its context belong to the layout thread:
+ * nodes are created, styled, inserted and freed inside mutations, the host
+ * only keeps pointers to them for GetResult.
+ */
+class AsyncLayout {
+ public:
+  explicit AsyncLayout(LayoutNode* root);
+  // waits for a running pass, mutations queued since are dropped
+  ~AsyncLayout();
+  AsyncLayout(const AsyncLayout&) = delete;
+  AsyncLayout& operator=(const AsyncLayout&) = delete;
+
+  // runs on the layout thread before the next pass
+  void Mutate(std::function<void()> mutation);
+  /**
+   * asks for a pass over everything queued so far. a pass still running when
+   * newer mutations arrive is superseded: its frame is never published and
+   * the next pass picks up from the state it left behind.
+   */
+  void RequestLayout(const LayoutConstraints& constraints);
+  // swaps in the last published frame, returns false if none is ready
+  bool Commit();
+  // results of `node` in the committed frame, host thread only
+  const LayoutResult& GetResult(const LayoutNode* node) const {
+    return node->frame_results_[front_];
+  }
+
+  // blocks until requested passes are done, published or superseded
+  void WaitUntilIdle();
+
+ private:
+  void LayoutMain();
+  void Publish(LayoutNode* node, int buffer);
+
+  LayoutNode* root_;
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::vector<std::function<void()>> mutations_;
+  LayoutConstraints constraints_;
+  bool has_request_;
+  bool running_;
+  bool stopping_;
+  // a frame is ready once published, until committed or published over
+  bool frame_ready_;
+  // frame read by the host, written by Commit on the host thread only
+  int front_;
+
+  std::thread thread_;
+};
+
+}  // namespace starlight
+
+#endif
\ No newline at end of file
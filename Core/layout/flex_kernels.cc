@@ -0,0 +1,152 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include "layout/flex_kernels.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace starlight {
+
+namespace {
+
+/**
+ * lane operations of one instruction set. Max(a, b) and Min(a, b) return `b`
+ * unless `a` compares greater or less, the same as std::max(b, a) and
+ * std::min(b, a) the scalar layout code clamps with.
+ */
+#if defined(__AVX2__)
+struct Lanes {
+  typedef __m256 Vector;
+  static const size_t kCount = 8;
+  static Vector Broadcast(float value) { return _mm256_set1_ps(value); }
+  static Vector Load(const float* values) { return _mm256_loadu_ps(values); }
+  static Vector LoadMask(const uint32_t* mask) {
+    return _mm256_castsi256_ps(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask)));
+  }
+  static void Store(float* values, Vector vector) {
+    _mm256_storeu_ps(values, vector);
+  }
+  static Vector Add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+  static Vector Mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+  static Vector Div(Vector a, Vector b) { return _mm256_div_ps(a, b); }
+  static Vector Max(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+  static Vector Min(Vector a, Vector b) { return _mm256_min_ps(a, b); }
+  static Vector NotZero(Vector a) {
+    return _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_NEQ_UQ);
+  }
+  static Vector Select(Vector mask, Vector a, Vector b) {
+    return _mm256_blendv_ps(b, a, mask);
+  }
+};
+#elif defined(__SSE2__)
+struct Lanes {
+  typedef __m128 Vector;
+  static const size_t kCount = 4;
+  static Vector Broadcast(float value) { return _mm_set1_ps(value); }
+  static Vector Load(const float* values) { return _mm_loadu_ps(values); }
+  static Vector LoadMask(const uint32_t* mask) {
+    return _mm_castsi128_ps(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask)));
+  }
+  static void Store(float* values, Vector vector) {
+    _mm_storeu_ps(values, vector);
+  }
+  static Vector Add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+  static Vector Mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+  static Vector Div(Vector a, Vector b) { return _mm_div_ps(a, b); }
+  static Vector Max(Vector a, Vector b) { return _mm_max_ps(a, b); }
+  static Vector Min(Vector a, Vector b) { return _mm_min_ps(a, b); }
+  static Vector NotZero(Vector a) { return _mm_cmpneq_ps(a, _mm_setzero_ps()); }
+  static Vector Select(Vector mask, Vector a, Vector b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+  }
+};
+#else
+struct Lanes {
+  struct Vector {
+    float value_;
+    bool mask_;
+  };
+  static const size_t kCount = 1;
+  static Vector Broadcast(float value) { return {value, false}; }
+  static Vector Load(const float* values) { return {*values, false}; }
+  static Vector LoadMask(const uint32_t* mask) { return {.0f, *mask != 0}; }
+  static void Store(float* values, Vector vector) { *values = vector.value_; }
+  static Vector Add(Vector a, Vector b) { return {a.value_ + b.value_, false}; }
+  static Vector Mul(Vector a, Vector b) { return {a.value_ * b.value_, false}; }
+  static Vector Div(Vector a, Vector b) { return {a.value_ / b.value_, false}; }
+  static Vector Max(Vector a, Vector b) {
+    return a.value_ > b.value_ ? a : b;
+  }
+  static Vector Min(Vector a, Vector b) {
+    return a.value_ < b.value_ ? a : b;
+  }
+  static Vector NotZero(Vector a) { return {.0f, a.value_ != .0f}; }
+  static Vector Select(Vector mask, Vector a, Vector b) {
+    return mask.mask_ ? a : b;
+  }
+};
+#endif
+
+static_assert(Lanes::kCount == kFlexLaneCount, "lane count mismatch");
+
+}  // namespace
+
+void FlexLineArrays::Reset(size_t count) {
+  count_ = count;
+  size_t padded_count =
+      (count + kFlexLaneCount - 1) / kFlexLaneCount * kFlexLaneCount;
+  flex_base_size_.assign(padded_count, .0f);
+  flex_grow_.assign(padded_count, .0f);
+  flex_shrink_.assign(padded_count, .0f);
+  min_size_.assign(padded_count, .0f);
+  max_size_.assign(padded_count, .0f);
+  min_border_box_size_.assign(padded_count, .0f);
+  frozen_.assign(padded_count, ~0u);
+  target_size_.assign(padded_count, .0f);
+  used_size_.assign(padded_count, .0f);
+}
+
+/**
+ * operations follow the per-item code step by step, a lane computes exactly
+ * what one iteration of it did. an item without a shrink factor gets no
+ * share, not a zero computed from it whose sign might differ.
+ */
+void ResolveFlexItemSizes(FlexLineArrays& arrays,
+                          FreeSpaceShare share,
+                          float free_space,
+                          float total_factor) {
+  typedef Lanes::Vector Vector;
+  const Vector free = Lanes::Broadcast(free_space);
+  const Vector total = Lanes::Broadcast(total_factor);
+  const Vector zero = Lanes::Broadcast(.0f);
+  for (size_t i = 0; i < arrays.frozen_.size(); i += Lanes::kCount) {
+    Vector flex_base_size = Lanes::Load(&arrays.flex_base_size_[i]);
+    Vector extra_space = zero;
+    if (share == kFreeSpaceShareGrow) {
+      extra_space = Lanes::Div(
+          Lanes::Mul(free, Lanes::Load(&arrays.flex_grow_[i])), total);
+    } else if (share == kFreeSpaceShareShrink) {
+      Vector flex_shrink = Lanes::Load(&arrays.flex_shrink_[i]);
+      extra_space = Lanes::Select(
+          Lanes::NotZero(flex_shrink),
+          Lanes::Div(Lanes::Mul(Lanes::Mul(free, flex_shrink), flex_base_size),
+                     total),
+          zero);
+    }
+    Vector target_size = Lanes::Add(flex_base_size, extra_space);
+    Vector used_size =
+        Lanes::Max(Lanes::Load(&arrays.min_size_[i]), target_size);
+    used_size = Lanes::Min(Lanes::Load(&arrays.max_size_[i]), used_size);
+    used_size =
+        Lanes::Max(Lanes::Load(&arrays.min_border_box_size_[i]), used_size);
+    Lanes::Store(&arrays.target_size_[i], target_size);
+    Lanes::Store(&arrays.used_size_[i],
+                 Lanes::Select(Lanes::LoadMask(&arrays.frozen_[i]),
+                               Lanes::Load(&arrays.used_size_[i]), used_size));
+  }
+}
+
+}  // namespace starlight
\ No newline at end of file
@@ -0,0 +1,67 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#ifndef STARLIGHT_LAYOUT_FLEX_KERNELS_H_
+#define STARLIGHT_LAYOUT_FLEX_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace starlight {
+
+// items a kernel works on at once
+#if defined(__AVX2__)
+const size_t kFlexLaneCount = 8;
+#elif defined(__SSE2__)
+const size_t kFlexLaneCount = 4;
+#else
+const size_t kFlexLaneCount = 1;
+#endif
+
+/**
+ * items of one flex line while its flexible lengths get resolved, one entry
+ * per item and array. sizes are along the main axis. arrays are padded to a
+ * multiple of kFlexLaneCount with frozen items of size zero.
+ */
+struct FlexLineArrays {
+  // drops the previous line, `count` entries are filled in by the caller
+  void Reset(size_t count);
+
+  size_t count_ = 0;
+  std::vector<float> flex_base_size_;
+  std::vector<float> flex_grow_;
+  std::vector<float> flex_shrink_;
+  std::vector<float> min_size_;
+  std::vector<float> max_size_;
+  std::vector<float> min_border_box_size_;
+  // all bits set for frozen items
+  std::vector<uint32_t> frozen_;
+  // flex base size plus the share of free space
+  std::vector<float> target_size_;
+  // target size clamped by min, max and the border box
+  std::vector<float> used_size_;
+};
+
+// how the free space of a line is shared out
+enum FreeSpaceShare {
+  kFreeSpaceShareNone,
+  // by flex grow factor
+  kFreeSpaceShareGrow,
+  // by flex shrink factor scaled by flex base size
+  kFreeSpaceShareShrink,
+};
+
+/**
+ * target and used sizes of the unfrozen items for `free_space` shared out by
+ * `share`. `total_factor` is the sum of the factors of unfrozen items, scaled
+ * the same way. results match the per-item arithmetic bit for bit, frozen
+ * items keep their used size.
+ */
+void ResolveFlexItemSizes(FlexLineArrays& arrays,
+                          FreeSpaceShare share,
+                          float free_space,
+                          float total_factor);
+
+}  // namespace starlight
+
+#endif
\ No newline at end of file
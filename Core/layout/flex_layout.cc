@@ -2,18 +2,368 @@
 
 #include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <utility>
 
+#include "layout/flex_kernels.h"
 #include "layout/flex_layout.h"
+#include "layout/layout_context.h"
 #include "layout/layout_node.h"
 #include "layout/style.h"
+#include "base/thread_pool.h"
 
 namespace starlight {
 
-FlexLayoutAlgorithm::FlexLayoutAlgorithm(LayoutNode* container,
-                                         const CSSStyle* container_style)
+namespace {
+
+// a round of the spec loop costs about as much as sorting the line's items
+// by one bit of their count, times this. see RoundsBeforeSweep
+const size_t kFlexRoundsPerSortLevel = 4;
+
+/**
+ * sums over the first positions of an order, a Fenwick tree. entries are
+ * taken out again by adding their negation.
+ */
+class ThresholdSums {
+ public:
+  void Reset(size_t count) { nodes_.assign(count + 1, Node()); }
+
+  void Add(size_t position, double size_delta, double flex_factor, int count) {
+    for (size_t i = position + 1; i < nodes_.size(); i += i & (~i + 1)) {
+      nodes_[i].size_delta_ += size_delta;
+      nodes_[i].flex_factor_ += flex_factor;
+      nodes_[i].count_ += count;
+    }
+  }
+
+  // over positions [0, end)
+  void Sum(size_t end,
+           double& size_delta,
+           double& flex_factor,
+           int& count) const {
+    size_delta = .0;
+    flex_factor = .0;
+    count = 0;
+    for (size_t i = end; i > 0; i -= i & (~i + 1)) {
+      size_delta += nodes_[i].size_delta_;
+      flex_factor += nodes_[i].flex_factor_;
+      count += nodes_[i].count_;
+    }
+  }
+
+ private:
+  struct Node {
+    double size_delta_ = .0;
+    double flex_factor_ = .0;
+    int count_ = 0;
+  };
+  std::vector<Node> nodes_;
+};
+
+/**
+ * unfrozen items of a line ordered by the free space per unit of flex factor
+ * at which they hit a clamp. at any share of free space, items violating
+ * their min are a prefix of the order by min threshold descending and items
+ * violating their max a prefix of the order by max threshold ascending, so
+ * a round of the spec loop comes down to two searches and two prefix sums.
+ */
+class ViolationSweep {
+ public:
+  void Reset(const FlexLineArrays& arrays, bool should_apply_grow);
+  /**
+   * min violations minus max violations of unfrozen items at `share` free
+   * space per flex factor, and where they end in their orders. returns false
+   * if no item violates a clamp.
+   */
+  bool FindViolations(double share,
+                      double& total_violation,
+                      size_t& min_end,
+                      size_t& max_end) const;
+  // unfrozen items of one order before `end`, their used size is set to
+  // their clamp
+  void TakeViolations(bool min_violations,
+                      size_t end,
+                      FlexLineArrays& arrays,
+                      std::vector<size_t>& item_indices);
+
+ private:
+  // a threshold and the index of its item
+  typedef std::pair<double, size_t> Threshold;
+
+  struct Order {
+    void Reset(size_t count);
+    // in order
+    std::vector<Threshold> items_;
+    // position of each item index in `items_`
+    std::vector<size_t> positions_;
+    // clamp minus flex base size and flex factor of unfrozen items
+    ThresholdSums sums_;
+    // positions before are taken
+    size_t next_;
+  };
+
+  void Remove(size_t index, const FlexLineArrays& arrays);
+
+  std::vector<float> min_clamps_;
+  std::vector<float> max_clamps_;
+  std::vector<double> flex_factors_;
+  Order min_order_;
+  Order max_order_;
+};
+
+void ViolationSweep::Order::Reset(size_t count) {
+  positions_.assign(count, 0);
+  for (size_t position = 0; position < items_.size(); ++position) {
+    positions_[items_[position].second] = position;
+  }
+  sums_.Reset(items_.size());
+  next_ = 0;
+}
+
+/**
+ * clamps are what the item's clamp makes of infinitely small and large
+ * sizes, the values it picks from are the same ones
+ */
+void ViolationSweep::Reset(const FlexLineArrays& arrays,
+                           bool should_apply_grow) {
+  const double infinity = std::numeric_limits<double>::infinity();
+  const float float_infinity = std::numeric_limits<float>::infinity();
+  size_t count = arrays.count_;
+  min_clamps_.assign(count, .0f);
+  max_clamps_.assign(count, .0f);
+  flex_factors_.assign(count, .0);
+  min_order_.items_.clear();
+  max_order_.items_.clear();
+  for (size_t index = 0; index < count; ++index) {
+    if (arrays.frozen_[index]) {
+      continue;
+    }
+    float min_size = arrays.min_size_[index];
+    float max_size = arrays.max_size_[index];
+    float min_border_box_size = arrays.min_border_box_size_[index];
+    min_clamps_[index] = std::max(
+        std::min(std::max(-float_infinity, min_size), max_size),
+        min_border_box_size);
+    max_clamps_[index] = std::max(
+        std::min(std::max(float_infinity, min_size), max_size),
+        min_border_box_size);
+
+    double flex_base_size = arrays.flex_base_size_[index];
+    double flex_factor =
+        should_apply_grow
+            ? arrays.flex_grow_[index]
+            : static_cast<double>(arrays.flex_shrink_[index]) * flex_base_size;
+    flex_factors_[index] = flex_factor;
+    double min_delta = min_clamps_[index] - flex_base_size;
+    double max_delta = max_clamps_[index] - flex_base_size;
+    double min_threshold = min_delta > 0 ? infinity : -infinity;
+    double max_threshold = max_delta < 0 ? -infinity : infinity;
+    if (flex_factor > 0) {
+      min_threshold = min_delta / flex_factor;
+      max_threshold = max_delta / flex_factor;
+    }
+    min_order_.items_.emplace_back(min_threshold, index);
+    max_order_.items_.emplace_back(max_threshold, index);
+  }
+
+  std::sort(min_order_.items_.begin(), min_order_.items_.end(),
+            [](const Threshold& lhs, const Threshold& rhs) {
+              return lhs.first > rhs.first ||
+                     (lhs.first == rhs.first && lhs.second < rhs.second);
+            });
+  std::sort(max_order_.items_.begin(), max_order_.items_.end());
+  min_order_.Reset(count);
+  max_order_.Reset(count);
+  for (const auto& item : min_order_.items_) {
+    size_t index = item.second;
+    double flex_base_size = arrays.flex_base_size_[index];
+    min_order_.sums_.Add(min_order_.positions_[index],
+                         min_clamps_[index] - flex_base_size,
+                         flex_factors_[index], 1);
+    max_order_.sums_.Add(max_order_.positions_[index],
+                         max_clamps_[index] - flex_base_size,
+                         flex_factors_[index], 1);
+  }
+}
+
+bool ViolationSweep::FindViolations(double share,
+                                    double& total_violation,
+                                    size_t& min_end,
+                                    size_t& max_end) const {
+  min_end = std::partition_point(
+                min_order_.items_.begin(), min_order_.items_.end(),
+                [share](const Threshold& item) { return item.first > share; }) -
+            min_order_.items_.begin();
+  max_end = std::partition_point(
+                max_order_.items_.begin(), max_order_.items_.end(),
+                [share](const Threshold& item) { return item.first < share; }) -
+            max_order_.items_.begin();
+
+  double min_delta, min_factor, max_delta, max_factor;
+  int min_count, max_count;
+  min_order_.sums_.Sum(min_end, min_delta, min_factor, min_count);
+  max_order_.sums_.Sum(max_end, max_delta, max_factor, max_count);
+  // a min violation is the clamp minus the target size, a max violation the
+  // target size minus the clamp
+  total_violation = (min_delta - share * min_factor) -
+                    (share * max_factor - max_delta);
+  return min_count > 0 || max_count > 0;
+}
+
+void ViolationSweep::TakeViolations(bool min_violations,
+                                    size_t end,
+                                    FlexLineArrays& arrays,
+                                    std::vector<size_t>& item_indices) {
+  Order& order = min_violations ? min_order_ : max_order_;
+  const std::vector<float>& clamps =
+      min_violations ? min_clamps_ : max_clamps_;
+  item_indices.clear();
+  for (; order.next_ < end; ++order.next_) {
+    size_t index = order.items_[order.next_].second;
+    // taken by the other order before
+    if (arrays.frozen_[index]) {
+      continue;
+    }
+    arrays.used_size_[index] = clamps[index];
+    item_indices.push_back(index);
+  }
+  for (size_t index : item_indices) {
+    Remove(index, arrays);
+  }
+  // frozen in item order, the line's sums are rounded the way the spec loop
+  // rounds them
+  std::sort(item_indices.begin(), item_indices.end());
+}
+
+void ViolationSweep::Remove(size_t index, const FlexLineArrays& arrays) {
+  double flex_base_size = arrays.flex_base_size_[index];
+  min_order_.sums_.Add(min_order_.positions_[index],
+                       -(min_clamps_[index] - flex_base_size),
+                       -flex_factors_[index], -1);
+  max_order_.sums_.Add(max_order_.positions_[index],
+                       -(max_clamps_[index] - flex_base_size),
+                       -flex_factors_[index], -1);
+}
+
+/**
+ * lists which only live during one step of a container's layout. they are
+ * kept per thread and reused by every container laid out on it, these steps
+ * never lay out another container in between.
+ */
+struct ScratchLists {
+  FlexLineArrays flex_line_;
+  // indices into `flex_line_`
+  std::vector<size_t> inflexible_items_;
+  std::vector<size_t> min_violations_;
+  std::vector<size_t> max_violations_;
+  ViolationSweep violation_sweep_;
+  // lines of the last pass while lines are broken again
+  std::vector<FlexLine> previous_lines_;
+  std::vector<LayoutNode*> line_items_;
+  std::vector<std::pair<size_t, bool>> auto_margins_;
+};
+
+thread_local ScratchLists scratch_lists;
+
+/**
+ * sides of an item along the main and the cross axis, fixed for the steps
+ * instantiated for one axis
+ */
+template <bool kHorizontal>
+struct FlexAxis {
+  static constexpr size_t kMainFront =
+      kHorizontal ? kCSSDirectionLeft : kCSSDirectionTop;
+  static constexpr size_t kMainAfter =
+      kHorizontal ? kCSSDirectionRight : kCSSDirectionBottom;
+  static constexpr size_t kCrossFront =
+      kHorizontal ? kCSSDirectionTop : kCSSDirectionLeft;
+  static constexpr size_t kCrossAfter =
+      kHorizontal ? kCSSDirectionBottom : kCSSDirectionRight;
+};
+
+/**
+ * items measured in one phase do not depend on each other. with a thread pool
+ * in scope, `measure` runs as a task for items with children, leaves cost less
+ * than handing them to another thread. the serial pass keeps a plain loop.
+ */
+template <typename Measure>
+void MeasureItems(ItemInfo* begin, ItemInfo* end, Measure measure) {
+  base::ThreadPool* thread_pool = base::ThreadPool::Current();
+  if (thread_pool == nullptr) {
+    for (ItemInfo* item_info = begin; item_info != end; ++item_info) {
+      measure(*item_info);
+    }
+    return;
+  }
+  base::TaskGroup items(thread_pool);
+  for (ItemInfo* item_info = begin; item_info != end; ++item_info) {
+    items.Run([&measure, item_info] { measure(*item_info); },
+              item_info->item_->first_child() != nullptr);
+  }
+  items.Wait();
+}
+
+/**
+ * Calculate the remaining free space as for initial free space, above. If the
+ * sum of the unfrozen flex items’ flex factors is less than one, multiply the
+ * initial free space by this sum. If the magnitude of this value is less than
+ * the magnitude of the remaining free space, use this as the remaining free
+ * space.
+ * returns how the remaining free space is shared out, `total_flex_factor` is
+ * what an item's factor is divided by
+ */
+FreeSpaceShare UpdateFreeSpaceShare(FlexLine& current_line,
+                                    float& total_flex_factor) {
+  bool should_apply_grow = current_line.should_apply_grow_;
+  float sum_flex_factors = should_apply_grow ? current_line.total_flex_grow_
+                                             : current_line.total_flex_shrink_;
+  if (sum_flex_factors > 0 && sum_flex_factors < 1) {
+    float fractional = current_line.initial_free_space_ * sum_flex_factors;
+    if (std::abs(fractional) < std::abs(current_line.remaining_free_space_))
+      current_line.remaining_free_space_ = fractional;
+  }
+
+  total_flex_factor = .0f;
+  if (current_line.remaining_free_space_ > 0 &&
+      current_line.total_flex_grow_ > 0 && should_apply_grow) {
+    total_flex_factor = current_line.total_flex_grow_;
+    return kFreeSpaceShareGrow;
+  }
+  if (current_line.remaining_free_space_ < 0 &&
+      current_line.total_weighted_flex_shrink_ > 0 && !should_apply_grow) {
+    total_flex_factor = current_line.total_weighted_flex_shrink_;
+    return kFreeSpaceShareShrink;
+  }
+  return kFreeSpaceShareNone;
+}
+
+/**
+ * adaptive lines switch to the sweep once the rounds spent would have paid
+ * for it. lines never take more than twice the time of the cheaper way, and
+ * O(n log n) at worst.
+ */
+size_t RoundsBeforeSweep(FlexResolution flex_resolution, size_t item_count) {
+  switch (flex_resolution) {
+    case kFlexResolutionLoop:
+      return std::numeric_limits<size_t>::max();
+    case kFlexResolutionSweep:
+      return 0;
+    case kFlexResolutionAdaptive:
+      break;
+  }
+  size_t sort_levels = 1;
+  while (sort_levels < 64 && (size_t(1) << sort_levels) < item_count) {
+    ++sort_levels;
+  }
+  return kFlexRoundsPerSortLevel * sort_levels;
+}
+
+}  // namespace
+
+FlexLayoutAlgorithm::FlexLayoutAlgorithm(LayoutNode* container)
     : LayoutAlgorithm(),
       container_(container),
-      container_style_(container_style),
       main_available_size_(.0f),
       cross_available_size_(.0f),
       main_axis_mode_(kLayoutModeExact),
@@ -22,13 +372,30 @@ FlexLayoutAlgorithm::FlexLayoutAlgorithm(LayoutNode* container,
       main_axis_front_(1),
       main_axis_after_(3),
       cross_axis_front_(0),
-      cross_axis_after_(2) {}
+      cross_axis_after_(2),
+      has_order_(false),
+      items_dirty_(false),
+      lines_reusable_(false),
+      lines_main_size_(.0f),
+      lines_single_line_(false),
+      lines_main_axis_front_(0),
+      first_moved_item_(std::numeric_limits<size_t>::max()),
+      new_lines_begin_(0),
+      new_lines_end_(0),
+      append_ready_(false),
+      append_constraints_(.0f, .0f, kLayoutModeUndefined, kLayoutModeUndefined),
+      measured_items_(0),
+      measured_main_size_(.0f),
+      appended_main_start_(.0f),
+      appended_items_begin_(0),
+      aligned_items_(0),
+      first_aligned_item_(nullptr) {}
 
 FlexLayoutAlgorithm::~FlexLayoutAlgorithm() {}
 
 void FlexLayoutAlgorithm::SolveDirction() {
   if (container_) {
-    main_axis_horizontal_ = container_style_->IsMainAxisHorizontal();
+    main_axis_horizontal_ = container_->css_style()->IsMainAxisHorizontal();
     main_axis_front_ = main_axis_horizontal_ ? 1 : 0;
     main_axis_after_ = main_axis_horizontal_ ? 3 : 2;
     cross_axis_front_ = main_axis_horizontal_ ? 0 : 1;
@@ -48,15 +415,15 @@ void FlexLayoutAlgorithm::ResolveSizeAndMode(float width,
     width = container_->ApplyWidthConstraints(width);
     content_width = width - container_padding[kCSSDirectionLeft] -
                     container_padding[kCSSDirectionRight] -
-                    container_style_->border_left() -
-                    container_style_->border_right();
+                    container_->css_style()->border_left() -
+                    container_->css_style()->border_right();
   }
   if (height_mode != kLayoutModeAtMost) {
     height = container_->ApplyHeightConstraints(height);
     content_height = height - container_padding[kCSSDirectionTop] -
                      container_padding[kCSSDirectionBottom] -
-                     container_style_->border_top() -
-                     container_style_->border_bottom();
+                     container_->css_style()->border_top() -
+                     container_->css_style()->border_bottom();
   }
 
   main_available_size_ = main_axis_horizontal_ ? content_width : content_height;
@@ -65,8 +432,9 @@ void FlexLayoutAlgorithm::ResolveSizeAndMode(float width,
   main_axis_mode_ = main_axis_horizontal_ ? width_mode : height_mode;
   cross_axis_mode_ = main_axis_horizontal_ ? height_mode : width_mode;
 
-  for (auto& item_info : item_info_) {
-    item_info.item_->UpdateLayoutInfo(content_width, content_height);
+  for (size_t index = appended_items_begin_; index < item_info_.size();
+       ++index) {
+    item_info_[index].item_->UpdateLayoutInfo(content_width, content_height);
   }
 }
 
@@ -81,9 +449,120 @@ void FlexLayoutAlgorithm::Initialize(float width,
                                      LayoutMode height_mode) {
   // determine layout mode and available space
   SolveDirction();
+  CollectItems();
+  appended_items_begin_ = 0;
+  append_constraints_ =
+      LayoutConstraints(width, height, width_mode, height_mode);
+  ResolveSizeAndMode(width, height, width_mode, height_mode);
+}
+
+/**
+ * update container's layout mode and available space. if the container has
+ * only been appended to since a pass with the same constraints, and neither
+ * the container nor the appended items move the others, only the appended
+ * items are measured
+ */
+void FlexLayoutAlgorithm::Update(float width,
+                                 float height,
+                                 LayoutMode width_mode,
+                                 LayoutMode height_mode) {
+  // determine layout mode and available space
+  SolveDirction();
+  if (items_dirty_) {
+    CollectItems();
+  }
+  LayoutConstraints constraints(width, height, width_mode, height_mode);
+  appended_items_begin_ = 0;
+  if (append_ready_ && container_->children_appended_only() &&
+      constraints == append_constraints_) {
+    appended_items_begin_ = measured_items_;
+    for (size_t index = measured_items_; index < item_info_.size(); ++index) {
+      if (!AppendKeepsLayout(item_info_[index])) {
+        appended_items_begin_ = 0;
+        break;
+      }
+    }
+  }
+  append_constraints_ = constraints;
+  ResolveSizeAndMode(width, height, width_mode, height_mode);
+}
+
+/**
+ * patch item lists in place for a child inserted after initialization. lists
+ * are rebuilt on next update instead if `order` is in play, or the child is
+ * hidden and has to be laid out with `display: none`
+ */
+void FlexLayoutAlgorithm::OnChildInserted(LayoutNode* child) {
+  if (items_dirty_) {
+    return;
+  }
+  const CSSStyle* child_style = child->css_style();
+  if (child_style->display() == kDisplayNone) {
+    items_dirty_ = true;
+    return;
+  }
+  if (child_style->position() != kPositionRelative) {
+    absolute_items.push_back(child);
+    return;
+  }
+  if (has_order_ || child_style->order() != 0) {
+    items_dirty_ = true;
+    return;
+  }
+
+  // without `order`, items keep tree order: insert right after the closest
+  // previous sibling which is a flex item. appended children find it at the
+  // back of the list.
+  auto insert_position = item_info_.begin();
+  for (LayoutNode* prev = child->prev(); prev != nullptr; prev = prev->prev()) {
+    auto found = std::find_if(
+        item_info_.rbegin(), item_info_.rend(),
+        [prev](const ItemInfo& item_info) { return item_info.item_ == prev; });
+    if (found != item_info_.rend()) {
+      insert_position = found.base();
+      break;
+    }
+  }
+  first_moved_item_ = std::min(
+      first_moved_item_,
+      static_cast<size_t>(insert_position - item_info_.begin()));
+  item_info_.insert(insert_position, ItemInfo(child));
+}
+
+void FlexLayoutAlgorithm::OnChildRemoved(LayoutNode* child) {
+  if (items_dirty_) {
+    return;
+  }
+  auto found = std::find_if(
+      item_info_.rbegin(), item_info_.rend(),
+      [child](const ItemInfo& item_info) { return item_info.item_ == child; });
+  if (found != item_info_.rend()) {
+    auto position = std::next(found).base();
+    first_moved_item_ = std::min(
+        first_moved_item_, static_cast<size_t>(position - item_info_.begin()));
+    item_info_.erase(position);
+    append_ready_ = false;
+    return;
+  }
+  auto found_absolute =
+      std::find(absolute_items.begin(), absolute_items.end(), child);
+  if (found_absolute != absolute_items.end()) {
+    absolute_items.erase(found_absolute);
+  }
+}
+
+/**
+ * traverse children to classify them, sort flex items by `order`
+ */
+void FlexLayoutAlgorithm::CollectItems() {
+  item_info_.clear();
+  item_info_.reserve(container_->child_count());
+  absolute_items.clear();
+  has_order_ = false;
+  items_dirty_ = false;
+  lines_reusable_ = false;
+  append_ready_ = false;
 
-  bool need_order = false;
-  // traverse child to classify them
   LayoutNode* child = container_->first_child();
   while (child) {
     const CSSStyle* child_style = child->css_style();
@@ -95,7 +574,7 @@ void FlexLayoutAlgorithm::Initialize(float width,
       PositionType child_position = child_style->position();
       if (child_position == kPositionRelative) {
         if (child_style->order() != 0) {
-          need_order = true;
+          has_order_ = true;
         }
         item_info_.push_back(ItemInfo(child));
       } else {
@@ -106,7 +585,7 @@ void FlexLayoutAlgorithm::Initialize(float width,
   }
 
   // if order is set, need sort. use stable_sort to prevent messing items
-  if (need_order) {
+  if (has_order_) {
     std::stable_sort(
         item_info_.begin(), item_info_.end(),
         [](const ItemInfo& item_a, const ItemInfo& item_b) -> bool {
@@ -114,149 +593,305 @@ void FlexLayoutAlgorithm::Initialize(float width,
                  item_b.item_->css_style()->order();
         });
   }
-
-  ResolveSizeAndMode(width, height, width_mode, height_mode);
 }
 
 /**
- * update container's layout mode and available space
+ * the steps are instantiated per main axis, the direction is looked at once
+ * per pass instead of for every item
  */
-void FlexLayoutAlgorithm::Update(float width,
-                                 float height,
-                                 LayoutMode width_mode,
-                                 LayoutMode height_mode) {
-  // determine layout mode and available space
-  ResolveSizeAndMode(width, height, width_mode, height_mode);
+void FlexLayoutAlgorithm::Measure() {
+  if (main_axis_horizontal_) {
+    Measure<true>();
+  } else {
+    Measure<false>();
+  }
 }
 
+template <bool kHorizontal>
 void FlexLayoutAlgorithm::Measure() {
-  CalculateFlexBasis();
-  DetermineContainerMainSize();
-  CollectIntoFlexlines();
-  ResolveFlexlines();
+  if (appended_items_begin_ > 0) {
+    MeasureAppendedItems<kHorizontal>();
+    return;
+  }
+  CalculateFlexBasis<kHorizontal>();
+  DetermineContainerMainSize<kHorizontal>();
+  CollectIntoFlexlines<kHorizontal>();
+  ResolveFlexlines<kHorizontal>();
 
-  DetermineHypotheticalCrossSize();
-  CalculateFlexlineCrossSize();
+  DetermineHypotheticalCrossSize<kHorizontal>();
+  CalculateFlexlineCrossSize<kHorizontal>();
   ExpandFlexlineCrossSizeDueToAlignContentStretch();
-  DetermineFlexItemUsedCrossSize();
-  DetermineContainerUsedCrossSize();
+  DetermineFlexItemUsedCrossSize<kHorizontal>();
+  DetermineContainerUsedCrossSize<kHorizontal>();
+  UpdateContainerSize<kHorizontal>();
 
+  append_ready_ = AppendKeepsLayout();
+  for (size_t index = 0; append_ready_ && index < item_info_.size(); ++index) {
+    append_ready_ = AppendKeepsLayout(item_info_[index]);
+  }
+  measured_items_ = item_info_.size();
+  measured_main_size_ = main_available_size_;
+  aligned_items_ = 0;
+}
+
+template <bool kHorizontal>
+void FlexLayoutAlgorithm::UpdateContainerSize() {
   float offset_border_box_width =
-      (main_axis_horizontal_ ? main_available_size_ : cross_available_size_) +
+      (kHorizontal ? main_available_size_ : cross_available_size_) +
       container_->layout_info().padding_[kCSSDirectionLeft] +
       container_->layout_info().padding_[kCSSDirectionRight] +
-      container_style_->border_left() + container_style_->border_right();
+      container_->css_style()->border_left() +
+      container_->css_style()->border_right();
   float offset_border_boxheight =
-      (main_axis_horizontal_ ? cross_available_size_ : main_available_size_) +
+      (kHorizontal ? cross_available_size_ : main_available_size_) +
       container_->layout_info().padding_[kCSSDirectionTop] +
       container_->layout_info().padding_[kCSSDirectionBottom] +
-      container_style_->border_top() + container_style_->border_bottom();
+      container_->css_style()->border_top() +
+      container_->css_style()->border_bottom();
 
   container_->SetOffsetWidth(offset_border_box_width);
   container_->SetOffsetHeight(offset_border_boxheight);
 }
 
+/**
+ * a single line column with a definite width and an undefined height, which
+ * starts its items at the top. each item lines up across the width on its own
+ */
+bool FlexLayoutAlgorithm::AppendKeepsLayout() const {
+  const CSSStyle* container_style = container_->css_style();
+  return container_style->flex_direction() == kFlexDirectionColumn &&
+         container_style->flex_wrap() == kFlexWrapNoWrap &&
+         container_style->justify_content() == kJustifyContentFlexStart &&
+         main_axis_mode_ == kLayoutModeUndefined &&
+         cross_axis_mode_ == kLayoutModeExact && flex_lines_.size() == 1;
+}
+
+/**
+ * the item takes its hypothetical height and neither shares free space with
+ * the others nor resolves anything against the column's height
+ */
+bool FlexLayoutAlgorithm::AppendKeepsLayout(const ItemInfo& item_info) const {
+  const CSSStyle* item_style = item_info.item_->css_style();
+  return item_style->flex_grow() == .0f && !item_style->margin_top().IsAuto() &&
+         !item_style->margin_bottom().IsAuto() &&
+         !item_style->min_height().IsPercentage() &&
+         !item_style->max_height().IsPercentage();
+}
+
+/**
+ * the steps of Measure for appended items only. the line and the column
+ * height grow by their outer hypothetical heights, summed in the same order.
+ * with all free space used up and no flex grow, every item keeps its
+ * hypothetical height.
+ */
+template <bool kHorizontal>
+void FlexLayoutAlgorithm::MeasureAppendedItems() {
+  typedef FlexAxis<kHorizontal> Axis;
+  ItemInfo* begin = item_info_.data() + appended_items_begin_;
+  ItemInfo* end = item_info_.data() + item_info_.size();
+  MeasureItems(begin, end, [this](ItemInfo& item_info) {
+    CalculateFlexBasis<kHorizontal>(item_info);
+  });
+
+  FlexLine& flexline = flex_lines_[0];
+  main_available_size_ = measured_main_size_;
+  for (ItemInfo* item_info = begin; item_info != end; ++item_info) {
+    const LayoutInfo& layout_info = item_info->item_->layout_info();
+    main_available_size_ += item_info->hypothetical_main_size_ +
+                            layout_info.margin_[Axis::kMainFront] +
+                            layout_info.margin_[Axis::kMainAfter];
+  }
+  for (ItemInfo* item_info = begin; item_info != end; ++item_info) {
+    LayoutNode* item = item_info->item_;
+    const CSSStyle* item_style = item->css_style();
+    item->UpdateLayoutInfo(cross_available_size_, main_available_size_);
+    const LayoutInfo& layout_info = item->layout_info();
+    flexline.sum_flex_basie_size_ += item_info->flex_base_size_ +
+                                     layout_info.margin_[Axis::kMainFront] +
+                                     layout_info.margin_[Axis::kMainAfter];
+    flexline.total_flex_grow_ += item_style->flex_grow();
+    flexline.total_flex_shrink_ += item_style->flex_shrink();
+    flexline.total_weighted_flex_shrink_ +=
+        item_style->flex_shrink() * item_info->flex_base_size_;
+    flexline.sum_hypothetical_main_size_ +=
+        item_info->hypothetical_main_size_ +
+        layout_info.margin_[Axis::kMainFront] +
+        layout_info.margin_[Axis::kMainAfter];
+    item_info->used_main_size_ = item_info->hypothetical_main_size_;
+    item_info->line_inputs_ = LineInputs<kHorizontal>(*item_info);
+  }
+  flexline.end_ = item_info_.size();
+  flexline.initial_free_space_ =
+      main_available_size_ - flexline.sum_flex_basie_size_;
+  flexline.should_apply_grow_ =
+      flexline.sum_hypothetical_main_size_ <= main_available_size_;
+  if (lines_reusable_) {
+    lines_main_size_ = main_available_size_;
+  }
+  first_moved_item_ = std::numeric_limits<size_t>::max();
+
+  MeasureItems(begin, end, [this](ItemInfo& item_info) {
+    DetermineHypotheticalCrossSize<kHorizontal>(item_info);
+  });
+  MeasureItems(begin, end, [this, &flexline](ItemInfo& item_info) {
+    DetermineFlexItemUsedCrossSize<kHorizontal>(flexline, item_info);
+  });
+  UpdateContainerSize<kHorizontal>();
+
+  measured_items_ = item_info_.size();
+  measured_main_size_ = main_available_size_;
+}
+
+/**
+ * after appended items were measured alone, the items before keep the place
+ * of the last alignment. like Measure, alignment is instantiated per axis,
+ * and per reversed direction and wrap.
+ */
 void FlexLayoutAlgorithm::Alignment() {
-  MainAxisAlignment();
-  CrossAxisAlignment();
+  size_t first_item =
+      appended_items_begin_ == aligned_items_ ? appended_items_begin_ : 0;
+  appended_items_begin_ = 0;
+  ResetAutoMargins(first_item);
+  if (main_axis_horizontal_) {
+    Alignment<true>(first_item);
+  } else {
+    Alignment<false>(first_item);
+  }
+  LayoutAbsoluteItems(container_, absolute_items);
+  aligned_items_ = item_info_.size();
+  // out-of-flow children may be sized again by the container's new size
+  first_aligned_item_ =
+      first_item > 0 && first_item < item_info_.size() &&
+              absolute_items.empty()
+          ? item_info_[first_item].item_
+          : nullptr;
+}
+
+template <bool kHorizontal>
+void FlexLayoutAlgorithm::Alignment(size_t first_item) {
+  const CSSStyle* container_style = container_->css_style();
+  if (container_style->IsMainAxisReverse()) {
+    MainAxisAlignment<kHorizontal, true>(first_item);
+  } else {
+    MainAxisAlignment<kHorizontal, false>(first_item);
+  }
+  if (container_style->flex_wrap() == kFlexWrapWrapReverse) {
+    CrossAxisAlignment<kHorizontal, true>(first_item);
+  } else {
+    CrossAxisAlignment<kHorizontal, false>(first_item);
+  }
 }
 
+LayoutNode* FlexLayoutAlgorithm::FirstChangedChild() const {
+  return first_aligned_item_;
+}
+
+template <bool kHorizontal>
 void FlexLayoutAlgorithm::CalculateFlexBasis() {
-  for (auto& item_info : item_info_) {
-    LayoutNode* item = item_info.item_;
-    const CSSStyle* item_style = item->css_style();
+  MeasureItems(item_info_.data(), item_info_.data() + item_info_.size(),
+               [this](ItemInfo& item_info) {
+                 CalculateFlexBasis<kHorizontal>(item_info);
+               });
+}
 
-    // determine the flex base size
-    const Length& flex_basis = item_style->flex_basis();
-    switch (flex_basis.type()) {
-      // If the item has a definite used flex basis, that’s the flex base size.
-      case base::kLengthFixed: {
-        item_info.flex_base_size_ = flex_basis.value();
-        break;
-      }
-      case base::kLengthPercentage: {
-        item_info.flex_base_size_ =
-            main_axis_mode_ == kLayoutModeUndefined
-                ? .0f
-                : flex_basis.GetComputedValue(main_available_size_);
-        break;
-      }
-      case base::kLengthAuto: {
-        const Length& item_main_axis_size =
-            main_axis_horizontal_ ? item_style->width() : item_style->height();
-        // std::cout << "mainaxissize:" << item << " "
-        //           << item_main_axis_size.type() << " "
-        //           << item_main_axis_size.value() << std::endl;
-        switch (item_main_axis_size.type()) {
-          case base::kLengthFixed: {
-            item_info.flex_base_size_ = item_main_axis_size.value();
-            break;
-          }
-          case base::kLengthPercentage: {
-            item_info.flex_base_size_ =
-                main_axis_mode_ == kLayoutModeUndefined
-                    ? .0f
-                    : item_main_axis_size.GetComputedValue(
-                          main_available_size_);
-            break;
-          }
-          case base::kLengthAuto: {
-            float item_layout_width = .0f;
-            float item_layout_height = .0f;
-            LayoutMode item_layout_width_mode = kLayoutModeUndefined;
-            LayoutMode item_layout_height_mode = kLayoutModeUndefined;
-
-            AlignItemsType align_type =
-                item_style->align_self() == kAlignSelfAuto
-                    ? (container_style_->align_items())
-                    : AlignItemsType(item_style->align_self());
-            if (align_type == kAlignItemsStretch) {
-              float& cross_size = main_axis_horizontal_ ? item_layout_height
-                                                        : item_layout_width;
-              LayoutMode& cross_mode = main_axis_horizontal_
-                                           ? item_layout_height_mode
-                                           : item_layout_width_mode;
-              cross_size = cross_available_size_;
-              cross_mode = kLayoutModeExact;
-            }
-
-            FloatSize layout_result = item->UpdateMeasure(
-                item_layout_width, item_layout_height, item_layout_width_mode,
-                item_layout_height_mode);
-
-            // std::cout << "CalculateFlexBasis:width:" << item << " "
-            //           << item_layout_width << " height:" <<
-            //           item_layout_height
-            //           << " widthmode:" << item_layout_width_mode
-            //           << " heightmode:" << item_layout_height_mode
-            //           << " resultwidth:" << layout_result.width_
-            //           << " resultheight:" << layout_result.height_ <<
-            //           std::endl;
-            item_info.flex_base_size_ = main_axis_horizontal_
-                                            ? layout_result.width_
-                                            : layout_result.height_;
-            break;
+template <bool kHorizontal>
+void FlexLayoutAlgorithm::CalculateFlexBasis(ItemInfo& item_info) {
+  LayoutNode* item = item_info.item_;
+  const CSSStyle* item_style = item->css_style();
+  // items are frozen again while resolving flexible lengths of this pass
+  item_info.frozen_ = false;
+
+  // determine the flex base size
+  const Length& flex_basis = item_style->flex_basis();
+  switch (flex_basis.type()) {
+    // If the item has a definite used flex basis, that’s the flex base size.
+    case base::kLengthFixed: {
+      item_info.flex_base_size_ = flex_basis.value();
+      break;
+    }
+    case base::kLengthPercentage: {
+      item_info.flex_base_size_ =
+          main_axis_mode_ == kLayoutModeUndefined
+              ? .0f
+              : flex_basis.GetComputedValue(main_available_size_);
+      break;
+    }
+    case base::kLengthAuto: {
+      const Length& item_main_axis_size =
+          kHorizontal ? item_style->width() : item_style->height();
+      // std::cout << "mainaxissize:" << item << " "
+      //           << item_main_axis_size.type() << " "
+      //           << item_main_axis_size.value() << std::endl;
+      switch (item_main_axis_size.type()) {
+        case base::kLengthFixed: {
+          item_info.flex_base_size_ = item_main_axis_size.value();
+          break;
+        }
+        case base::kLengthPercentage: {
+          item_info.flex_base_size_ =
+              main_axis_mode_ == kLayoutModeUndefined
+                  ? .0f
+                  : item_main_axis_size.GetComputedValue(
+                        main_available_size_);
+          break;
+        }
+        case base::kLengthAuto: {
+          float item_layout_width = .0f;
+          float item_layout_height = .0f;
+          LayoutMode item_layout_width_mode = kLayoutModeUndefined;
+          LayoutMode item_layout_height_mode = kLayoutModeUndefined;
+
+          AlignItemsType align_type =
+              item_style->align_self() == kAlignSelfAuto
+                  ? (container_->css_style()->align_items())
+                  : AlignItemsType(item_style->align_self());
+          // stretch only applies against a definite cross size
+          if (align_type == kAlignItemsStretch &&
+              cross_axis_mode_ != kLayoutModeUndefined) {
+            float& cross_size =
+                kHorizontal ? item_layout_height : item_layout_width;
+            LayoutMode& cross_mode =
+                kHorizontal ? item_layout_height_mode : item_layout_width_mode;
+            cross_size = cross_available_size_;
+            cross_mode = kLayoutModeExact;
           }
+
+          FloatSize layout_result = item->UpdateMeasure(
+              item_layout_width, item_layout_height, item_layout_width_mode,
+              item_layout_height_mode);
+
+          // std::cout << "CalculateFlexBasis:width:" << item << " "
+          //           << item_layout_width << " height:" <<
+          //           item_layout_height
+          //           << " widthmode:" << item_layout_width_mode
+          //           << " heightmode:" << item_layout_height_mode
+          //           << " resultwidth:" << layout_result.width_
+          //           << " resultheight:" << layout_result.height_ <<
+          //           std::endl;
+          item_info.flex_base_size_ =
+              kHorizontal ? layout_result.width_ : layout_result.height_;
+          break;
         }
-        break;
       }
+      break;
     }
-
-    // determine hypothetical main size:item’s flex base size clamped according
-    // to its used min and max main sizes (and flooring the content box size at
-    // zero).
-    item_info.hypothetical_main_size_ =
-        main_axis_horizontal_
-            ? item->ApplyWidthConstraints(item_info.flex_base_size_)
-            : item->ApplyHeightConstraints(item_info.flex_base_size_);
-    // std::cout << "flex_base_size_:" << item_info.flex_base_size_ << " "
-    //           << "hypothetical_main_size_:" <<
-    //           item_info.hypothetical_main_size_
-    //           << std::endl;
   }
+
+  // determine hypothetical main size:item’s flex base size clamped according
+  // to its used min and max main sizes (and flooring the content box size at
+  // zero).
+  item_info.hypothetical_main_size_ =
+      kHorizontal ? item->ApplyWidthConstraints(item_info.flex_base_size_)
+                  : item->ApplyHeightConstraints(item_info.flex_base_size_);
+  // std::cout << "flex_base_size_:" << item_info.flex_base_size_ << " "
+  //           << "hypothetical_main_size_:" <<
+  //           item_info.hypothetical_main_size_
+  //           << std::endl;
 }
 
+template <bool kHorizontal>
 void FlexLayoutAlgorithm::DetermineContainerMainSize() {
+  typedef FlexAxis<kHorizontal> Axis;
   if (main_axis_mode_ == kLayoutModeExact) {
     return;  // do nothing
   }
@@ -265,8 +900,8 @@ void FlexLayoutAlgorithm::DetermineContainerMainSize() {
   for (auto& item_info : item_info_) {
     LayoutNode* item = item_info.item_;
     main_size_sum += item_info.hypothetical_main_size_ +
-                     item->layout_info().margin_[main_axis_front_] +
-                     item->layout_info().margin_[main_axis_after_];
+                     item->layout_info().margin_[Axis::kMainFront] +
+                     item->layout_info().margin_[Axis::kMainAfter];
   }
   if (main_axis_mode_ == kLayoutModeUndefined) {
     main_available_size_ = main_size_sum;
@@ -276,21 +911,118 @@ void FlexLayoutAlgorithm::DetermineContainerMainSize() {
 
   for (auto& item_info : item_info_) {
     item_info.item_->UpdateLayoutInfo(
-        main_axis_horizontal_ ? main_available_size_ : cross_available_size_,
-        main_axis_horizontal_ ? cross_available_size_ : main_available_size_);
+        kHorizontal ? main_available_size_ : cross_available_size_,
+        kHorizontal ? cross_available_size_ : main_available_size_);
   }
 }
 
+template <bool kHorizontal>
+ItemLineInputs FlexLayoutAlgorithm::LineInputs(
+    const ItemInfo& item_info) const {
+  typedef FlexAxis<kHorizontal> Axis;
+  LayoutNode* item = item_info.item_;
+  const LayoutInfo& layout_info = item->layout_info();
+  ItemLineInputs inputs;
+  inputs.flex_grow_ = item->css_style()->flex_grow();
+  inputs.flex_shrink_ = item->css_style()->flex_shrink();
+  inputs.flex_base_size_ = item_info.flex_base_size_;
+  inputs.hypothetical_main_size_ = item_info.hypothetical_main_size_;
+  inputs.margin_front_ = layout_info.margin_[Axis::kMainFront];
+  inputs.margin_after_ = layout_info.margin_[Axis::kMainAfter];
+  inputs.min_size_ =
+      kHorizontal ? layout_info.min_width_ : layout_info.min_height_;
+  inputs.max_size_ =
+      kHorizontal ? layout_info.max_width_ : layout_info.max_height_;
+  inputs.min_border_box_size_ =
+      kHorizontal ? item->MinBorderBoxWidth() : item->MinBorderBoxHeight();
+  return inputs;
+}
+
+/**
+ * lines of the last pass are kept up to the one holding the first item whose
+ * line inputs changed, they keep their items and resolved sizes. the line
+ * before is broken again as well if the changed item starts the next line,
+ * it might fit now. lines are broken one after another as before, sums of
+ * sizes add up in the same order and break at the same items. once a new line
+ * ends where a line of the last pass did, past the last changed item, the
+ * remaining lines are kept too, unless items were inserted or removed.
+ */
+template <bool kHorizontal>
 void FlexLayoutAlgorithm::CollectIntoFlexlines() {
-  size_t next_index = 0;
-  flex_lines_.clear();
-  while (CollectIntoSignleFlexline(next_index)) {
-    continue;
+  typedef FlexAxis<kHorizontal> Axis;
+  bool is_single_line = container_->css_style()->flex_wrap() == kFlexWrapNoWrap;
+  size_t item_count = item_info_.size();
+  // lines are broken again from the first changed item, items from the end
+  // of the changes on are unchanged
+  size_t first_changed = 0;
+  size_t changes_end = item_count;
+  // all lines are kept. told apart from changes ending at 0, which removed
+  // the last items
+  bool lines_unchanged = false;
+  bool items_moved = first_moved_item_ != std::numeric_limits<size_t>::max();
+  if (lines_reusable_ && lines_main_size_ == main_available_size_ &&
+      lines_single_line_ == is_single_line &&
+      lines_main_axis_front_ == Axis::kMainFront) {
+    first_changed = std::min(first_moved_item_, item_count);
+    changes_end = items_moved ? item_count : 0;
+    lines_unchanged = !items_moved;
+    for (size_t index = 0; index < item_count; ++index) {
+      if (item_info_[index].line_inputs_ !=
+          LineInputs<kHorizontal>(item_info_[index])) {
+        first_changed = std::min(first_changed, index);
+        changes_end = std::max(changes_end, index + 1);
+        lines_unchanged = false;
+      }
+    }
+  }
+  lines_reusable_ = true;
+  lines_main_size_ = main_available_size_;
+  lines_single_line_ = is_single_line;
+  lines_main_axis_front_ = Axis::kMainFront;
+  first_moved_item_ = std::numeric_limits<size_t>::max();
+
+  size_t kept_lines = 0;
+  if (lines_unchanged) {
+    kept_lines = flex_lines_.size();
+  } else {
+    while (kept_lines < flex_lines_.size() &&
+           flex_lines_[kept_lines].end_ < first_changed) {
+      ++kept_lines;
+    }
+  }
+  std::vector<FlexLine>& previous_lines = scratch_lists.previous_lines_;
+  previous_lines.clear();
+  previous_lines.insert(previous_lines.end(), flex_lines_.begin() + kept_lines,
+                        flex_lines_.end());
+  flex_lines_.erase(flex_lines_.begin() + kept_lines, flex_lines_.end());
+  new_lines_begin_ = kept_lines;
+
+  size_t next_index = kept_lines > 0 ? flex_lines_.back().end_ : 0;
+  size_t previous_line = 0;
+  while (CollectIntoSignleFlexline<kHorizontal>(next_index)) {
+    if (next_index < changes_end || next_index == item_count) {
+      continue;
+    }
+    while (previous_line < previous_lines.size() &&
+           previous_lines[previous_line].start_ < next_index) {
+      ++previous_line;
+    }
+    if (previous_line < previous_lines.size() &&
+        previous_lines[previous_line].start_ == next_index) {
+      new_lines_end_ = flex_lines_.size();
+      flex_lines_.insert(flex_lines_.end(),
+                         previous_lines.begin() + previous_line,
+                         previous_lines.end());
+      return;
+    }
   }
+  new_lines_end_ = flex_lines_.size();
 }
 
+template <bool kHorizontal>
 bool FlexLayoutAlgorithm::CollectIntoSignleFlexline(size_t& next_index) {
-  bool is_single_line = container_style_->flex_wrap() == kFlexWrapNoWrap;
+  typedef FlexAxis<kHorizontal> Axis;
+  bool is_single_line = container_->css_style()->flex_wrap() == kFlexWrapNoWrap;
   float asum_flex_basis_size = .0f;
   float total_flex_grow = .0f;
   float total_flex_shrink = .0f;
@@ -312,8 +1044,8 @@ bool FlexLayoutAlgorithm::CollectIntoSignleFlexline(size_t& next_index) {
     // fit, collect just it into the line.
     float item_outer_hypothetical_main_size =
         item_info.hypothetical_main_size_ +
-        item->layout_info().margin_[main_axis_front_] +
-        item->layout_info().margin_[main_axis_after_];
+        item->layout_info().margin_[Axis::kMainFront] +
+        item->layout_info().margin_[Axis::kMainAfter];
     if ((!is_single_line &&
          sum_hypothetical_main_size + item_outer_hypothetical_main_size >
              main_available_size_ &&
@@ -322,8 +1054,8 @@ bool FlexLayoutAlgorithm::CollectIntoSignleFlexline(size_t& next_index) {
     }
     line_has_item = true;
     asum_flex_basis_size += item_info.flex_base_size_ +
-                            item->layout_info().margin_[main_axis_front_] +
-                            item->layout_info().margin_[main_axis_after_];
+                            item->layout_info().margin_[Axis::kMainFront] +
+                            item->layout_info().margin_[Axis::kMainAfter];
     total_flex_grow += item_style->flex_grow();
     total_flex_shrink += item_style->flex_shrink();
     total_weighted_flex_shrink +=
@@ -345,31 +1077,170 @@ bool FlexLayoutAlgorithm::CollectIntoSignleFlexline(size_t& next_index) {
   return false;
 }
 
+template <bool kHorizontal>
 void FlexLayoutAlgorithm::ResolveFlexlines() {
-  for (size_t line_index = 0; line_index < flex_lines_.size(); ++line_index) {
-    ResolveSingleFlexline(flex_lines_[line_index]);
+  for (size_t line_index = new_lines_begin_; line_index < new_lines_end_;
+       ++line_index) {
+    FlexLine& current_line = flex_lines_[line_index];
+    ResolveSingleFlexline<kHorizontal>(current_line);
+    for (size_t index = current_line.start_; index < current_line.end_;
+         ++index) {
+      item_info_[index].line_inputs_ =
+          LineInputs<kHorizontal>(item_info_[index]);
+    }
   }
 }
 
+/**
+ * the line is resolved on arrays of the item values it needs, results are
+ * written back to the items once it is done. each round of the spec loop
+ * visits every item, lines which keep freezing items switch to the ordered
+ * sweep for the remaining rounds.
+ */
+template <bool kHorizontal>
 void FlexLayoutAlgorithm::ResolveSingleFlexline(FlexLine& current_line) {
-  FreezeInflexibleItems(current_line);
-  while (ResolveFlexibleLengths(current_line)) {
-    continue;
+  if (container_->layout_context()->flex_fast_paths() &&
+      ResolveTrivialFlexline<kHorizontal>(current_line)) {
+    return;
+  }
+  FlexLineArrays& arrays = scratch_lists.flex_line_;
+  FreezeInflexibleItems<kHorizontal>(current_line, arrays);
+  size_t rounds_before_sweep = RoundsBeforeSweep(
+      container_->layout_context()->flex_resolution(), arrays.count_);
+  if (rounds_before_sweep == 0) {
+    FreezeViolationsInOrder(current_line, arrays);
+  }
+  size_t rounds = 0;
+  while (ResolveFlexibleLengths(current_line, arrays)) {
+    if (++rounds == rounds_before_sweep) {
+      FreezeViolationsInOrder(current_line, arrays);
+    }
+  }
+  for (size_t index = 0; index < arrays.count_; ++index) {
+    ItemInfo& item_info = item_info_[current_line.start_ + index];
+    item_info.used_main_size_ = arrays.used_size_[index];
+    item_info.frozen_ = arrays.frozen_[index] != 0;
   }
 }
 
+/**
+ * closed forms of the spec loop for trivial lines, false leaves the line to
+ * it. items frozen as inflexible right away keep their hypothetical main
+ * size: once all of them are, no round changes anything. a single flexible
+ * item takes its share of the free space in one round, clamped, with the
+ * arithmetic of the loop and ResolveFlexItemSizes. what the loop takes off
+ * the line's sums while freezing is skipped, no later step reads it.
+ */
+template <bool kHorizontal>
+bool FlexLayoutAlgorithm::ResolveTrivialFlexline(FlexLine& current_line) {
+  bool should_apply_grow = current_line.should_apply_grow_;
+  size_t flexible_count = 0;
+  for (size_t index = current_line.start_; index < current_line.end_;
+       ++index) {
+    const ItemInfo& item_info = item_info_[index];
+    const CSSStyle* item_style = item_info.item_->css_style();
+    float flex_factor = should_apply_grow ? item_style->flex_grow()
+                                          : item_style->flex_shrink();
+    // the test of FreezeInflexibleItems
+    if (flex_factor != .0f &&
+        !(should_apply_grow &&
+          item_info.flex_base_size_ > item_info.hypothetical_main_size_) &&
+        !(!should_apply_grow &&
+          item_info.flex_base_size_ < item_info.hypothetical_main_size_)) {
+      ++flexible_count;
+    }
+  }
+
+  if (flexible_count == 0) {
+    for (size_t index = current_line.start_; index < current_line.end_;
+         ++index) {
+      ItemInfo& item_info = item_info_[index];
+      item_info.used_main_size_ = item_info.hypothetical_main_size_;
+      item_info.frozen_ = true;
+    }
+    return true;
+  }
+  // the sweep freezes items at thresholds computed apart from the loop
+  if (current_line.end_ - current_line.start_ > 1 ||
+      container_->layout_context()->flex_resolution() ==
+          kFlexResolutionSweep) {
+    return false;
+  }
+
+  ItemInfo& item_info = item_info_[current_line.start_];
+  LayoutNode* item = item_info.item_;
+  const CSSStyle* item_style = item->css_style();
+  const LayoutInfo& item_layout_info = item->layout_info();
+  float flex_base_size = item_info.flex_base_size_;
+  // nothing frozen yet, the remaining free space is the initial one
+  float free_space = current_line.remaining_free_space_;
+  float sum_flex_factors = should_apply_grow ? current_line.total_flex_grow_
+                                             : current_line.total_flex_shrink_;
+  if (sum_flex_factors > 0 && sum_flex_factors < 1) {
+    float fractional = free_space * sum_flex_factors;
+    if (std::abs(fractional) < std::abs(free_space)) {
+      free_space = fractional;
+    }
+  }
+  float extra_space = .0f;
+  if (free_space > 0 && current_line.total_flex_grow_ > 0 &&
+      should_apply_grow) {
+    extra_space =
+        free_space * item_style->flex_grow() / current_line.total_flex_grow_;
+  } else if (free_space < 0 && current_line.total_weighted_flex_shrink_ > 0 &&
+             !should_apply_grow) {
+    extra_space = free_space * item_style->flex_shrink() * flex_base_size /
+                  current_line.total_weighted_flex_shrink_;
+  }
+  float target_size = flex_base_size + extra_space;
+
+  float min_size =
+      kHorizontal ? item_layout_info.min_width_ : item_layout_info.min_height_;
+  float max_size =
+      kHorizontal ? item_layout_info.max_width_ : item_layout_info.max_height_;
+  float min_border_box_size =
+      kHorizontal ? item->MinBorderBoxWidth() : item->MinBorderBoxHeight();
+  float used_size = min_size > target_size ? min_size : target_size;
+  used_size = max_size < used_size ? max_size : used_size;
+  used_size = min_border_box_size > used_size ? min_border_box_size : used_size;
+  item_info.used_main_size_ = used_size;
+  // a violation freezes the item, without one the loop ends with it unfrozen
+  item_info.frozen_ = used_size != target_size;
+  return true;
+}
+
 /**
  * resolving Flexible Lengths - step 2
  * reference: https://www.w3.org/TR/css-flexbox-1/#resolve-flexible-lengths
  * size inflexible items. Freeze, setting its target main size to its
  * hypothetical main size
  */
-void FlexLayoutAlgorithm::FreezeInflexibleItems(FlexLine& current_line) {
-  std::vector<ItemInfo*> inflexible_item_infos;
-  for (size_t line_item_index = current_line.start_;
-       line_item_index < current_line.end_; ++line_item_index) {
-    ItemInfo& item_info = item_info_[line_item_index];
-    const CSSStyle* item_style = item_info.item_->css_style();
+template <bool kHorizontal>
+void FlexLayoutAlgorithm::FreezeInflexibleItems(FlexLine& current_line,
+                                                FlexLineArrays& arrays) {
+  std::vector<size_t>& inflexible_item_indices =
+      scratch_lists.inflexible_items_;
+  inflexible_item_indices.clear();
+  arrays.Reset(current_line.end_ - current_line.start_);
+  for (size_t index = 0; index < arrays.count_; ++index) {
+    const ItemInfo& item_info = item_info_[current_line.start_ + index];
+    LayoutNode* item = item_info.item_;
+    const CSSStyle* item_style = item->css_style();
+    const LayoutInfo& item_layout_info = item->layout_info();
+    arrays.flex_base_size_[index] = item_info.flex_base_size_;
+    arrays.flex_grow_[index] = item_style->flex_grow();
+    arrays.flex_shrink_[index] = item_style->flex_shrink();
+    if (kHorizontal) {
+      arrays.min_size_[index] = item_layout_info.min_width_;
+      arrays.max_size_[index] = item_layout_info.max_width_;
+      arrays.min_border_box_size_[index] = item->MinBorderBoxWidth();
+    } else {
+      arrays.min_size_[index] = item_layout_info.min_height_;
+      arrays.max_size_[index] = item_layout_info.max_height_;
+      arrays.min_border_box_size_[index] = item->MinBorderBoxHeight();
+    }
+    arrays.frozen_[index] = 0;
+
     float flex_factor = current_line.should_apply_grow_
                             ? item_style->flex_grow()
                             : item_style->flex_shrink();
@@ -383,99 +1254,109 @@ void FlexLayoutAlgorithm::FreezeInflexibleItems(FlexLine& current_line) {
          item_info.flex_base_size_ > item_info.hypothetical_main_size_) ||
         (!current_line.should_apply_grow_ &&
          item_info.flex_base_size_ < item_info.hypothetical_main_size_)) {
-      item_info.used_main_size_ = item_info.hypothetical_main_size_;
-      inflexible_item_infos.push_back(&item_info);
+      arrays.used_size_[index] = item_info.hypothetical_main_size_;
+      inflexible_item_indices.push_back(index);
     }
   }
 
-  FreezeViolations(current_line, inflexible_item_infos);
+  FreezeViolations(current_line, arrays, inflexible_item_indices);
   current_line.initial_free_space_ = current_line.remaining_free_space_;
 }
 
 void FlexLayoutAlgorithm::FreezeViolations(
     FlexLine& current_line,
-    std::vector<ItemInfo*>& inflexible_item_infos) {
+    FlexLineArrays& arrays,
+    const std::vector<size_t>& item_indices) {
   // Calculate initial free space. Sum the outer sizes of all items on the line,
   // and subtract this from the flex container’s inner main size. For frozen
   // items, use their outer target main size; for other items, use their outer
   // flex base size.
-  for (auto item_info : inflexible_item_infos) {
-    LayoutNode* item = item_info->item_;
-    const CSSStyle* item_style = item->css_style();
-    float child_size = item_info->used_main_size_;
+  for (size_t index : item_indices) {
+    float flex_base_size = arrays.flex_base_size_[index];
+    float flex_shrink = arrays.flex_shrink_[index];
     current_line.remaining_free_space_ -=
-        child_size - item_info->flex_base_size_;
-    current_line.total_flex_grow_ -= item_style->flex_grow();
-    current_line.total_flex_shrink_ -= item_style->flex_shrink();
-    current_line.total_weighted_flex_shrink_ -=
-        item_style->flex_shrink() * item_info->flex_base_size_;
+        arrays.used_size_[index] - flex_base_size;
+    current_line.total_flex_grow_ -= arrays.flex_grow_[index];
+    current_line.total_flex_shrink_ -= flex_shrink;
+    current_line.total_weighted_flex_shrink_ -= flex_shrink * flex_base_size;
     current_line.total_weighted_flex_shrink_ =
         std::max(current_line.total_weighted_flex_shrink_, .0f);
-    item_info->frozen_ = true;
+    arrays.frozen_[index] = ~0u;
   }
 }
 
-bool FlexLayoutAlgorithm::ResolveFlexibleLengths(FlexLine& current_line) {
-  float total_violation = .0f;
-  float used_free_space = .0f;
-  std::vector<ItemInfo*> min_violations;
-  std::vector<ItemInfo*> max_violations;
-
-  bool should_apply_grow = current_line.should_apply_grow_;
-  float sum_flex_factors = should_apply_grow ? current_line.total_flex_grow_
-                                             : current_line.total_flex_shrink_;
-  // Calculate the remaining free space as for initial free space, above. If the
-  // sum of the unfrozen flex items’ flex factors is less than one, multiply the
-  // initial free space by this sum. If the magnitude of this value is less than
-  // the magnitude of the remaining free space, use this as the remaining free
-  // space.
-  if (sum_flex_factors > 0 && sum_flex_factors < 1) {
-    float fractional = current_line.initial_free_space_ * sum_flex_factors;
-    if (std::abs(fractional) < std::abs(current_line.remaining_free_space_))
-      current_line.remaining_free_space_ = fractional;
+/**
+ * runs rounds of the spec loop on the thresholds of the items instead of the
+ * items themselves, a round costs two binary searches plus the items it
+ * freezes. thresholds are exact but sums are not taken in item order, the
+ * spec loop runs once more afterwards: it computes the final sizes item by
+ * item and freezes whatever rounding made the sweep miss.
+ */
+void FlexLayoutAlgorithm::FreezeViolationsInOrder(FlexLine& current_line,
+                                                  FlexLineArrays& arrays) {
+  ViolationSweep& sweep = scratch_lists.violation_sweep_;
+  std::vector<size_t>& violations = scratch_lists.min_violations_;
+  sweep.Reset(arrays, current_line.should_apply_grow_);
+  while (true) {
+    float total_flex_factor = .0f;
+    FreeSpaceShare share =
+        UpdateFreeSpaceShare(current_line, total_flex_factor);
+    double share_per_flex_factor =
+        share == kFreeSpaceShareNone
+            ? .0
+            : static_cast<double>(current_line.remaining_free_space_) /
+                  total_flex_factor;
+    double total_violation = .0;
+    size_t min_end = 0;
+    size_t max_end = 0;
+    if (!sweep.FindViolations(share_per_flex_factor, total_violation, min_end,
+                              max_end) ||
+        total_violation == 0) {
+      return;
+    }
+    bool min_violations = total_violation > 0;
+    sweep.TakeViolations(min_violations, min_violations ? min_end : max_end,
+                         arrays, violations);
+    FreezeViolations(current_line, arrays, violations);
   }
+}
 
-  for (size_t line_item_index = current_line.start_;
-       line_item_index < current_line.end_; ++line_item_index) {
-    ItemInfo& item_info = item_info_[line_item_index];
-    LayoutNode* item = item_info.item_;
-    const CSSStyle* item_style = item->css_style();
-
-    if (item_info.frozen_) {
+/**
+ * sizes of all unfrozen items come from one kernel call. violations are
+ * summed up in item order afterwards, the way the per-item loop did, so
+ * results do not depend on the lane count.
+ */
+bool FlexLayoutAlgorithm::ResolveFlexibleLengths(FlexLine& current_line,
+                                                 FlexLineArrays& arrays) {
+  float total_violation = .0f;
+  float used_free_space = .0f;
+  std::vector<size_t>& min_violations = scratch_lists.min_violations_;
+  std::vector<size_t>& max_violations = scratch_lists.max_violations_;
+  min_violations.clear();
+  max_violations.clear();
+
+  float total_flex_factor = .0f;
+  FreeSpaceShare share = UpdateFreeSpaceShare(current_line, total_flex_factor);
+  ResolveFlexItemSizes(arrays, share, current_line.remaining_free_space_,
+                       total_flex_factor);
+
+  for (size_t index = 0; index < arrays.count_; ++index) {
+    if (arrays.frozen_[index]) {
       continue;
     }
+    float adjusted_child_size = arrays.used_size_[index];
+    used_free_space += adjusted_child_size - arrays.flex_base_size_[index];
 
-    float child_size = item_info.flex_base_size_;
-    float extra_space = .0f;
-    if (current_line.remaining_free_space_ > 0 &&
-        current_line.total_flex_grow_ > 0 && should_apply_grow) {
-      extra_space = current_line.remaining_free_space_ *
-                    item_style->flex_grow() / current_line.total_flex_grow_;
-    } else if (current_line.remaining_free_space_ < 0 &&
-               current_line.total_weighted_flex_shrink_ > 0 &&
-               !should_apply_grow && item_style->flex_shrink()) {
-      extra_space = current_line.remaining_free_space_ *
-                    item_style->flex_shrink() * child_size /
-                    current_line.total_weighted_flex_shrink_;
-    }
-    child_size += extra_space;
-
-    float adjusted_child_size = main_axis_horizontal_
-                                    ? item->ApplyWidthConstraints(child_size)
-                                    : item->ApplyHeightConstraints(child_size);
-    item_info.used_main_size_ = adjusted_child_size;
-    used_free_space += adjusted_child_size - item_info.flex_base_size_;
-
-    float violation = adjusted_child_size - child_size;
+    float violation = adjusted_child_size - arrays.target_size_[index];
     if (violation > 0)
-      min_violations.push_back(&item_info);
+      min_violations.push_back(index);
     else if (violation < 0)
-      max_violations.push_back(&item_info);
+      max_violations.push_back(index);
     total_violation += violation;
   }
 
   if (total_violation) {
-    FreezeViolations(current_line,
+    FreezeViolations(current_line, arrays,
                      total_violation < 0 ? max_violations : min_violations);
   } else {
     current_line.remaining_free_space_ -= used_free_space;
@@ -484,67 +1365,74 @@ bool FlexLayoutAlgorithm::ResolveFlexibleLengths(FlexLine& current_line) {
   return total_violation;
 }
 
+template <bool kHorizontal>
 void FlexLayoutAlgorithm::DetermineHypotheticalCrossSize() {
-  for (auto& item_info : item_info_) {
-    LayoutNode* item = item_info.item_;
-    const CSSStyle* item_style = item->css_style();
+  MeasureItems(item_info_.data(), item_info_.data() + item_info_.size(),
+               [this](ItemInfo& item_info) {
+                 DetermineHypotheticalCrossSize<kHorizontal>(item_info);
+               });
+}
 
-    float item_layout_width = .0f;
-    float item_layout_height = .0f;
-    LayoutMode item_layout_width_mode = kLayoutModeExact;
-    LayoutMode item_layout_height_mode = kLayoutModeExact;
-    float& item_layout_cross_size =
-        main_axis_horizontal_ ? item_layout_height : item_layout_width;
-    LayoutMode& item_layout_cross_mode = main_axis_horizontal_
-                                             ? item_layout_height_mode
-                                             : item_layout_width_mode;
-
-    const Length& item_cross_size =
-        main_axis_horizontal_ ? item_style->height() : item_style->width();
-    switch (item_cross_size.type()) {
-      case base::kLengthFixed: {
-        item_layout_cross_size = item_cross_size.value();
-        item_layout_cross_mode = kLayoutModeExact;
-        break;
-      }
-      case base::kLengthPercentage: {
-        if (cross_axis_mode_ == kLayoutModeUndefined) {
-          item_layout_cross_size = cross_available_size_;  // TODO: -margin
-          item_layout_cross_mode = kLayoutModeUndefined;
-        } else {
-          item_layout_cross_size =
-              item_cross_size.GetComputedValue(cross_available_size_);
-          item_layout_cross_mode = kLayoutModeExact;
-        }
-        break;
-      }
-      case base::kLengthAuto: {
+template <bool kHorizontal>
+void FlexLayoutAlgorithm::DetermineHypotheticalCrossSize(ItemInfo& item_info) {
+  LayoutNode* item = item_info.item_;
+  const CSSStyle* item_style = item->css_style();
+
+  float item_layout_width = .0f;
+  float item_layout_height = .0f;
+  LayoutMode item_layout_width_mode = kLayoutModeExact;
+  LayoutMode item_layout_height_mode = kLayoutModeExact;
+  float& item_layout_cross_size =
+      kHorizontal ? item_layout_height : item_layout_width;
+  LayoutMode& item_layout_cross_mode =
+      kHorizontal ? item_layout_height_mode : item_layout_width_mode;
+
+  const Length& item_cross_size =
+      kHorizontal ? item_style->height() : item_style->width();
+  switch (item_cross_size.type()) {
+    case base::kLengthFixed: {
+      item_layout_cross_size = item_cross_size.value();
+      item_layout_cross_mode = kLayoutModeExact;
+      break;
+    }
+    case base::kLengthPercentage: {
+      if (cross_axis_mode_ == kLayoutModeUndefined) {
         item_layout_cross_size = cross_available_size_;  // TODO: -margin
         item_layout_cross_mode = kLayoutModeUndefined;
+      } else {
+        item_layout_cross_size =
+            item_cross_size.GetComputedValue(cross_available_size_);
+        item_layout_cross_mode = kLayoutModeExact;
       }
+      break;
     }
-
-    // set main axis layout size, mode is exact
-    if (main_axis_horizontal_) {
-      item_layout_width = item_info.used_main_size_;
-    } else {
-      item_layout_height = item_info.used_main_size_;
+    case base::kLengthAuto: {
+      item_layout_cross_size = cross_available_size_;  // TODO: -margin
+      item_layout_cross_mode = kLayoutModeUndefined;
     }
-    // std::cout << "DetermineHypotheticalCrossSizeLayout:" << item_layout_width
-    //           << " " << item_layout_height << " " << item_layout_width_mode
-    //           << " " << item_layout_height_mode << std::endl;
-    FloatSize layout_result =
-        item->UpdateMeasure(item_layout_width, item_layout_height,
-                            item_layout_width_mode, item_layout_height_mode);
-    item_info.hypothetical_cross_size_ =
-        main_axis_horizontal_ ? layout_result.height_ : layout_result.width_;
   }
+
+  // set main axis layout size, mode is exact
+  if (kHorizontal) {
+    item_layout_width = item_info.used_main_size_;
+  } else {
+    item_layout_height = item_info.used_main_size_;
+  }
+  // std::cout << "DetermineHypotheticalCrossSizeLayout:" << item_layout_width
+  //           << " " << item_layout_height << " " << item_layout_width_mode
+  //           << " " << item_layout_height_mode << std::endl;
+  FloatSize layout_result =
+      item->UpdateMeasure(item_layout_width, item_layout_height,
+                          item_layout_width_mode, item_layout_height_mode);
+  item_info.hypothetical_cross_size_ =
+      kHorizontal ? layout_result.height_ : layout_result.width_;
 }
 
+template <bool kHorizontal>
 void FlexLayoutAlgorithm::CalculateFlexlineCrossSize() {
   // If the flex container is single-line and has a definite cross size, the
   // cross size of the flex line is the flex container’s inner cross size.
-  if (container_style_->flex_wrap() == kFlexWrapNoWrap &&
+  if (container_->css_style()->flex_wrap() == kFlexWrapNoWrap &&
       flex_lines_.size() > 0 && cross_axis_mode_ == kLayoutModeExact) {
     flex_lines_[0].line_cross_size_ = cross_available_size_;
     return;  // TODO:If the flex container is single-line, then clamp the line’s
@@ -561,12 +1449,11 @@ void FlexLayoutAlgorithm::CalculateFlexlineCrossSize() {
           item_info_[line_item_index].item_->css_style();
       float item_outer_hypothetical_cross_size =
           item_info_[line_item_index].hypothetical_cross_size_;
-      const Length& cross_margin_front = main_axis_horizontal_
-                                             ? item_style->margin_top()
-                                             : item_style->margin_left();
-      const Length& cross_margin_after = main_axis_horizontal_
-                                             ? item_style->margin_bottom()
-                                             : item_style->margin_right();
+      const Length& cross_margin_front =
+          kHorizontal ? item_style->margin_top() : item_style->margin_left();
+      const Length& cross_margin_after = kHorizontal
+                                         ? item_style->margin_bottom()
+                                         : item_style->margin_right();
       float margin_refer_cross_size = cross_axis_mode_ == kLayoutModeUndefined
                                           ? .0f
                                           : cross_available_size_;
@@ -587,7 +1474,7 @@ void FlexLayoutAlgorithm::CalculateFlexlineCrossSize() {
 
 void FlexLayoutAlgorithm::ExpandFlexlineCrossSizeDueToAlignContentStretch() {
   if (cross_axis_mode_ == kLayoutModeUndefined ||
-      container_style_->align_content() != kAlignContentStretch) {
+      container_->css_style()->align_content() != kAlignContentStretch) {
     return;
   }
   float sum_line_cross_size = .0f;
@@ -608,59 +1495,66 @@ void FlexLayoutAlgorithm::ExpandFlexlineCrossSizeDueToAlignContentStretch() {
 /**
  * Determine the used cross size of each flex item.
  */
+template <bool kHorizontal>
 void FlexLayoutAlgorithm::DetermineFlexItemUsedCrossSize() {
   for (auto& flexline : flex_lines_) {
-    for (size_t line_item_index = flexline.start_;
-         line_item_index < flexline.end_; ++line_item_index) {
-      ItemInfo& item_info = item_info_[line_item_index];
-      const CSSStyle* item_style = item_info.item_->css_style();
-      // If a flex item has align-self: stretch, its computed cross size
-      // property is auto, and neither of its cross-axis margins are auto, the
-      // used outer cross size is the used cross size of its flex line, clamped
-      // according to the item’s used min and max cross sizes.
-      const Length& item_cross_size =
-          main_axis_horizontal_ ? item_style->height() : item_style->width();
-      const Length& cross_margin_front = main_axis_horizontal_
-                                             ? item_style->margin_top()
-                                             : item_style->margin_left();
-      const Length& cross_margin_after = main_axis_horizontal_
-                                             ? item_style->margin_bottom()
-                                             : item_style->margin_right();
-      AlignItemsType align_type =
-          item_style->align_self() == kAlignSelfAuto
-              ? (container_style_->align_items())
-              : AlignItemsType(item_style->align_self());
-      if (align_type == kAlignItemsStretch && item_cross_size.IsAuto() &&
-          !cross_margin_front.IsAuto() && !cross_margin_after.IsAuto()) {
-        item_info.used_cross_size_ =
-            flexline.line_cross_size_ -
-            item_info.item_->layout_info().margin_[cross_axis_front_] -
-            item_info.item_->layout_info().margin_[cross_axis_after_];
-        // TODO:clamp
-        float item_layout_width = main_axis_horizontal_
-                                      ? item_info.used_main_size_
-                                      : item_info.used_cross_size_;
-        float item_layout_height = main_axis_horizontal_
-                                       ? item_info.used_cross_size_
-                                       : item_info.used_main_size_;
-        item_info.item_->ApplyWidthConstraints(item_layout_width);
-        item_info.item_->ApplyHeightConstraints(item_layout_height);
-        LayoutMode item_layout_width_mode = kLayoutModeExact;
-        LayoutMode item_layout_height_mode = kLayoutModeExact;
-        item_info.item_->UpdateMeasure(item_layout_width, item_layout_height,
-                                       item_layout_width_mode,
-                                       item_layout_height_mode);
-      } else {
-        // Otherwise, the used cross size is the item’s hypothetical cross size.
-        item_info.used_cross_size_ = item_info.hypothetical_cross_size_;
-      }
-    }
+    MeasureItems(item_info_.data() + flexline.start_,
+                 item_info_.data() + flexline.end_,
+                 [this, &flexline](ItemInfo& item_info) {
+                   DetermineFlexItemUsedCrossSize<kHorizontal>(flexline,
+                                                               item_info);
+                 });
+  }
+}
+
+template <bool kHorizontal>
+void FlexLayoutAlgorithm::DetermineFlexItemUsedCrossSize(
+    const FlexLine& flexline,
+    ItemInfo& item_info) {
+  typedef FlexAxis<kHorizontal> Axis;
+  const CSSStyle* item_style = item_info.item_->css_style();
+  // If a flex item has align-self: stretch, its computed cross size
+  // property is auto, and neither of its cross-axis margins are auto, the
+  // used outer cross size is the used cross size of its flex line, clamped
+  // according to the item’s used min and max cross sizes.
+  const Length& item_cross_size =
+      kHorizontal ? item_style->height() : item_style->width();
+  const Length& cross_margin_front =
+      kHorizontal ? item_style->margin_top() : item_style->margin_left();
+  const Length& cross_margin_after =
+      kHorizontal ? item_style->margin_bottom() : item_style->margin_right();
+  AlignItemsType align_type =
+      item_style->align_self() == kAlignSelfAuto
+          ? (container_->css_style()->align_items())
+          : AlignItemsType(item_style->align_self());
+  if (align_type == kAlignItemsStretch && item_cross_size.IsAuto() &&
+      !cross_margin_front.IsAuto() && !cross_margin_after.IsAuto()) {
+    item_info.used_cross_size_ =
+        flexline.line_cross_size_ -
+        item_info.item_->layout_info().margin_[Axis::kCrossFront] -
+        item_info.item_->layout_info().margin_[Axis::kCrossAfter];
+    // TODO:clamp
+    float item_layout_width =
+        kHorizontal ? item_info.used_main_size_ : item_info.used_cross_size_;
+    float item_layout_height =
+        kHorizontal ? item_info.used_cross_size_ : item_info.used_main_size_;
+    item_info.item_->ApplyWidthConstraints(item_layout_width);
+    item_info.item_->ApplyHeightConstraints(item_layout_height);
+    LayoutMode item_layout_width_mode = kLayoutModeExact;
+    LayoutMode item_layout_height_mode = kLayoutModeExact;
+    item_info.item_->UpdateMeasure(item_layout_width, item_layout_height,
+                                   item_layout_width_mode,
+                                   item_layout_height_mode);
+  } else {
+    // Otherwise, the used cross size is the item’s hypothetical cross size.
+    item_info.used_cross_size_ = item_info.hypothetical_cross_size_;
   }
 }
 
 /**
  * Determine the flex container’s used cross size
  */
+template <bool kHorizontal>
 void FlexLayoutAlgorithm::DetermineContainerUsedCrossSize() {
   // If the cross size property is a definite size, use that,
   if (cross_axis_mode_ == kLayoutModeExact) {
@@ -680,40 +1574,74 @@ void FlexLayoutAlgorithm::DetermineContainerUsedCrossSize() {
   }
   for (auto& item_info : item_info_) {
     item_info.item_->UpdateLayoutInfo(
-        main_axis_horizontal_ ? main_available_size_ : cross_available_size_,
-        main_axis_horizontal_ ? cross_available_size_ : main_available_size_);
+        kHorizontal ? main_available_size_ : cross_available_size_,
+        kHorizontal ? cross_available_size_ : main_available_size_);
   }
 }
 
-void FlexLayoutAlgorithm::MainAxisAlignment() {
+/**
+ * auto margins get their values during alignment. start again from the
+ * margins measure resolved, against the same container width, so that
+ * alignment can also run alone.
+ */
+void FlexLayoutAlgorithm::ResetAutoMargins(size_t first_item) {
+  float container_width =
+      main_axis_horizontal_ ? main_available_size_ : cross_available_size_;
+  for (size_t index = first_item; index < item_info_.size(); ++index) {
+    LayoutNode* item = item_info_[index].item_;
+    const CSSStyle* item_style = item->css_style();
+    float* margin = item->GetModifiableLayoutInfo().margin_;
+    margin[kCSSDirectionTop] =
+        item_style->margin_top().GetComputedValue(container_width);
+    margin[kCSSDirectionLeft] =
+        item_style->margin_left().GetComputedValue(container_width);
+    margin[kCSSDirectionBottom] =
+        item_style->margin_bottom().GetComputedValue(container_width);
+    margin[kCSSDirectionRight] =
+        item_style->margin_right().GetComputedValue(container_width);
+  }
+}
+
+template <bool kHorizontal, bool kReverse>
+void FlexLayoutAlgorithm::MainAxisAlignment(size_t first_item) {
+  typedef FlexAxis<kHorizontal> Axis;
+  // appended items line up after the others, see AppendKeepsLayout
+  if (first_item > 0) {
+    for (size_t index = first_item; index < item_info_.size(); ++index) {
+      appended_main_start_ = PlaceOnMainAxis<kHorizontal>(
+          item_info_[index].item_, appended_main_start_, .0f);
+    }
+    return;
+  }
+
   float main_axis_padding_front =
-      container_->layout_info().padding_[main_axis_front_];
+      container_->layout_info().padding_[Axis::kMainFront];
 
   for (auto& flexline : flex_lines_) {
-    std::vector<LayoutNode*> items(flexline.end_ - flexline.start_, nullptr);
+    std::vector<LayoutNode*>& items = scratch_lists.line_items_;
+    items.assign(flexline.end_ - flexline.start_, nullptr);
     size_t item_index = 0;
     // If the remaining free space is positive and at least one main-axis margin
     // on this line is auto, distribute the free space equally among these
     // margins. Otherwise, set all auto margins to zero.
     float total_used_main_axis_size = .0f;
-    std::vector<std::pair<size_t, bool>> auto_margins;
+    std::vector<std::pair<size_t, bool>>& auto_margins =
+        scratch_lists.auto_margins_;
+    auto_margins.clear();
     for (size_t line_item_index = flexline.start_;
          line_item_index < flexline.end_; ++line_item_index) {
       LayoutNode* item = item_info_[line_item_index].item_;
       items[item_index++] = item;
       const CSSStyle* item_style = item->css_style();
       total_used_main_axis_size +=
-          (main_axis_horizontal_ ? item->offset_width()
-                                 : item->offset_height()) +
-          item->layout_info().margin_[main_axis_front_] +
-          item->layout_info().margin_[main_axis_after_];
-
-      const Length& margin_front = main_axis_horizontal_
-                                       ? item_style->margin_left()
-                                       : item_style->margin_top();
-      const Length& margin_after = main_axis_horizontal_
-                                       ? item_style->margin_right()
-                                       : item_style->margin_bottom();
+          (kHorizontal ? item->offset_width() : item->offset_height()) +
+          item->layout_info().margin_[Axis::kMainFront] +
+          item->layout_info().margin_[Axis::kMainAfter];
+
+      const Length& margin_front =
+          kHorizontal ? item_style->margin_left() : item_style->margin_top();
+      const Length& margin_after = kHorizontal ? item_style->margin_right()
+                                               : item_style->margin_bottom();
       if (margin_front.IsAuto()) {
         auto_margins.push_back(std::make_pair(line_item_index, true));
       }
@@ -729,27 +1657,26 @@ void FlexLayoutAlgorithm::MainAxisAlignment() {
       for (const auto& auto_margin : auto_margins) {
         item_info_[auto_margin.first]
             .item_->GetModifiableLayoutInfo()
-            .margin_[auto_margin.first ? main_axis_front_ : main_axis_after_] =
+            .margin_[auto_margin.second ? Axis::kMainFront : Axis::kMainAfter] =
             auto_margin_value;
       }
       total_used_main_axis_size = main_available_size_;
     }
 
     // apply justify content
-    bool is_reverse = container_style_->IsMainAxisReverse();
     float adjust_main_start = main_axis_padding_front;
     float adjust_main_interval = .0f;
     float remaining_space = main_available_size_ - total_used_main_axis_size;
     int line_flex_item_count = flexline.end_ - flexline.start_;
-    switch (container_style_->justify_content()) {
+    switch (container_->css_style()->justify_content()) {
       case kJustifyContentFlexStart: {
-        if (is_reverse) {
+        if (kReverse) {
           adjust_main_start += remaining_space;
         }
         break;
       }
       case kJustifyContentFlexEnd: {
-        if (!is_reverse) {
+        if (!kReverse) {
           adjust_main_start += remaining_space;
         }
         break;
@@ -771,36 +1698,47 @@ void FlexLayoutAlgorithm::MainAxisAlignment() {
         break;
       }
     }
-    if (is_reverse) {
+    if (kReverse) {
       std::reverse(items.begin(), items.end());
     }
 
     for (size_t i = 0; i < items.size(); ++i) {
-      LayoutNode* item = items[i];
-      adjust_main_start += item->layout_info().margin_[main_axis_front_];
-      if (main_axis_horizontal_) {
-        item->SetOffsetLeft(adjust_main_start);
-      } else {
-        item->SetOffsetTop(adjust_main_start);
-      }
-      adjust_main_start += (main_axis_horizontal_ ? item->offset_width()
-                                                  : item->offset_height()) +
-                           item->layout_info().margin_[main_axis_after_] +
-                           adjust_main_interval;
+      adjust_main_start =
+          PlaceOnMainAxis<kHorizontal>(items[i], adjust_main_start,
+                                       adjust_main_interval);
     }
+    appended_main_start_ = adjust_main_start;
+  }
+}
+
+// returns where the next item starts
+template <bool kHorizontal>
+float FlexLayoutAlgorithm::PlaceOnMainAxis(LayoutNode* item,
+                                           float main_start,
+                                           float interval) {
+  typedef FlexAxis<kHorizontal> Axis;
+  main_start += item->layout_info().margin_[Axis::kMainFront];
+  if (kHorizontal) {
+    item->SetOffsetLeft(main_start);
+  } else {
+    item->SetOffsetTop(main_start);
   }
+  return main_start +
+         ((kHorizontal ? item->offset_width() : item->offset_height()) +
+          item->layout_info().margin_[Axis::kMainAfter] + interval);
 }
 
-void FlexLayoutAlgorithm::CrossAxisAlignment() {
+template <bool kHorizontal, bool kWrapReverse>
+void FlexLayoutAlgorithm::CrossAxisAlignment(size_t first_item) {
+  typedef FlexAxis<kHorizontal> Axis;
   // step: [1] apply `align-content` -> [2] apply cross axis `auto` margin ->
   // [3] apply `align-items` | `align-self` -> [4] apply `wrap-reverse`
-  bool is_wrap_reverse = container_style_->flex_wrap() == kFlexWrapWrapReverse;
   float cross_axis_padding_front =
-      container_->layout_info().padding_[cross_axis_front_];
+      container_->layout_info().padding_[Axis::kCrossFront];
   float cross_axis_padding_after =
-      container_->layout_info().padding_[cross_axis_after_];
+      container_->layout_info().padding_[Axis::kCrossAfter];
   float cross_axis_padding_start =
-      is_wrap_reverse ? cross_axis_padding_after : cross_axis_padding_front;
+      kWrapReverse ? cross_axis_padding_after : cross_axis_padding_front;
   float total_used_cross_axis_size = .0f;
   for (auto& flexline : flex_lines_) {
     total_used_cross_axis_size += flexline.line_cross_size_;
@@ -810,7 +1748,7 @@ void FlexLayoutAlgorithm::CrossAxisAlignment() {
 
   float remaining_cross_axis_space =
       cross_available_size_ - total_used_cross_axis_size;
-  switch (container_style_->align_content()) {
+  switch (container_->css_style()->align_content()) {
     case kAlignContentFlexStart: {
       break;  // do nothing
     }
@@ -841,7 +1779,7 @@ void FlexLayoutAlgorithm::CrossAxisAlignment() {
   }
 
   for (auto& flexline : flex_lines_) {
-    for (size_t line_item_index = flexline.start_;
+    for (size_t line_item_index = std::max(flexline.start_, first_item);
          line_item_index < flexline.end_; ++line_item_index) {
       LayoutNode* item = item_info_[line_item_index].item_;
       const CSSStyle* item_style = item->css_style();
@@ -850,32 +1788,30 @@ void FlexLayoutAlgorithm::CrossAxisAlignment() {
       // than the cross size of its flex line, distribute the difference in
       // those sizes equally to the auto margins.
       float item_cross_border_size =
-          main_axis_horizontal_ ? item->offset_height() : item->offset_width();
+          kHorizontal ? item->offset_height() : item->offset_width();
       float item_outer_cross_size =
           item_cross_border_size +
-          item->layout_info().margin_[cross_axis_front_] +
-          item->layout_info().margin_[cross_axis_after_];
-      const Length& margin_front = main_axis_horizontal_
-                                       ? item_style->margin_top()
-                                       : item_style->margin_left();
-      const Length& margin_after = main_axis_horizontal_
-                                       ? item_style->margin_bottom()
-                                       : item_style->margin_right();
+          item->layout_info().margin_[Axis::kCrossFront] +
+          item->layout_info().margin_[Axis::kCrossAfter];
+      const Length& margin_front =
+          kHorizontal ? item_style->margin_top() : item_style->margin_left();
+      const Length& margin_after = kHorizontal ? item_style->margin_bottom()
+                                               : item_style->margin_right();
       if (item_outer_cross_size < flexline.line_cross_size_) {
         bool margin_front_auto = margin_front.IsAuto();
         bool margin_after_auto = margin_after.IsAuto();
         float item_cross_remaining_space =
             flexline.line_cross_size_ - item_outer_cross_size;
         if (margin_front_auto && margin_after_auto) {
-          item->GetModifiableLayoutInfo().margin_[cross_axis_front_] =
+          item->GetModifiableLayoutInfo().margin_[Axis::kCrossFront] =
               item_cross_remaining_space / 2.0f;
-          item->GetModifiableLayoutInfo().margin_[cross_axis_after_] =
+          item->GetModifiableLayoutInfo().margin_[Axis::kCrossAfter] =
               item_cross_remaining_space / 2.0f;
         } else if (margin_front_auto) {
-          item->GetModifiableLayoutInfo().margin_[cross_axis_front_] =
+          item->GetModifiableLayoutInfo().margin_[Axis::kCrossFront] =
               item_cross_remaining_space;
         } else if (margin_after_auto) {
-          item->GetModifiableLayoutInfo().margin_[cross_axis_after_] =
+          item->GetModifiableLayoutInfo().margin_[Axis::kCrossAfter] =
               item_cross_remaining_space;
         }
         if (margin_front_auto || margin_after_auto) {
@@ -887,69 +1823,69 @@ void FlexLayoutAlgorithm::CrossAxisAlignment() {
       // the item’s cross-axis margins are auto.
       AlignItemsType align_type =
           item_style->align_self() == kAlignSelfAuto
-              ? (container_style_->align_items())
+              ? (container_->css_style()->align_items())
               : AlignItemsType(item_style->align_self());
       float item_cross_offset = .0f;
       switch (align_type) {
         case kAlignItemsFlexStart: {
-          if (is_wrap_reverse) {
+          if (kWrapReverse) {
             item_cross_offset =
                 cross_axis_padding_front + cross_available_size_ -
                 (adjust_cross_start +
-                 item->layout_info().margin_[cross_axis_after_] +
+                 item->layout_info().margin_[Axis::kCrossAfter] +
                  item_cross_border_size);
           } else {
             item_cross_offset = adjust_cross_start +
-                                item->layout_info().margin_[cross_axis_front_];
+                                item->layout_info().margin_[Axis::kCrossFront];
           }
 
           break;
         }
         case kAlignItemsFlexEnd: {
-          if (is_wrap_reverse) {
+          if (kWrapReverse) {
             cross_axis_padding_front + cross_available_size_ -
                 (adjust_cross_start + flexline.line_cross_size_ -
-                 item->layout_info().margin_[cross_axis_front_]);
+                 item->layout_info().margin_[Axis::kCrossFront]);
           } else {
             item_cross_offset =
                 (adjust_cross_start + flexline.line_cross_size_ -
-                 item->layout_info().margin_[cross_axis_after_]) -
+                 item->layout_info().margin_[Axis::kCrossAfter]) -
                 item_cross_border_size;
           }
 
           break;
         }
         case kAlignItemsCenter: {
-          if (is_wrap_reverse) {
+          if (kWrapReverse) {
             cross_axis_padding_front + cross_available_size_ -
                 (adjust_cross_start + flexline.line_cross_size_ -
                  (flexline.line_cross_size_ - item_outer_cross_size) / 2.0f -
-                 item->layout_info().margin_[cross_axis_front_]);
+                 item->layout_info().margin_[Axis::kCrossFront]);
           } else {
             item_cross_offset =
                 adjust_cross_start +
                 (flexline.line_cross_size_ - item_outer_cross_size) / 2.0f +
-                item->layout_info().margin_[cross_axis_front_];
+                item->layout_info().margin_[Axis::kCrossFront];
           }
 
           break;
         }
         case kAlignItemsStretch: {
-          if (is_wrap_reverse) {
+          if (kWrapReverse) {
             item_cross_offset =
                 cross_axis_padding_front + cross_available_size_ -
                 (adjust_cross_start +
-                 item->layout_info().margin_[cross_axis_after_] +
+                 item->layout_info().margin_[Axis::kCrossAfter] +
                  item_cross_border_size);
           } else {
             item_cross_offset = adjust_cross_start +
-                                item->layout_info().margin_[cross_axis_front_];
+                                item->layout_info().margin_[Axis::kCrossFront];
           }
           break;
         }
       }
 
-      if (main_axis_horizontal_) {
+      if (kHorizontal) {
         item->SetOffsetTop(item_cross_offset);
       } else {
         item->SetOffsetLeft(item_cross_offset);
@@ -960,4 +1896,61 @@ void FlexLayoutAlgorithm::CrossAxisAlignment() {
   }
 }
 
+/**
+ * where the item would be as the only flex item, placed by `justify-content`
+ * or `align-self`
+ */
+float FlexLayoutAlgorithm::StaticPosition(LayoutNode* container,
+                                          LayoutNode* item,
+                                          bool horizontal,
+                                          float size) const {
+  const CSSStyle* container_style = container_->css_style();
+  bool main_axis = horizontal == main_axis_horizontal_;
+  size_t front = main_axis ? main_axis_front_ : cross_axis_front_;
+  size_t after = main_axis ? main_axis_after_ : cross_axis_after_;
+  const float* margin = item->layout_info().margin_;
+  float available_size =
+      main_axis ? main_available_size_ : cross_available_size_;
+  float free_space = available_size - size - margin[front] - margin[after];
+
+  // share of free space before the item, start is the end if reversed
+  float share = .0f;
+  if (main_axis) {
+    bool is_reverse = container_style->IsMainAxisReverse();
+    switch (container_style->justify_content()) {
+      case kJustifyContentFlexStart:
+      case kJustifyContentSpaceBetween:
+        share = is_reverse ? free_space : .0f;
+        break;
+      case kJustifyContentFlexEnd:
+        share = is_reverse ? .0f : free_space;
+        break;
+      case kJustifyContentCenter:
+      case kJustifyContentSpaceAround:
+        share = free_space / 2.0f;
+        break;
+    }
+  } else {
+    bool is_wrap_reverse =
+        container_style->flex_wrap() == kFlexWrapWrapReverse;
+    AlignItemsType align_type =
+        item->css_style()->align_self() == kAlignSelfAuto
+            ? container_style->align_items()
+            : AlignItemsType(item->css_style()->align_self());
+    switch (align_type) {
+      case kAlignItemsFlexStart:
+      case kAlignItemsStretch:
+        share = is_wrap_reverse ? free_space : .0f;
+        break;
+      case kAlignItemsFlexEnd:
+        share = is_wrap_reverse ? .0f : free_space;
+        break;
+      case kAlignItemsCenter:
+        share = free_space / 2.0f;
+        break;
+    }
+  }
+  return container_->layout_info().padding_[front] + margin[front] + share;
+}
+
 }  // namespace starlight
\ No newline at end of file
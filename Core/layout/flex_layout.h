@@ -6,11 +6,39 @@
 #include <vector>
 
 #include "layout/layout_algorithm.h"
+#include "layout/layout_node.h"
 
 namespace starlight {
 
 class CSSStyle;
-class LayoutNode;
+struct FlexLineArrays;
+
+// what the flex line of an item was broken and resolved with
+struct ItemLineInputs {
+  bool operator==(const ItemLineInputs& other) const {
+    return flex_grow_ == other.flex_grow_ &&
+           flex_shrink_ == other.flex_shrink_ &&
+           flex_base_size_ == other.flex_base_size_ &&
+           hypothetical_main_size_ == other.hypothetical_main_size_ &&
+           margin_front_ == other.margin_front_ &&
+           margin_after_ == other.margin_after_ &&
+           min_size_ == other.min_size_ && max_size_ == other.max_size_ &&
+           min_border_box_size_ == other.min_border_box_size_;
+  }
+  bool operator!=(const ItemLineInputs& other) const {
+    return !(*this == other);
+  }
+  float flex_grow_ = -1.f;
+  float flex_shrink_ = -1.f;
+  float flex_base_size_ = .0f;
+  float hypothetical_main_size_ = .0f;
+  // along the main axis
+  float margin_front_ = .0f;
+  float margin_after_ = .0f;
+  float min_size_ = .0f;
+  float max_size_ = .0f;
+  float min_border_box_size_ = .0f;
+};
 
 struct ItemInfo {
   ItemInfo(LayoutNode* item)
@@ -28,6 +56,8 @@ struct ItemInfo {
   bool frozen_;
   float hypothetical_cross_size_;
   float used_cross_size_;
+  // as of the last time the item's line was resolved, matches nothing before
+  ItemLineInputs line_inputs_;
 };
 
 /**
@@ -71,7 +101,7 @@ struct FlexLine {
 
 class FlexLayoutAlgorithm : public LayoutAlgorithm {
  public:
-  FlexLayoutAlgorithm(LayoutNode* container, const CSSStyle* container_style);
+  explicit FlexLayoutAlgorithm(LayoutNode* container);
   ~FlexLayoutAlgorithm();
 
   virtual void Initialize(float width,
@@ -88,27 +118,82 @@ class FlexLayoutAlgorithm : public LayoutAlgorithm {
 
   virtual void Alignment();
 
+  virtual void OnChildInserted(LayoutNode* child);
+
+  virtual void OnChildRemoved(LayoutNode* child);
+
+  virtual LayoutNode* FirstChangedChild() const;
+
  private:
-  // measure funcs
+  void CollectItems();
+
+  // measure funcs, the ones templated on the main axis are instantiated for
+  // either axis
+  template <bool kHorizontal>
+  void Measure();
+  template <bool kHorizontal>
   void CalculateFlexBasis();
+  template <bool kHorizontal>
+  void CalculateFlexBasis(ItemInfo& item_info);
+  template <bool kHorizontal>
   void DetermineContainerMainSize();
+  template <bool kHorizontal>
+  ItemLineInputs LineInputs(const ItemInfo& item_info) const;
+  template <bool kHorizontal>
   void CollectIntoFlexlines();
+  template <bool kHorizontal>
   bool CollectIntoSignleFlexline(size_t& next_index);
+  template <bool kHorizontal>
   void ResolveFlexlines();
+  template <bool kHorizontal>
   void ResolveSingleFlexline(FlexLine& current_line);
-  void FreezeInflexibleItems(FlexLine& current_line);
+  template <bool kHorizontal>
+  bool ResolveTrivialFlexline(FlexLine& current_line);
+  template <bool kHorizontal>
+  void FreezeInflexibleItems(FlexLine& current_line, FlexLineArrays& arrays);
   void FreezeViolations(FlexLine& current_line,
-                        std::vector<ItemInfo*>& inflexible_item_infos);
-  bool ResolveFlexibleLengths(FlexLine& current_line);
+                        FlexLineArrays& arrays,
+                        const std::vector<size_t>& item_indices);
+  bool ResolveFlexibleLengths(FlexLine& current_line, FlexLineArrays& arrays);
+  void FreezeViolationsInOrder(FlexLine& current_line, FlexLineArrays& arrays);
+  template <bool kHorizontal>
   void DetermineHypotheticalCrossSize();
+  template <bool kHorizontal>
+  void DetermineHypotheticalCrossSize(ItemInfo& item_info);
+  template <bool kHorizontal>
   void CalculateFlexlineCrossSize();
   void ExpandFlexlineCrossSizeDueToAlignContentStretch();
+  template <bool kHorizontal>
   void DetermineFlexItemUsedCrossSize();
+  template <bool kHorizontal>
+  void DetermineFlexItemUsedCrossSize(const FlexLine& flexline,
+                                      ItemInfo& item_info);
+  template <bool kHorizontal>
   void DetermineContainerUsedCrossSize();
+  template <bool kHorizontal>
+  void UpdateContainerSize();
 
-  // align funcs
-  void MainAxisAlignment();
-  void CrossAxisAlignment();
+  // appending items
+  bool AppendKeepsLayout() const;
+  bool AppendKeepsLayout(const ItemInfo& item_info) const;
+  template <bool kHorizontal>
+  void MeasureAppendedItems();
+
+  // align funcs, items before `first_item` keep their place
+  void ResetAutoMargins(size_t first_item);
+  template <bool kHorizontal>
+  void Alignment(size_t first_item);
+  template <bool kHorizontal, bool kReverse>
+  void MainAxisAlignment(size_t first_item);
+  template <bool kHorizontal>
+  float PlaceOnMainAxis(LayoutNode* item, float main_start, float interval);
+  template <bool kHorizontal, bool kWrapReverse>
+  void CrossAxisAlignment(size_t first_item);
+
+  virtual float StaticPosition(LayoutNode* container,
+                               LayoutNode* item,
+                               bool horizontal,
+                               float size) const;
 
   // settings
   void SolveDirction();
@@ -117,8 +202,9 @@ class FlexLayoutAlgorithm : public LayoutAlgorithm {
                           LayoutMode width_mode,
                           LayoutMode height_mode);
 
+  // styles are shared and replaced on change, always read the current one
+  // from the container
   LayoutNode* container_;
-  const CSSStyle* container_style_;
 
   float main_available_size_;
   float cross_available_size_;
@@ -134,6 +220,39 @@ class FlexLayoutAlgorithm : public LayoutAlgorithm {
   std::vector<ItemInfo> item_info_;
   std::vector<LayoutNode*> absolute_items;
   std::vector<FlexLine> flex_lines_;
+
+  // some flex item has non-zero `order`, item_info_ is not in tree order
+  bool has_order_;
+  // item lists have to be collected again from the children on next update
+  bool items_dirty_;
+
+  // lines of the last pass can be kept if they were broken with the same
+  // main size, wrap and direction, and items have not been collected again
+  bool lines_reusable_;
+  float lines_main_size_;
+  bool lines_single_line_;
+  size_t lines_main_axis_front_;
+  // items from here on were inserted or shifted since the last pass
+  size_t first_moved_item_;
+  // lines broken this pass, the ones to resolve
+  size_t new_lines_begin_;
+  size_t new_lines_end_;
+
+  // appending items to the container leaves the layout of the items measured
+  // by the last pass with `append_constraints_` as it is
+  bool append_ready_;
+  LayoutConstraints append_constraints_;
+  size_t measured_items_;
+  float measured_main_size_;
+  // where the item after the last one starts along the main axis
+  float appended_main_start_;
+  // this pass only measures items from here on, zero for all of them
+  size_t appended_items_begin_;
+  // the last alignment is still in place for all items before, zero if it is
+  // not
+  size_t aligned_items_;
+  // first item the last alignment placed, null if it placed all of them
+  LayoutNode* first_aligned_item_;
 };
 
 }  // namespace starlight
@@ -0,0 +1,628 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include <algorithm>
+
+#include "layout/grid_layout.h"
+#include "layout/layout_node.h"
+#include "layout/style.h"
+#include "base/thread_pool.h"
+
+namespace starlight {
+
+namespace {
+
+/**
+ * items measured in one step do not depend on each other, see MeasureItems of
+ * the flex layout. only items `needs_measure` picks are measured.
+ */
+template <typename NeedsMeasure, typename Measure>
+void MeasureItems(std::vector<GridItem>& items,
+                  NeedsMeasure needs_measure,
+                  Measure measure) {
+  base::ThreadPool* thread_pool = base::ThreadPool::Current();
+  if (thread_pool == nullptr) {
+    for (GridItem& grid_item : items) {
+      if (needs_measure(grid_item)) {
+        measure(grid_item);
+      }
+    }
+    return;
+  }
+  base::TaskGroup tasks(thread_pool);
+  for (GridItem& grid_item : items) {
+    if (needs_measure(grid_item)) {
+      GridItem* item = &grid_item;
+      tasks.Run([&measure, item] { measure(*item); },
+                item->item_->first_child() != nullptr);
+    }
+  }
+  tasks.Wait();
+}
+
+// lines and spans set as values are clamped like parsed ones
+int ClampedValue(const GridLine& line) {
+  return line.value_ < 1                   ? 1
+         : line.value_ > GridLine::kMaxValue ? GridLine::kMaxValue
+                                           : line.value_;
+}
+
+/**
+ * first track and number of tracks an item's lines give along one axis.
+ * returns false if the position is left to auto-placement, `span` is set
+ * then. lines past each other are swapped, a span against a line starts no
+ * earlier than the first track.
+ */
+bool ResolveLines(const GridLine& start,
+                  const GridLine& end,
+                  size_t& position,
+                  size_t& span) {
+  int start_value = ClampedValue(start);
+  int end_value = ClampedValue(end);
+  if (!start.IsAuto() && !start.span_) {
+    position = start_value - 1;
+    span = 1;
+    if (!end.IsAuto() && end.span_) {
+      span = end_value;
+    } else if (!end.IsAuto() && end_value > start_value) {
+      span = end_value - start_value;
+    } else if (!end.IsAuto() && end_value < start_value) {
+      position = end_value - 1;
+      span = start_value - end_value;
+    }
+    return true;
+  }
+  span = start.span_ ? start_value : 1;
+  if (!end.IsAuto() && !end.span_) {
+    position =
+        end_value - 1 >= static_cast<int>(span) ? end_value - 1 - span : 0;
+    return true;
+  }
+  if (!start.span_ && end.span_) {
+    span = end_value;
+  }
+  return false;
+}
+
+// space taken by the margins of an item along an axis
+float MarginSize(const LayoutNode* item, bool horizontal) {
+  const float* margin = item->layout_info().margin_;
+  return horizontal ? margin[kCSSDirectionLeft] + margin[kCSSDirectionRight]
+                    : margin[kCSSDirectionTop] + margin[kCSSDirectionBottom];
+}
+
+AlignItemsType AlignSelf(const LayoutNode* container, const LayoutNode* item) {
+  AlignSelfType align_self = item->css_style()->align_self();
+  return align_self == kAlignSelfAuto ? container->css_style()->align_items()
+                                      : AlignItemsType(align_self);
+}
+
+}  // namespace
+
+GridLayoutAlgorithm::GridLayoutAlgorithm(LayoutNode* container)
+    : LayoutAlgorithm(),
+      container_(container),
+      available_width_(.0f),
+      available_height_(.0f),
+      width_mode_(kLayoutModeExact),
+      height_mode_(kLayoutModeExact),
+      items_dirty_(false) {}
+
+GridLayoutAlgorithm::~GridLayoutAlgorithm() {}
+
+void GridLayoutAlgorithm::Initialize(float width,
+                                     float height,
+                                     LayoutMode width_mode,
+                                     LayoutMode height_mode) {
+  CollectItems();
+  ResolveSizeAndMode(width, height, width_mode, height_mode);
+}
+
+void GridLayoutAlgorithm::Update(float width,
+                                 float height,
+                                 LayoutMode width_mode,
+                                 LayoutMode height_mode) {
+  if (items_dirty_) {
+    CollectItems();
+  }
+  ResolveSizeAndMode(width, height, width_mode, height_mode);
+}
+
+// items are placed again by every measure, lists are only rebuilt
+void GridLayoutAlgorithm::OnChildInserted(LayoutNode* child) {
+  items_dirty_ = true;
+}
+
+void GridLayoutAlgorithm::OnChildRemoved(LayoutNode* child) {
+  items_dirty_ = true;
+}
+
+/**
+ * traverse children to classify them, sort grid items by `order`
+ */
+void GridLayoutAlgorithm::CollectItems() {
+  items_.clear();
+  items_.reserve(container_->child_count());
+  absolute_items_.clear();
+  items_dirty_ = false;
+
+  bool has_order = false;
+  for (LayoutNode* child = container_->first_child(); child;
+       child = child->next()) {
+    const CSSStyle* child_style = child->css_style();
+    if (child_style->display() == kDisplayNone) {
+      child->UpdateMeasureWithDisplayNone();
+    } else if (child_style->position() != kPositionRelative) {
+      absolute_items_.push_back(child);
+    } else {
+      has_order = has_order || child_style->order() != 0;
+      items_.push_back(GridItem(child));
+    }
+  }
+  if (has_order) {
+    std::stable_sort(items_.begin(), items_.end(),
+                     [](const GridItem& item_a, const GridItem& item_b) {
+                       return item_a.item_->css_style()->order() <
+                              item_b.item_->css_style()->order();
+                     });
+  }
+}
+
+void GridLayoutAlgorithm::ResolveSizeAndMode(float width,
+                                             float height,
+                                             LayoutMode width_mode,
+                                             LayoutMode height_mode) {
+  const auto& container_padding = container_->layout_info().padding_;
+  const CSSStyle* container_style = container_->css_style();
+
+  available_width_ = width;
+  available_height_ = height;
+  if (width_mode != kLayoutModeUndefined) {
+    available_width_ = container_->ApplyWidthConstraints(width) -
+                       container_padding[kCSSDirectionLeft] -
+                       container_padding[kCSSDirectionRight] -
+                       container_style->border_left() -
+                       container_style->border_right();
+  }
+  if (height_mode != kLayoutModeUndefined) {
+    available_height_ = container_->ApplyHeightConstraints(height) -
+                        container_padding[kCSSDirectionTop] -
+                        container_padding[kCSSDirectionBottom] -
+                        container_style->border_top() -
+                        container_style->border_bottom();
+  }
+  width_mode_ = width_mode;
+  height_mode_ = height_mode;
+
+  for (GridItem& grid_item : items_) {
+    grid_item.item_->UpdateLayoutInfo(available_width_, available_height_);
+  }
+}
+
+/**
+ * part 1. place items on the grid
+ * part 2. size columns, then rows against the widths of the columns
+ * part 3. measure items in their areas
+ */
+void GridLayoutAlgorithm::Measure() {
+  PlaceItems();
+  SizeTracks(columns_, true, available_width_,
+             width_mode_ == kLayoutModeExact);
+  SizeTracks(rows_, false, available_height_,
+             height_mode_ == kLayoutModeExact);
+  MeasureItems(
+      items_, [](const GridItem&) { return true; },
+      [this](GridItem& grid_item) { MeasureItemInArea(grid_item); });
+  UpdateContainerSize();
+}
+
+/**
+ * items with a row and a column first, then items with a row, then the others
+ * row by row. auto-placement is sparse, it never goes back to fill holes.
+ * columns past the explicit ones are added before placing, rows past them
+ * while placing.
+ */
+void GridLayoutAlgorithm::PlaceItems() {
+  const CSSStyle* container_style = container_->css_style();
+  size_t column_count = container_style->grid_template_columns().count_;
+  std::vector<bool> row_definite(items_.size());
+  std::vector<bool> column_definite(items_.size());
+  for (size_t index = 0; index < items_.size(); ++index) {
+    GridItem& grid_item = items_[index];
+    const CSSStyle* item_style = grid_item.item_->css_style();
+    row_definite[index] =
+        ResolveLines(item_style->grid_row_start(), item_style->grid_row_end(),
+                     grid_item.row_, grid_item.row_span_);
+    column_definite[index] = ResolveLines(
+        item_style->grid_column_start(), item_style->grid_column_end(),
+        grid_item.column_, grid_item.column_span_);
+    size_t column_end = grid_item.column_span_ +
+                        (column_definite[index] ? grid_item.column_ : 0);
+    column_count = std::max(column_count, column_end);
+  }
+  CreateTracks(columns_, container_style->grid_template_columns(),
+               column_count);
+  rows_.clear();
+  occupied_.clear();
+
+  for (size_t index = 0; index < items_.size(); ++index) {
+    if (row_definite[index] && column_definite[index]) {
+      OccupyArea(items_[index]);
+    }
+  }
+
+  // each row keeps where its last item of this step ended
+  std::vector<size_t> row_cursors;
+  for (size_t index = 0; index < items_.size(); ++index) {
+    if (!row_definite[index] || column_definite[index]) {
+      continue;
+    }
+    GridItem& grid_item = items_[index];
+    row_cursors.resize(std::max(row_cursors.size(), grid_item.row_ + 1), 0);
+    size_t column = row_cursors[grid_item.row_];
+    while (column + grid_item.column_span_ <= column_count &&
+           !IsAreaFree(grid_item.row_, column, grid_item.row_span_,
+                       grid_item.column_span_)) {
+      ++column;
+    }
+    // no room left, the item overflows the row past the last column
+    if (column + grid_item.column_span_ > column_count) {
+      column = 0;
+    }
+    grid_item.column_ = column;
+    row_cursors[grid_item.row_] = column + grid_item.column_span_;
+    OccupyArea(grid_item);
+  }
+
+  size_t cursor_row = 0;
+  size_t cursor_column = 0;
+  for (size_t index = 0; index < items_.size(); ++index) {
+    if (row_definite[index]) {
+      continue;
+    }
+    GridItem& grid_item = items_[index];
+    if (column_definite[index]) {
+      if (grid_item.column_ < cursor_column) {
+        ++cursor_row;
+      }
+      cursor_column = grid_item.column_;
+      while (!IsAreaFree(cursor_row, cursor_column, grid_item.row_span_,
+                         grid_item.column_span_)) {
+        ++cursor_row;
+      }
+    } else {
+      while (cursor_column + grid_item.column_span_ > column_count ||
+             !IsAreaFree(cursor_row, cursor_column, grid_item.row_span_,
+                         grid_item.column_span_)) {
+        if (cursor_column + grid_item.column_span_ >= column_count) {
+          ++cursor_row;
+          cursor_column = 0;
+        } else {
+          ++cursor_column;
+        }
+      }
+      grid_item.column_ = cursor_column;
+      cursor_column += grid_item.column_span_;
+    }
+    grid_item.row_ = cursor_row;
+    OccupyArea(grid_item);
+  }
+
+  size_t row_count = occupied_.size();
+  for (const GridItem& grid_item : items_) {
+    row_count = std::max(row_count, grid_item.row_ + grid_item.row_span_);
+  }
+  CreateTracks(rows_, container_style->grid_template_rows(), row_count);
+}
+
+bool GridLayoutAlgorithm::IsAreaFree(size_t row,
+                                     size_t column,
+                                     size_t row_span,
+                                     size_t column_span) const {
+  size_t column_end = std::min(column + column_span, columns_.size());
+  for (size_t r = row; r < row + row_span && r < occupied_.size(); ++r) {
+    for (const ColumnRange& range : occupied_[r]) {
+      if (range.first < column_end && column < range.second) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void GridLayoutAlgorithm::OccupyArea(const GridItem& grid_item) {
+  size_t row_end = grid_item.row_ + grid_item.row_span_;
+  ColumnRange range(grid_item.column_,
+                    std::min(grid_item.column_ + grid_item.column_span_,
+                             columns_.size()));
+  if (range.first >= range.second) {
+    return;
+  }
+  occupied_.resize(std::max(occupied_.size(), row_end));
+  for (size_t r = grid_item.row_; r < row_end; ++r) {
+    occupied_[r].push_back(range);
+  }
+}
+
+// explicit tracks of the template, then auto ones up to `count`
+void GridLayoutAlgorithm::CreateTracks(std::vector<GridTrack>& tracks,
+                                       const GridTrackList& template_tracks,
+                                       size_t count) {
+  tracks.clear();
+  for (size_t index = 0; index < std::max(count, template_tracks.count_);
+       ++index) {
+    tracks.push_back(GridTrack(index < template_tracks.count_
+                                   ? template_tracks.tracks_[index]
+                                   : GridTrackSize()));
+  }
+}
+
+// whether tracks spanned by an item are sized by its content
+bool GridLayoutAlgorithm::DependsOnContent(const std::vector<GridTrack>& tracks,
+                                           size_t start,
+                                           size_t span,
+                                           bool definite) const {
+  for (size_t index = start; index < start + span; ++index) {
+    GridTrackType type = tracks[index].size_.type_;
+    if (type == kGridTrackAuto ||
+        (type == kGridTrackFraction && !definite)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void GridLayoutAlgorithm::MeasureOuterWidth(GridItem& grid_item) {
+  LayoutNode* item = grid_item.item_;
+  const Length& width = item->css_style()->width();
+  float border_box_width;
+  if (width.type() == base::kLengthFixed) {
+    border_box_width = width.value();
+  } else {
+    border_box_width =
+        item->UpdateMeasure(.0f, .0f, kLayoutModeUndefined,
+                            kLayoutModeUndefined)
+            .width_;
+  }
+  grid_item.outer_width_ =
+      item->ApplyWidthConstraints(border_box_width) + MarginSize(item, true);
+}
+
+/**
+ * the width of the item in its area is known once columns are sized, the
+ * final measure of the item asks for the same one and is answered from cache
+ */
+void GridLayoutAlgorithm::MeasureOuterHeight(GridItem& grid_item) {
+  LayoutNode* item = grid_item.item_;
+  const CSSStyle* item_style = item->css_style();
+  float border_box_height;
+  if (item_style->height().type() == base::kLengthFixed) {
+    border_box_height = item_style->height().value();
+  } else {
+    float area_width =
+        AreaSize(columns_, grid_item.column_, grid_item.column_span_);
+    float width = item_style->width().IsAuto()
+                      ? area_width - MarginSize(item, true)
+                      : item_style->width().GetComputedValue(area_width);
+    border_box_height =
+        item->UpdateMeasure(item->ApplyWidthConstraints(width), .0f,
+                            kLayoutModeExact, kLayoutModeUndefined)
+            .height_;
+  }
+  grid_item.outer_height_ =
+      item->ApplyHeightConstraints(border_box_height) + MarginSize(item, false);
+}
+
+/**
+ * fixed tracks take their size. auto tracks grow to the items spanning only
+ * them, then share what items spanning several of them still lack. `fr`
+ * tracks share the space left when it is definite, else grow to their items
+ * in proportion to their factors. auto tracks stretch into space left over
+ * without `fr` tracks.
+ */
+void GridLayoutAlgorithm::SizeTracks(std::vector<GridTrack>& tracks,
+                                     bool horizontal,
+                                     float available_size,
+                                     bool definite) {
+  auto start = [horizontal](const GridItem& grid_item) {
+    return horizontal ? grid_item.column_ : grid_item.row_;
+  };
+  auto span = [horizontal](const GridItem& grid_item) {
+    return horizontal ? grid_item.column_span_ : grid_item.row_span_;
+  };
+  auto outer_size = [horizontal](const GridItem& grid_item) {
+    return horizontal ? grid_item.outer_width_ : grid_item.outer_height_;
+  };
+  auto needs_measure = [&](const GridItem& grid_item) {
+    return DependsOnContent(tracks, start(grid_item), span(grid_item),
+                            definite);
+  };
+  if (horizontal) {
+    MeasureItems(items_, needs_measure,
+                 [this](GridItem& grid_item) { MeasureOuterWidth(grid_item); });
+  } else {
+    MeasureItems(
+        items_, needs_measure,
+        [this](GridItem& grid_item) { MeasureOuterHeight(grid_item); });
+  }
+
+  float fraction_sum = .0f;
+  size_t auto_count = 0;
+  for (GridTrack& track : tracks) {
+    track.base_size_ =
+        track.size_.type_ == kGridTrackFixed ? track.size_.value_ : .0f;
+    if (track.size_.type_ == kGridTrackFraction) {
+      fraction_sum += track.size_.value_;
+    } else if (track.size_.type_ == kGridTrackAuto) {
+      ++auto_count;
+    }
+  }
+
+  // size of one `fr` when the space is not definite
+  float fraction_unit = .0f;
+  for (size_t pass = 0; pass < 2; ++pass) {
+    for (const GridItem& grid_item : items_) {
+      if (!needs_measure(grid_item) || (span(grid_item) == 1) != (pass == 0)) {
+        continue;
+      }
+      float lacking_size = outer_size(grid_item);
+      float item_fraction_sum = .0f;
+      size_t item_auto_count = 0;
+      for (size_t index = start(grid_item);
+           index < start(grid_item) + span(grid_item); ++index) {
+        lacking_size -= tracks[index].base_size_;
+        if (tracks[index].size_.type_ == kGridTrackFraction) {
+          item_fraction_sum += tracks[index].size_.value_;
+        } else if (tracks[index].size_.type_ == kGridTrackAuto) {
+          ++item_auto_count;
+        }
+      }
+      if (lacking_size <= 0) {
+        continue;
+      }
+      if (item_fraction_sum > 0) {
+        if (!definite) {
+          fraction_unit = std::max(
+              fraction_unit, lacking_size / std::max(item_fraction_sum, 1.f));
+        }
+        continue;
+      }
+      for (size_t index = start(grid_item);
+           index < start(grid_item) + span(grid_item); ++index) {
+        if (tracks[index].size_.type_ == kGridTrackAuto) {
+          tracks[index].base_size_ += lacking_size / item_auto_count;
+        }
+      }
+    }
+  }
+
+  float used_size = .0f;
+  for (const GridTrack& track : tracks) {
+    used_size += track.base_size_;
+  }
+  if (definite && fraction_sum > 0) {
+    fraction_unit =
+        std::max(available_size - used_size, .0f) / std::max(fraction_sum, 1.f);
+  } else if (definite && auto_count > 0 && available_size > used_size) {
+    float stretch = (available_size - used_size) / auto_count;
+    for (GridTrack& track : tracks) {
+      if (track.size_.type_ == kGridTrackAuto) {
+        track.base_size_ += stretch;
+      }
+    }
+  }
+
+  float offset = .0f;
+  for (GridTrack& track : tracks) {
+    if (track.size_.type_ == kGridTrackFraction) {
+      track.base_size_ = fraction_unit * track.size_.value_;
+    }
+    track.offset_ = offset;
+    offset += track.base_size_;
+  }
+}
+
+float GridLayoutAlgorithm::AreaSize(const std::vector<GridTrack>& tracks,
+                                    size_t start,
+                                    size_t span) const {
+  const GridTrack& last = tracks[start + span - 1];
+  return last.offset_ + last.base_size_ - tracks[start].offset_;
+}
+
+/**
+ * auto sizes stretch to the area, across rows only with `align-self:
+ * stretch`. content heights are clamped after measuring, and measured again
+ * if the clamp changes them.
+ */
+void GridLayoutAlgorithm::MeasureItemInArea(GridItem& grid_item) {
+  LayoutNode* item = grid_item.item_;
+  const CSSStyle* item_style = item->css_style();
+  float area_width =
+      AreaSize(columns_, grid_item.column_, grid_item.column_span_);
+  float area_height = AreaSize(rows_, grid_item.row_, grid_item.row_span_);
+
+  float width = item_style->width().IsAuto()
+                    ? area_width - MarginSize(item, true)
+                    : item_style->width().GetComputedValue(area_width);
+  width = item->ApplyWidthConstraints(width);
+
+  float height = .0f;
+  LayoutMode height_mode = kLayoutModeUndefined;
+  if (!item_style->height().IsAuto()) {
+    height = item_style->height().GetComputedValue(area_height);
+    height_mode = kLayoutModeExact;
+  } else if (AlignSelf(container_, item) == kAlignItemsStretch) {
+    height = item->ApplyHeightConstraints(area_height - MarginSize(item, false));
+    height_mode = kLayoutModeExact;
+  }
+
+  FloatSize size =
+      item->UpdateMeasure(width, height, kLayoutModeExact, height_mode);
+  if (height_mode == kLayoutModeUndefined) {
+    float clamped_height = item->ApplyHeightConstraints(size.height_);
+    if (clamped_height != size.height_) {
+      item->UpdateMeasure(width, clamped_height, kLayoutModeExact,
+                          kLayoutModeExact);
+    }
+  }
+}
+
+void GridLayoutAlgorithm::UpdateContainerSize() {
+  float columns_size =
+      columns_.empty() ? .0f
+                       : columns_.back().offset_ + columns_.back().base_size_;
+  float rows_size =
+      rows_.empty() ? .0f : rows_.back().offset_ + rows_.back().base_size_;
+  if (width_mode_ == kLayoutModeUndefined) {
+    available_width_ = columns_size;
+  } else if (width_mode_ == kLayoutModeAtMost) {
+    available_width_ = std::max(columns_size, available_width_);
+  }
+  if (height_mode_ == kLayoutModeUndefined) {
+    available_height_ = rows_size;
+  } else if (height_mode_ == kLayoutModeAtMost) {
+    available_height_ = std::max(rows_size, available_height_);
+  }
+
+  const auto& container_padding = container_->layout_info().padding_;
+  const CSSStyle* container_style = container_->css_style();
+  container_->SetOffsetWidth(available_width_ +
+                             container_padding[kCSSDirectionLeft] +
+                             container_padding[kCSSDirectionRight] +
+                             container_style->border_left() +
+                             container_style->border_right());
+  container_->SetOffsetHeight(available_height_ +
+                              container_padding[kCSSDirectionTop] +
+                              container_padding[kCSSDirectionBottom] +
+                              container_style->border_top() +
+                              container_style->border_bottom());
+}
+
+/**
+ * items start at their area, `align-self` moves them across rows
+ */
+void GridLayoutAlgorithm::Alignment() {
+  const auto& container_padding = container_->layout_info().padding_;
+  for (const GridItem& grid_item : items_) {
+    LayoutNode* item = grid_item.item_;
+    const float* margin = item->layout_info().margin_;
+    float offset_left = container_padding[kCSSDirectionLeft] +
+                        columns_[grid_item.column_].offset_ +
+                        margin[kCSSDirectionLeft];
+    float offset_top = container_padding[kCSSDirectionTop] +
+                       rows_[grid_item.row_].offset_ + margin[kCSSDirectionTop];
+    float free_height =
+        AreaSize(rows_, grid_item.row_, grid_item.row_span_) -
+        item->offset_height() - MarginSize(item, false);
+    AlignItemsType align = AlignSelf(container_, item);
+    if (align == kAlignItemsCenter) {
+      offset_top += free_height / 2;
+    } else if (align == kAlignItemsFlexEnd) {
+      offset_top += free_height;
+    }
+    item->SetOffsetLeft(offset_left);
+    item->SetOffsetTop(offset_top);
+  }
+  LayoutAbsoluteItems(container_, absolute_items_);
+}
+
+}  // namespace starlight
\ No newline at end of file
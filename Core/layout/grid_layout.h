@@ -0,0 +1,140 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#ifndef STARLIGHT_LAYOUT_GRID_LAYOUT_H_
+#define STARLIGHT_LAYOUT_GRID_LAYOUT_H_
+
+#include <utility>
+#include <vector>
+
+#include "layout/layout_algorithm.h"
+#include "layout/style.h"
+
+namespace starlight {
+
+struct GridItem {
+  explicit GridItem(LayoutNode* item)
+      : item_(item),
+        row_(0),
+        column_(0),
+        row_span_(1),
+        column_span_(1),
+        outer_width_(.0f),
+        outer_height_(.0f) {}
+  LayoutNode* item_;
+  // first track and number of tracks of the item's area
+  size_t row_;
+  size_t column_;
+  size_t row_span_;
+  size_t column_span_;
+  // margin box size the item asks its tracks for, only set for items whose
+  // tracks are sized by their content
+  float outer_width_;
+  float outer_height_;
+};
+
+struct GridTrack {
+  explicit GridTrack(const GridTrackSize& size)
+      : size_(size), base_size_(.0f), offset_(.0f) {}
+  GridTrackSize size_;
+  float base_size_;
+  // from the start of the container's content box
+  float offset_;
+};
+
+/**
+ * lays out `display: grid` containers: explicit tracks of
+ * `grid-template-rows` and `grid-template-columns`, implicit auto tracks for
+ * items placed past them, line based placement and sparse row-major
+ * auto-placement. tracks of one axis are sized at once from the items they
+ * hold, so an item is measured at most once per axis whose tracks depend on
+ * it, plus once in its area.
+ *
+ * `fr` tracks share the space left by the others and do not grow to the
+ * content of their items when that space is definite. items stretch to their
+ * area unless they have a size, `align-self` places them across rows.
+ */
+class GridLayoutAlgorithm : public LayoutAlgorithm {
+ public:
+  explicit GridLayoutAlgorithm(LayoutNode* container);
+  ~GridLayoutAlgorithm();
+
+  virtual void Initialize(float width,
+                          float height,
+                          LayoutMode width_mode,
+                          LayoutMode height_mode);
+
+  virtual void Update(float width,
+                      float height,
+                      LayoutMode width_mode,
+                      LayoutMode height_mode);
+
+  virtual void Measure();
+
+  virtual void Alignment();
+
+  virtual void OnChildInserted(LayoutNode* child);
+
+  virtual void OnChildRemoved(LayoutNode* child);
+
+ private:
+  typedef std::pair<size_t, size_t> ColumnRange;
+
+  void CollectItems();
+  void ResolveSizeAndMode(float width,
+                          float height,
+                          LayoutMode width_mode,
+                          LayoutMode height_mode);
+
+  // placement
+  void PlaceItems();
+  bool IsAreaFree(size_t row,
+                  size_t column,
+                  size_t row_span,
+                  size_t column_span) const;
+  void OccupyArea(const GridItem& grid_item);
+
+  // track sizing
+  void CreateTracks(std::vector<GridTrack>& tracks,
+                    const GridTrackList& template_tracks,
+                    size_t count);
+  bool DependsOnContent(const std::vector<GridTrack>& tracks,
+                        size_t start,
+                        size_t span,
+                        bool definite) const;
+  void MeasureOuterWidth(GridItem& grid_item);
+  void MeasureOuterHeight(GridItem& grid_item);
+  void SizeTracks(std::vector<GridTrack>& tracks,
+                  bool horizontal,
+                  float available_size,
+                  bool definite);
+  float AreaSize(const std::vector<GridTrack>& tracks,
+                 size_t start,
+                 size_t span) const;
+  void MeasureItemInArea(GridItem& grid_item);
+  void UpdateContainerSize();
+
+  // styles are shared and replaced on change, always read the current one
+  // from the container
+  LayoutNode* container_;
+
+  // content box
+  float available_width_;
+  float available_height_;
+  LayoutMode width_mode_;
+  LayoutMode height_mode_;
+
+  std::vector<GridItem> items_;
+  std::vector<LayoutNode*> absolute_items_;
+  // item lists have to be collected again from the children on next update
+  bool items_dirty_;
+
+  std::vector<GridTrack> rows_;
+  std::vector<GridTrack> columns_;
+  // columns taken by placed items, for each row the [start, end) ranges of
+  // its items. a row costs its ranges rather than a cell per column
+  std::vector<std::vector<ColumnRange>> occupied_;
+};
+
+}  // namespace starlight
+
+#endif
\ No newline at end of file
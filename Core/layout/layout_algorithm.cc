@@ -0,0 +1,120 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include "layout/layout_algorithm.h"
+#include "layout/layout_node.h"
+#include "layout/style.h"
+
+namespace starlight {
+
+void LayoutAlgorithm::LayoutAbsoluteItems(
+    LayoutNode* container,
+    const std::vector<LayoutNode*>& items) {
+  if (items.empty()) {
+    return;
+  }
+  const CSSStyle* container_style = container->css_style();
+  float padding_box_width = container->offset_width() -
+                            container_style->border_left() -
+                            container_style->border_right();
+  float padding_box_height = container->offset_height() -
+                             container_style->border_top() -
+                             container_style->border_bottom();
+  for (LayoutNode* item : items) {
+    LayoutAbsoluteItem(container, item, padding_box_width, padding_box_height);
+  }
+}
+
+/**
+ * a size is taken from the style, or stretched between two insets, or from
+ * the content. an item is placed by its start inset, else by its end inset,
+ * else at its static position.
+ */
+void LayoutAlgorithm::LayoutAbsoluteItem(LayoutNode* container,
+                                         LayoutNode* item,
+                                         float padding_box_width,
+                                         float padding_box_height) {
+  item->UpdateLayoutInfo(padding_box_width, padding_box_height);
+  const CSSStyle* item_style = item->css_style();
+  const float* margin = item->layout_info().margin_;
+  const Length& left = item_style->left();
+  const Length& right = item_style->right();
+  const Length& top = item_style->top();
+  const Length& bottom = item_style->bottom();
+
+  float width = .0f;
+  LayoutMode width_mode = kLayoutModeUndefined;
+  if (!item_style->width().IsAuto()) {
+    width = item_style->width().GetComputedValue(padding_box_width);
+    width_mode = kLayoutModeExact;
+  } else if (!left.IsAuto() && !right.IsAuto()) {
+    width = padding_box_width - left.GetComputedValue(padding_box_width) -
+            right.GetComputedValue(padding_box_width) -
+            margin[kCSSDirectionLeft] - margin[kCSSDirectionRight];
+    width_mode = kLayoutModeExact;
+  }
+  float height = .0f;
+  LayoutMode height_mode = kLayoutModeUndefined;
+  if (!item_style->height().IsAuto()) {
+    height = item_style->height().GetComputedValue(padding_box_height);
+    height_mode = kLayoutModeExact;
+  } else if (!top.IsAuto() && !bottom.IsAuto()) {
+    height = padding_box_height - top.GetComputedValue(padding_box_height) -
+             bottom.GetComputedValue(padding_box_height) -
+             margin[kCSSDirectionTop] - margin[kCSSDirectionBottom];
+    height_mode = kLayoutModeExact;
+  }
+
+  FloatSize size = item->UpdateMeasure(width, height, width_mode, height_mode);
+  // exact sizes are clamped by the item itself, content sizes are not
+  if (width_mode == kLayoutModeUndefined) {
+    float clamped_width = item->ApplyWidthConstraints(size.width_);
+    if (clamped_width != size.width_) {
+      width = clamped_width;
+      width_mode = kLayoutModeExact;
+      size = item->UpdateMeasure(width, height, width_mode, height_mode);
+    }
+  }
+  if (height_mode == kLayoutModeUndefined) {
+    float clamped_height = item->ApplyHeightConstraints(size.height_);
+    if (clamped_height != size.height_) {
+      size = item->UpdateMeasure(width, clamped_height, width_mode,
+                                 kLayoutModeExact);
+    }
+  }
+
+  float offset_left;
+  if (!left.IsAuto()) {
+    offset_left =
+        left.GetComputedValue(padding_box_width) + margin[kCSSDirectionLeft];
+  } else if (!right.IsAuto()) {
+    offset_left = padding_box_width -
+                  right.GetComputedValue(padding_box_width) -
+                  margin[kCSSDirectionRight] - size.width_;
+  } else {
+    offset_left = StaticPosition(container, item, true, size.width_);
+  }
+  float offset_top;
+  if (!top.IsAuto()) {
+    offset_top =
+        top.GetComputedValue(padding_box_height) + margin[kCSSDirectionTop];
+  } else if (!bottom.IsAuto()) {
+    offset_top = padding_box_height -
+                 bottom.GetComputedValue(padding_box_height) -
+                 margin[kCSSDirectionBottom] - size.height_;
+  } else {
+    offset_top = StaticPosition(container, item, false, size.height_);
+  }
+  item->SetOffsetLeft(offset_left);
+  item->SetOffsetTop(offset_top);
+}
+
+float LayoutAlgorithm::StaticPosition(LayoutNode* container,
+                                      LayoutNode* item,
+                                      bool horizontal,
+                                      float size) const {
+  size_t front = horizontal ? kCSSDirectionLeft : kCSSDirectionTop;
+  return container->layout_info().padding_[front] +
+         item->layout_info().margin_[front];
+}
+
+}  // namespace starlight
\ No newline at end of file
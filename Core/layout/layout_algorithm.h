@@ -3,10 +3,15 @@
 #ifndef STARLIGHT_LAYOUT_LAYOUT_ALGORITHM_H_
 #define STARLIGHT_LAYOUT_LAYOUT_ALGORITHM_H_
 
+#include <cstddef>
+#include <vector>
+
 #include "layout/layout_enum.h"
 
 namespace starlight {
 
+class LayoutNode;
+
 class LayoutAlgorithm {
  public:
   LayoutAlgorithm() {}
@@ -26,7 +31,37 @@ class LayoutAlgorithm {
 
   virtual void Alignment() {}
 
+  // child list of the container changed after initialization
+  virtual void OnChildInserted(LayoutNode* child) {}
+
+  virtual void OnChildRemoved(LayoutNode* child) {}
+
+  // children before it kept their layout through the last measure and
+  // alignment, null if any of them may have changed
+  virtual LayoutNode* FirstChangedChild() const { return nullptr; }
+
  protected:
+  /**
+   * out-of-flow children take no part in the layout of the others, they are
+   * sized and placed against the padding box of `container` once it has its
+   * size. their offsets are relative to the padding box as those of the
+   * others.
+   */
+  void LayoutAbsoluteItems(LayoutNode* container,
+                           const std::vector<LayoutNode*>& items);
+
+  // offset of an out-of-flow item along an axis on which both its insets are
+  // auto, `size` is its border box size. the start of the content box here
+  virtual float StaticPosition(LayoutNode* container,
+                               LayoutNode* item,
+                               bool horizontal,
+                               float size) const;
+
+ private:
+  void LayoutAbsoluteItem(LayoutNode* container,
+                          LayoutNode* item,
+                          float padding_box_width,
+                          float padding_box_height);
 };
 
 }  // namespace starlight
@@ -0,0 +1,40 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include "layout/layout_batch.h"
+#include "base/thread_pool.h"
+
+#include <algorithm>
+
+namespace starlight {
+
+namespace {
+
+// chunks per thread, enough to even out roots of different cost
+const size_t kChunksPerThread = 8;
+
+}  // namespace
+
+/**
+ * roots are handed to the pool in chunks, a single small root costs less to
+ * lay out than to queue
+ */
+void LayoutBatch(const LayoutRequest* requests,
+                 size_t count,
+                 base::ThreadPool* thread_pool) {
+  base::ThreadPool::Scope scope(thread_pool);
+  size_t thread_count = thread_pool ? thread_pool->thread_count() + 1 : 1;
+  size_t chunk_size =
+      std::max<size_t>(1, count / (thread_count * kChunksPerThread));
+  base::TaskGroup chunks(thread_pool);
+  for (size_t begin = 0; begin < count; begin += chunk_size) {
+    size_t end = std::min(begin + chunk_size, count);
+    chunks.Run([requests, begin, end] {
+      for (size_t i = begin; i < end; ++i) {
+        requests[i].root_->ReLayout(requests[i].constraints_);
+      }
+    });
+  }
+  chunks.Wait();
+}
+
+}  // namespace starlight
\ No newline at end of file
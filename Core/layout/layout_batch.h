@@ -0,0 +1,35 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#ifndef STARLIGHT_LAYOUT_LAYOUT_BATCH_H_
+#define STARLIGHT_LAYOUT_LAYOUT_BATCH_H_
+
+#include <cstddef>
+
+#include "layout/layout_node.h"
+
+namespace base {
+class ThreadPool;
+}
+
+namespace starlight {
+
+// a root to lay out and the constraints it is laid out with
+struct LayoutRequest {
+  LayoutRequest(LayoutNode* root, const LayoutConstraints& constraints)
+      : root_(root), constraints_(constraints) {}
+  LayoutNode* root_;
+  LayoutConstraints constraints_;
+};
+
+/**
+ * lays out `count` independent roots in one call, spread over the threads of
+ * `thread_pool` if there is one. roots must not share nodes. roots may belong
+ * to the same context as long as no style changes during the call.
+ */
+void LayoutBatch(const LayoutRequest* requests,
+                 size_t count,
+                 base::ThreadPool* thread_pool);
+
+}  // namespace starlight
+
+#endif
\ No newline at end of file
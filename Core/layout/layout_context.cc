@@ -0,0 +1,96 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include "layout/layout_context.h"
+#include "layout/style.h"
+
+namespace starlight {
+
+namespace {
+
+// unreferenced styles kept for reuse before they get purged
+const size_t kMaxUnusedStyles = 256;
+
+}  // namespace
+
+size_t LayoutContext::StylePtrHash::operator()(const CSSStyle* style) const {
+  return style->Hash();
+}
+
+bool LayoutContext::StylePtrEqual::operator()(const CSSStyle* lhs,
+                                              const CSSStyle* rhs) const {
+  return *lhs == *rhs;
+}
+
+LayoutContext::LayoutContext()
+    : unused_style_count_(0),
+      default_style_(nullptr),
+      flex_resolution_(kFlexResolutionAdaptive),
+      flex_fast_paths_(true) {
+  default_style_ = InternStyle(CSSStyle());
+}
+
+/**
+ * styles still referenced by nodes are freed as well, trees and style sheets
+ * of the context must be gone by now
+ */
+LayoutContext::~LayoutContext() {
+  for (CSSStyle* style : styles_) {
+    delete style;
+  }
+}
+
+LayoutContext* LayoutContext::Default() {
+  static LayoutContext* context = new LayoutContext();
+  return context;
+}
+
+int LayoutContext::RegisterFont(const FontMetrics& font) {
+  fonts_.push_back(font);
+  return static_cast<int>(fonts_.size() - 1);
+}
+
+const FontMetrics* LayoutContext::font(int id) const {
+  return id >= 0 && static_cast<size_t>(id) < fonts_.size() ? &fonts_[id]
+                                                            : nullptr;
+}
+
+const CSSStyle* LayoutContext::InternStyle(const CSSStyle& style) {
+  CSSStyle* key = const_cast<CSSStyle*>(&style);
+  auto iter = styles_.find(key);
+  CSSStyle* shared = nullptr;
+  if (iter != styles_.end()) {
+    shared = *iter;
+    if (shared->ref_count_ == 0) {
+      --unused_style_count_;
+    }
+  } else {
+    shared = new CSSStyle(style);
+    shared->ref_count_ = 0;
+    styles_.insert(shared);
+  }
+  shared->Retain();
+  return shared;
+}
+
+void LayoutContext::ReleaseStyle(const CSSStyle* style) {
+  if (!style->Release()) {
+    return;
+  }
+  if (++unused_style_count_ > kMaxUnusedStyles) {
+    PurgeUnusedStyles();
+  }
+}
+
+void LayoutContext::PurgeUnusedStyles() {
+  for (auto iter = styles_.begin(); iter != styles_.end();) {
+    if ((*iter)->ref_count_ == 0) {
+      delete *iter;
+      iter = styles_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  unused_style_count_ = 0;
+}
+
+}  // namespace starlight
\ No newline at end of file
@@ -0,0 +1,87 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#ifndef STARLIGHT_LAYOUT_LAYOUT_CONTEXT_H_
+#define STARLIGHT_LAYOUT_LAYOUT_CONTEXT_H_
+
+#include <cstddef>
+#include <unordered_set>
+#include <vector>
+
+#include "layout/layout_enum.h"
+#include "layout/text_layout.h"
+
+namespace starlight {
+
+class CSSStyle;
+
+/**
+ * owns configuration and caches shared by the nodes of the trees bound to it,
+ * there is no state shared between contexts. a context and its trees are not
+ * synchronized: they are used from one thread at a time, while trees of
+ * distinct contexts can be laid out on separate threads without locking.
+ * a context has to outlive its trees and style sheets.
+ */
+class LayoutContext {
+ public:
+  LayoutContext();
+  ~LayoutContext();
+  LayoutContext(const LayoutContext&) = delete;
+  LayoutContext& operator=(const LayoutContext&) = delete;
+
+  /**
+   * context of nodes and trees created without one. never destroyed, nodes
+   * may release styles during static destruction. it is one context like any
+   * other, so all of those trees belong to one thread at a time: trees laid
+   * out concurrently have to be created with a context per thread.
+   */
+  static LayoutContext* Default();
+
+  // shared instance with all default values, never released
+  const CSSStyle* default_style() const { return default_style_; }
+
+  // shared instance equal to `style`, with one more reference
+  const CSSStyle* InternStyle(const CSSStyle& style);
+  // drops one reference, styles without references are kept for reuse until
+  // too many of them pile up
+  void ReleaseStyle(const CSSStyle* style);
+  void PurgeUnusedStyles();
+
+  // adaptive by default
+  FlexResolution flex_resolution() const { return flex_resolution_; }
+  void SetFlexResolution(FlexResolution flex_resolution) {
+    flex_resolution_ = flex_resolution;
+  }
+  // flex lines whose sizes follow in closed form skip the spec loop, on by
+  // default. turned off, every line runs it, e.g. to compare results
+  bool flex_fast_paths() const { return flex_fast_paths_; }
+  void SetFlexFastPaths(bool flex_fast_paths) {
+    flex_fast_paths_ = flex_fast_paths;
+  }
+
+  // id of `font` for LayoutNode::SetText, fonts are kept as long as the
+  // context
+  int RegisterFont(const FontMetrics& font);
+  // null for ids never returned by RegisterFont
+  const FontMetrics* font(int id) const;
+
+ private:
+  struct StylePtrHash {
+    size_t operator()(const CSSStyle* style) const;
+  };
+  struct StylePtrEqual {
+    bool operator()(const CSSStyle* lhs, const CSSStyle* rhs) const;
+  };
+
+  std::unordered_set<CSSStyle*, StylePtrHash, StylePtrEqual> styles_;
+  size_t unused_style_count_;
+  const CSSStyle* default_style_;
+
+  FlexResolution flex_resolution_;
+  bool flex_fast_paths_;
+
+  std::vector<FontMetrics> fonts_;
+};
+
+}  // namespace starlight
+
+#endif
\ No newline at end of file
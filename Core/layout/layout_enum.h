@@ -94,6 +94,97 @@ enum AlignContentType {
   kAlignContentStretch
 };
 
+/**
+ * how a grid track is sized.
+ * Fixed: a length in pixels;
+ * Fraction: a share of the space left by the other tracks, `fr`;
+ * Auto: by the items in the track.
+ */
+enum GridTrackType { kGridTrackFixed, kGridTrackFraction, kGridTrackAuto };
+
+/**
+ * what a style change affects, ordered from least to most layout work.
+ * Alignment: only positions of the node or its children move;
+ * SelfSize: the parent sizes the node differently;
+ * ChildrenSize: the node lays out its children differently.
+ */
+enum StyleChangeType {
+  kStyleChangeNone,
+  kStyleChangeAlignment,
+  kStyleChangeSelfSize,
+  kStyleChangeChildrenSize
+};
+
+// changes of several properties are collected as a bit set of StyleChangeType
+inline unsigned StyleChangeBit(StyleChangeType change) {
+  return change == kStyleChangeNone ? 0u : 1u << change;
+}
+
+/**
+ * how the flexible lengths of a flex line get resolved, all give the same
+ * results.
+ * Loop: rounds of the spec algorithm, each visits every item of the line;
+ * Adaptive: the loop, lines still freezing items after as many rounds as
+ * sorting them would cost switch to the sweep;
+ * Sweep: rounds run on items ordered by their clamp thresholds.
+ */
+enum FlexResolution {
+  kFlexResolutionLoop,
+  kFlexResolutionAdaptive,
+  kFlexResolutionSweep
+};
+
+/**
+ * properties which can be set with parsed values. shorthands of four sides
+ * set all of them to the same value.
+ */
+enum StyleProperty {
+  kStylePropertyWidth,
+  kStylePropertyHeight,
+  kStylePropertyMinWidth,
+  kStylePropertyMinHeight,
+  kStylePropertyMaxWidth,
+  kStylePropertyMaxHeight,
+  kStylePropertyPadding,
+  kStylePropertyPaddingTop,
+  kStylePropertyPaddingLeft,
+  kStylePropertyPaddingBottom,
+  kStylePropertyPaddingRight,
+  kStylePropertyMargin,
+  kStylePropertyMarginTop,
+  kStylePropertyMarginLeft,
+  kStylePropertyMarginBottom,
+  kStylePropertyMarginRight,
+  kStylePropertyBorder,
+  kStylePropertyBorderTop,
+  kStylePropertyBorderLeft,
+  kStylePropertyBorderBottom,
+  kStylePropertyBorderRight,
+  kStylePropertyPosition,
+  kStylePropertyTop,
+  kStylePropertyLeft,
+  kStylePropertyBottom,
+  kStylePropertyRight,
+  kStylePropertyDisplay,
+  kStylePropertyFlex,
+  kStylePropertyFlexBasis,
+  kStylePropertyFlexGrow,
+  kStylePropertyFlexShrink,
+  kStylePropertyFlexDirection,
+  kStylePropertyFlexWrap,
+  kStylePropertyJustifyContent,
+  kStylePropertyAlignItems,
+  kStylePropertyAlignSelf,
+  kStylePropertyAlignContent,
+  kStylePropertyOrder,
+  kStylePropertyGridTemplateRows,
+  kStylePropertyGridTemplateColumns,
+  kStylePropertyGridRowStart,
+  kStylePropertyGridRowEnd,
+  kStylePropertyGridColumnStart,
+  kStylePropertyGridColumnEnd
+};
+
 #ifdef __cplusplus
 }
 #endif
@@ -2,30 +2,82 @@
 
 #include "layout/layout_node.h"
 #include "layout/flex_layout.h"
+#include "layout/grid_layout.h"
 #include "layout/layout_algorithm.h"
+#include "layout/layout_context.h"
+#include "layout/layout_tree.h"
 #include "layout/style.h"
+#include "layout/style_sheet.h"
+#include "layout/text_layout.h"
+#include "base/thread_pool.h"
 
+#include <algorithm>
 #include <iostream>
 
 namespace starlight {
 
-LayoutNode::LayoutNode()
-    : parent_(nullptr),
+namespace {
+
+// returns whether the resolved value differs from the previous one
+inline bool UpdateResolvedValue(float& resolved, float value) {
+  if (resolved == value) {
+    return false;
+  }
+  resolved = value;
+  return true;
+}
+
+// out-of-flow nodes are laid out by their parent's alignment, which measures
+// nothing else
+inline bool IsOutOfFlow(const CSSStyle* css_style) {
+  return css_style->position() != kPositionRelative;
+}
+
+}  // namespace
+
+LayoutNode::LayoutNode() : LayoutNode(nullptr, LayoutContext::Default()) {}
+
+LayoutNode::LayoutNode(LayoutContext* layout_context)
+    : LayoutNode(nullptr, layout_context) {}
+
+LayoutNode::LayoutNode(LayoutTree* tree, LayoutContext* layout_context)
+    : tree_(tree),
+      layout_context_(layout_context),
+      parent_(nullptr),
       prev_(nullptr),
       next_(nullptr),
       first_child_(nullptr),
       last_child_(nullptr),
       child_count_(0),
       dirty_(false),
-      css_style_(std::make_unique<CSSStyle>()),
+      needs_alignment_(true),
+      children_appended_only_(false),
+      first_appended_child_(nullptr),
+      css_style_(layout_context->default_style()),
       layout_algorithm_(nullptr),
+      measure_func_(nullptr),
+      text_layout_(nullptr),
       layout_info_(LayoutInfo()),
+      measured_constraints_(.0f,
+                            .0f,
+                            kLayoutModeUndefined,
+                            kLayoutModeUndefined),
+      requested_constraints_(.0f,
+                             .0f,
+                             kLayoutModeUndefined,
+                             kLayoutModeUndefined),
       offset_top_(.0f),
       offset_left_(.0f),
       offset_width_(.0f),
-      offset_height_(.0f) {}
+      offset_height_(.0f) {
+  css_style_->Retain();
+}
 
-LayoutNode::~LayoutNode() {}
+LayoutNode::~LayoutNode() {
+  delete layout_algorithm_;
+  delete text_layout_;
+  layout_context_->ReleaseStyle(css_style_);
+}
 
 LayoutNode* LayoutNode::FindNode(int index) {
   if (index == 0) {
@@ -55,7 +107,14 @@ int LayoutNode::FindNode(LayoutNode* node) {
   return index;
 }
 
+/**
+ * appending to a node which is laid out, or has only been appended to since,
+ * keeps it appended only
+ */
 void LayoutNode::InsertChild(LayoutNode* child, LayoutNode* reference) {
+  bool appended_only =
+      reference == nullptr &&
+      (children_appended_only_ || (!dirty_ && !needs_alignment_));
   if (child_count_ == 0) {
     first_child_ = child;
     last_child_ = child;
@@ -79,7 +138,15 @@ void LayoutNode::InsertChild(LayoutNode* child, LayoutNode* reference) {
   child->parent_ = this;
   ++child_count_;
 
+  if (layout_algorithm_) {
+    layout_algorithm_->OnChildInserted(child);
+  }
+  bool first_appended = !children_appended_only_;
   MarkDirty();
+  children_appended_only_ = appended_only;
+  if (appended_only && first_appended) {
+    first_appended_child_ = child;
+  }
 }
 
 void LayoutNode::InsertChild(LayoutNode* child, int index) {
@@ -113,8 +180,13 @@ void LayoutNode::RemoveChild(LayoutNode* child) {
     next->prev_ = pre;
     pre->next_ = next;
   }
+  child->prev_ = nullptr;
+  child->next_ = nullptr;
   child_count_--;
 
+  if (layout_algorithm_) {
+    layout_algorithm_->OnChildRemoved(child);
+  }
   MarkDirty();
 }
 
@@ -124,44 +196,263 @@ LayoutNode* LayoutNode::RemoveChild(int index) {
   return node;
 }
 
-void LayoutNode::SetStyle(const std::string& name,
-                          const std::string& value,
+void LayoutNode::SetStyle(std::string_view name,
+                          std::string_view value,
                           bool reset) {
-  css_style_->SetStyle(name, value, reset);
-  MarkDirty();
+  CSSStyle css_style(*css_style_);
+  UpdateStyle(css_style,
+              StyleChangeBit(css_style.SetStyle(name, value, reset)));
+}
+
+bool LayoutNode::SetStyles(const StyleDeclaration* declarations,
+                           size_t count) {
+  CSSStyle css_style(*css_style_);
+  unsigned changes = 0;
+  for (size_t i = 0; i < count; ++i) {
+    changes |= StyleChangeBit(
+        css_style.SetStyle(declarations[i].name_, declarations[i].value_));
+  }
+  return UpdateStyle(css_style, changes);
+}
+
+bool LayoutNode::SetStyles(std::string_view declarations) {
+  CSSStyle css_style(*css_style_);
+  return UpdateStyle(css_style, css_style.SetStyles(declarations));
+}
+
+template <typename Value>
+void LayoutNode::UpdateStyle(StyleProperty property, Value value) {
+  CSSStyle css_style(*css_style_);
+  UpdateStyle(css_style, StyleChangeBit(css_style.SetStyle(property, value)));
+}
+
+void LayoutNode::SetStyle(StyleProperty property, const base::Length& value) {
+  UpdateStyle(property, value);
+}
+
+void LayoutNode::SetStyle(StyleProperty property, float value) {
+  UpdateStyle(property, value);
+}
+
+void LayoutNode::SetStyle(StyleProperty property, int value) {
+  UpdateStyle(property, value);
+}
+
+void LayoutNode::SetStyle(StyleProperty property, PositionType value) {
+  UpdateStyle(property, value);
+}
+
+void LayoutNode::SetStyle(StyleProperty property, DisplayType value) {
+  UpdateStyle(property, value);
+}
+
+void LayoutNode::SetStyle(StyleProperty property, FlexDirectionType value) {
+  UpdateStyle(property, value);
+}
+
+void LayoutNode::SetStyle(StyleProperty property, FlexWrapType value) {
+  UpdateStyle(property, value);
+}
+
+void LayoutNode::SetStyle(StyleProperty property, JustifyContentType value) {
+  UpdateStyle(property, value);
 }
 
+void LayoutNode::SetStyle(StyleProperty property, AlignItemsType value) {
+  UpdateStyle(property, value);
+}
+
+void LayoutNode::SetStyle(StyleProperty property, AlignSelfType value) {
+  UpdateStyle(property, value);
+}
+
+void LayoutNode::SetStyle(StyleProperty property, AlignContentType value) {
+  UpdateStyle(property, value);
+}
+
+void LayoutNode::SetStyle(StyleProperty property, const GridTrackList& value) {
+  UpdateStyle<const GridTrackList&>(property, value);
+}
+
+void LayoutNode::SetStyle(StyleProperty property, const GridLine& value) {
+  UpdateStyle<const GridLine&>(property, value);
+}
+
+/**
+ * a rule replaces all values of the current style
+ */
+bool LayoutNode::ApplyStyleRule(const StyleSheet& style_sheet, uint32_t index) {
+  const CSSStyle* rule_style = style_sheet.GetStyle(index);
+  if (rule_style == nullptr || rule_style == css_style_) {
+    return false;
+  }
+  CSSStyle css_style(*css_style_);
+  return UpdateStyle(css_style, css_style.SetAllStyles(*rule_style));
+}
+
+/**
+ * shared styles are never modified: `css_style` is a changed copy of the
+ * current style, which gets interned in place of it. ancestors are walked once
+ * for all `changes`.
+ */
+bool LayoutNode::UpdateStyle(const CSSStyle& css_style, unsigned changes) {
+  if (changes == 0) {
+    return false;
+  }
+  const CSSStyle* previous_style = css_style_;
+  css_style_ = layout_context_->InternStyle(css_style);
+  // parent classifies its children by these, let it place this node again
+  if (parent_ &&
+      (previous_style->display() != css_style_->display() ||
+       previous_style->position() != css_style_->position() ||
+       previous_style->order() != css_style_->order())) {
+    if (parent_->layout_algorithm_) {
+      parent_->layout_algorithm_->OnChildRemoved(this);
+      parent_->layout_algorithm_->OnChildInserted(this);
+    }
+    parent_->MarkDirty();
+  }
+  // children are laid out by another algorithm, created on next measure
+  if (layout_algorithm_ && previous_style->display() != css_style_->display()) {
+    delete layout_algorithm_;
+    layout_algorithm_ = nullptr;
+  }
+  bool out_of_flow = IsOutOfFlow(previous_style) && IsOutOfFlow(css_style_);
+  layout_context_->ReleaseStyle(previous_style);
+
+  // schedule only the phases the changes affect
+  if (changes & StyleChangeBit(kStyleChangeChildrenSize)) {
+    // measuring the node for real covers the other phases
+    MarkDirty();
+    return true;
+  }
+  if (changes & StyleChangeBit(kStyleChangeSelfSize)) {
+    // own measure results stay valid, the parent has to size it again. an
+    // out-of-flow node is sized by the parent's alignment alone
+    if (out_of_flow) {
+      MarkNeedsAlignment();
+    } else if (parent_) {
+      parent_->MarkDirty();
+    }
+  }
+  if (changes & StyleChangeBit(kStyleChangeAlignment)) {
+    // `align-self` moves the node inside its parent, the others move children
+    MarkNeedsAlignment();
+  }
+  return true;
+}
+
+/**
+ * cached measure results of the node and all its ancestors are dropped. walk
+ * stops at a dirty ancestor, whose own ancestors were dropped when it got
+ * dirty, or at an out-of-flow node, which its parent lays out again during
+ * alignment without being measured
+ */
 void LayoutNode::MarkDirty(const bool recursion) {
+  measure_cache_.Clear();
+  children_appended_only_ = false;
   if (!dirty()) {
     dirty_ = true;
     if (parent_ && recursion) {
-      parent_->MarkDirty();
+      if (IsOutOfFlow(css_style_)) {
+        MarkNeedsAlignment();
+      } else {
+        parent_->MarkDirty();
+      }
     }
   }
 }
 
+void LayoutNode::MarkMeasureDirty() {
+  if (tree_ && measure_func_) {
+    tree_->measure_func_cache().Erase(context_);
+  }
+  MarkDirty();
+}
+
+void LayoutNode::SetMeasureFunc(MeasureFunc measure_func) {
+  if (measure_func_ == measure_func) {
+    return;
+  }
+  measure_func_ = measure_func;
+  MarkDirty();
+}
+
+void LayoutNode::SetText(std::string_view text, int font) {
+  delete text_layout_;
+  text_layout_ = nullptr;
+  const FontMetrics* font_metrics = layout_context_->font(font);
+  if (!text.empty() && font_metrics) {
+    text_layout_ = new TextLayout(text, *font_metrics);
+  }
+  MarkDirty();
+}
+
+/**
+ * positions of the node's children and of the node itself are computed again on
+ * next layout pass without measuring. ancestors are flagged to be reached.
+ */
+void LayoutNode::MarkNeedsAlignment() {
+  LayoutNode* node = this;
+  while (node != nullptr) {
+    node->needs_alignment_ = true;
+    node->children_appended_only_ = false;
+    node = node->parent_;
+  }
+}
+
+/**
+ * dirty nodes have dirty parents unless they are out of flow, so walking dirty
+ * children from the root reaches all others. children before appended ones
+ * are clean.
+ */
+void LayoutNode::ClearDirty() {
+  if (!dirty_) {
+    return;
+  }
+  LayoutNode* child =
+      children_appended_only_ ? first_appended_child_ : first_child_;
+  dirty_ = false;
+  children_appended_only_ = false;
+  while (child != nullptr) {
+    child->ClearDirty();
+    child = child->next_;
+  }
+}
+
 void LayoutNode::UpdateLayoutInfo(float parent_width, float parent_height) {
-  layout_info_.min_width_ =
-      css_style_->min_width().GetComputedValue(parent_width);
-  layout_info_.min_height_ =
-      css_style_->min_height().GetComputedValue(parent_height);
-  layout_info_.max_width_ =
+  // measure results depend on resolved min/max/padding, margins only matter
+  // to the parent
+  bool measure_affected = false;
+  measure_affected |= UpdateResolvedValue(
+      layout_info_.min_width_,
+      css_style_->min_width().GetComputedValue(parent_width));
+  measure_affected |= UpdateResolvedValue(
+      layout_info_.min_height_,
+      css_style_->min_height().GetComputedValue(parent_height));
+  measure_affected |= UpdateResolvedValue(
+      layout_info_.max_width_,
       css_style_->max_width().IsAuto()
           ? 10E6
-          : css_style_->max_width().GetComputedValue(parent_width);
-  layout_info_.max_height_ =
+          : css_style_->max_width().GetComputedValue(parent_width));
+  measure_affected |= UpdateResolvedValue(
+      layout_info_.max_height_,
       css_style_->max_height().IsAuto()
           ? 10E6
-          : css_style_->max_height().GetComputedValue(parent_height);
-
-  layout_info_.padding_[kCSSDirectionTop] =
-      css_style_->padding_top().GetComputedValue(parent_width);
-  layout_info_.padding_[kCSSDirectionLeft] =
-      css_style_->padding_left().GetComputedValue(parent_width);
-  layout_info_.padding_[kCSSDirectionBottom] =
-      css_style_->padding_bottom().GetComputedValue(parent_width);
-  layout_info_.padding_[kCSSDirectionRight] =
-      css_style_->padding_right().GetComputedValue(parent_width);
+          : css_style_->max_height().GetComputedValue(parent_height));
+
+  measure_affected |= UpdateResolvedValue(
+      layout_info_.padding_[kCSSDirectionTop],
+      css_style_->padding_top().GetComputedValue(parent_width));
+  measure_affected |= UpdateResolvedValue(
+      layout_info_.padding_[kCSSDirectionLeft],
+      css_style_->padding_left().GetComputedValue(parent_width));
+  measure_affected |= UpdateResolvedValue(
+      layout_info_.padding_[kCSSDirectionBottom],
+      css_style_->padding_bottom().GetComputedValue(parent_width));
+  measure_affected |= UpdateResolvedValue(
+      layout_info_.padding_[kCSSDirectionRight],
+      css_style_->padding_right().GetComputedValue(parent_width));
 
   layout_info_.margin_[kCSSDirectionTop] =
       css_style_->margin_top().GetComputedValue(parent_width);
@@ -171,6 +462,11 @@ void LayoutNode::UpdateLayoutInfo(float parent_width, float parent_height) {
       css_style_->margin_bottom().GetComputedValue(parent_width);
   layout_info_.margin_[kCSSDirectionRight] =
       css_style_->margin_right().GetComputedValue(parent_width);
+
+  if (measure_affected) {
+    measure_cache_.Clear();
+    children_appended_only_ = false;
+  }
 }
 
 float LayoutNode::ApplyWidthConstraints(float width) const {
@@ -179,11 +475,7 @@ float LayoutNode::ApplyWidthConstraints(float width) const {
   // clamp max-width
   width = std::min(width, layout_info_.max_width_);
   // clamp content box size > 0
-  float min_border_box_width = layout_info_.padding_[kCSSDirectionLeft] +
-                               layout_info_.padding_[kCSSDirectionRight] +
-                               css_style_->border_left() +
-                               css_style_->border_right();
-  width = std::max(width, min_border_box_width);
+  width = std::max(width, MinBorderBoxWidth());
   return width;
 }
 
@@ -193,37 +485,107 @@ float LayoutNode::ApplyHeightConstraints(float height) const {
   // clamp max-height
   height = std::min(height, layout_info_.max_height_);
   // clamp content box size > 0
-  float min_border_box_height = layout_info_.padding_[kCSSDirectionTop] +
-                                layout_info_.padding_[kCSSDirectionBottom] +
-                                css_style_->border_top() +
-                                css_style_->border_bottom();
-  height = std::max(height, min_border_box_height);
+  height = std::max(height, MinBorderBoxHeight());
   return height;
 }
 
+float LayoutNode::MinBorderBoxWidth() const {
+  return layout_info_.padding_[kCSSDirectionLeft] +
+         layout_info_.padding_[kCSSDirectionRight] + css_style_->border_left() +
+         css_style_->border_right();
+}
+
+float LayoutNode::MinBorderBoxHeight() const {
+  return layout_info_.padding_[kCSSDirectionTop] +
+         layout_info_.padding_[kCSSDirectionBottom] + css_style_->border_top() +
+         css_style_->border_bottom();
+}
+
+/**
+ * incremental layout: subtrees which are clean and receive the same
+ * constraints as last pass are neither measured nor aligned again, they keep
+ * their previous offsets
+ */
 void LayoutNode::ReLayout(int left, int top, int right, int bottom) {
-  UpdateMeasure(right - left, bottom - top, kLayoutModeExact, kLayoutModeExact);
+  ReLayout(LayoutConstraints(right - left, bottom - top, kLayoutModeExact,
+                             kLayoutModeExact));
+}
+
+void LayoutNode::ReLayout(const LayoutConstraints& constraints) {
+  UpdateMeasure(constraints.width_, constraints.height_,
+                constraints.width_mode_, constraints.height_mode_);
   UpdateAlignment();
+  ClearDirty();
+}
+
+void LayoutNode::ReLayout(int left,
+                          int top,
+                          int right,
+                          int bottom,
+                          base::ThreadPool* thread_pool) {
+  base::ThreadPool::Scope scope(thread_pool);
+  ReLayout(left, top, right, bottom);
 }
 
+/**
+ * a subtree which has answered the same constraints before returns the cached
+ * size without recursing
+ */
 FloatSize LayoutNode::UpdateMeasure(float width,
                                     float height,
                                     LayoutMode width_mode,
                                     LayoutMode height_mode) {
+  // sizes with undefined mode are never read, normalize them so that all
+  // undefined probes share one cache entry
+  LayoutConstraints constraints(
+      width_mode == kLayoutModeUndefined ? .0f : width,
+      height_mode == kLayoutModeUndefined ? .0f : height, width_mode,
+      height_mode);
+  requested_constraints_ = constraints;
+  const FloatSize* cached_size = measure_cache_.Find(constraints);
+  if (cached_size) {
+    offset_width_ = cached_size->width_;
+    offset_height_ = cached_size->height_;
+    return *cached_size;
+  }
+  FloatSize size = Measure(constraints);
+  measure_cache_.Insert(constraints, size);
+  return size;
+}
+
+FloatSize LayoutNode::Measure(const LayoutConstraints& constraints) {
+  float width = constraints.width_;
+  float height = constraints.height_;
+  LayoutMode width_mode = constraints.width_mode_;
+  LayoutMode height_mode = constraints.height_mode_;
+  measured_constraints_ = constraints;
+  needs_alignment_ = true;
+
   DisplayType display = css_style_->display();
+  if ((text_layout_ || measure_func_) && first_child_ == nullptr &&
+      display != kDisplayNone) {
+    MeasureLeaf(constraints);
+    return FloatSize(offset_width_, offset_height_);
+  }
   switch (display) {
     case kDisplayFlex: {
       if (layout_algorithm_) {
         layout_algorithm_->Update(width, height, width_mode, height_mode);
       } else {
-        layout_algorithm_ = new FlexLayoutAlgorithm(this, css_style_.get());
+        layout_algorithm_ = new FlexLayoutAlgorithm(this);
         layout_algorithm_->Initialize(width, height, width_mode, height_mode);
       }
       layout_algorithm_->Measure();
       break;
     }
     case kDisplayGrid: {
-      // TODO:
+      if (layout_algorithm_) {
+        layout_algorithm_->Update(width, height, width_mode, height_mode);
+      } else {
+        layout_algorithm_ = new GridLayoutAlgorithm(this);
+        layout_algorithm_->Initialize(width, height, width_mode, height_mode);
+      }
+      layout_algorithm_->Measure();
       break;
     }
     case kDisplayNone: {
@@ -236,16 +598,99 @@ FloatSize LayoutNode::UpdateMeasure(float width,
   return FloatSize(offset_width_, offset_height_);
 }
 
+/**
+ * the text or the measure func sizes the content box, padding and borders are
+ * added around it. exact sizes are kept, at-most sizes and max sizes bound the
+ * content. results are looked up in the tree's cache first.
+ */
+void LayoutNode::MeasureLeaf(const LayoutConstraints& constraints) {
+  // children removed since the last measure leave no algorithm behind
+  delete layout_algorithm_;
+  layout_algorithm_ = nullptr;
+
+  float padding_border_width = MinBorderBoxWidth();
+  float padding_border_height = MinBorderBoxHeight();
+  float width = constraints.width_;
+  float height = constraints.height_;
+  LayoutMode width_mode = constraints.width_mode_;
+  LayoutMode height_mode = constraints.height_mode_;
+  if (width_mode == kLayoutModeExact) {
+    width = ApplyWidthConstraints(width);
+  } else if (!css_style_->max_width().IsAuto()) {
+    width = width_mode == kLayoutModeAtMost
+                ? std::min(width, layout_info_.max_width_)
+                : layout_info_.max_width_;
+    width_mode = kLayoutModeAtMost;
+  }
+  if (height_mode == kLayoutModeExact) {
+    height = ApplyHeightConstraints(height);
+  } else if (!css_style_->max_height().IsAuto()) {
+    height = height_mode == kLayoutModeAtMost
+                 ? std::min(height, layout_info_.max_height_)
+                 : layout_info_.max_height_;
+    height_mode = kLayoutModeAtMost;
+  }
+  LayoutConstraints content_constraints(
+      std::max(width - padding_border_width, .0f),
+      std::max(height - padding_border_height, .0f), width_mode, height_mode);
+  FloatSize content_size(.0f, .0f);
+  if (text_layout_) {
+    content_size = text_layout_->Measure(content_constraints.width_,
+                                         content_constraints.width_mode_);
+  } else if (tree_) {
+    content_size = tree_->measure_func_cache().Measure(
+        measure_func_, context_, content_constraints);
+  } else {
+    content_size = measure_func_(
+        context_, content_constraints.width_, content_constraints.width_mode_,
+        content_constraints.height_, content_constraints.height_mode_);
+  }
+
+  offset_width_ = width;
+  if (width_mode != kLayoutModeExact) {
+    offset_width_ =
+        ApplyWidthConstraints(content_size.width_ + padding_border_width);
+  }
+  offset_height_ = height;
+  if (height_mode != kLayoutModeExact) {
+    offset_height_ =
+        ApplyHeightConstraints(content_size.height_ + padding_border_height);
+  }
+}
+
 void LayoutNode::UpdateAlignment() {
+  // the last measure answered from cache left the subtree laid out for other
+  // constraints
+  if (requested_constraints_ != measured_constraints_) {
+    Measure(requested_constraints_);
+  }
+  // neither the node nor any descendant was measured or had an alignment
+  // change since last alignment
+  if (!needs_alignment_) {
+    return;
+  }
+  needs_alignment_ = false;
   // no algorithm with `display: none`
   if (layout_algorithm_) {
     layout_algorithm_->Alignment();
 
-    LayoutNode* child = first_child_;
+    // children only touch their own subtrees. leaves are aligned faster than
+    // they are handed to another thread
+    base::TaskGroup children(base::ThreadPool::Current());
+    LayoutNode* child = layout_algorithm_->FirstChangedChild();
+    if (child == nullptr) {
+      child = first_child_;
+    }
     while (child != nullptr) {
-      child->UpdateAlignment();
+      children.Run([child] { child->UpdateAlignment(); },
+                   child->first_child_ != nullptr);
       child = child->next_;
     }
+    children.Wait();
+  }
+  // an out-of-flow node dirty on its own is not reached from the root
+  if (dirty_ && parent_ && !parent_->dirty_ && IsOutOfFlow(css_style_)) {
+    ClearDirty();
   }
 }
 
@@ -254,6 +699,7 @@ void LayoutNode::UpdateAlignment() {
  */
 void LayoutNode::UpdateMeasureWithDisplayNone() {
   if (layout_algorithm_) {
+    delete layout_algorithm_;
     layout_algorithm_ = nullptr;
   }
 
@@ -270,11 +716,18 @@ void LayoutNode::UpdateMeasureWithDisplayNone() {
 }
 
 const CSSStyle* LayoutNode::css_style() const {
-  return css_style_.get();
+  return css_style_;
 }
 
+// a leaf with another context shows other content
 void LayoutNode::SetContext(void* const context) {
+  if (context_ == context) {
+    return;
+  }
   context_ = context;
+  if (measure_func_) {
+    MarkDirty();
+  }
 }
 
 void LayoutNode::SetOffsetTop(float offset_top) {
@@ -3,35 +3,162 @@
 #ifndef STARLIGHT_LAYOUT_LAYOUT_NODE_H_
 #define STARLIGHT_LAYOUT_LAYOUT_NODE_H_
 
-#include <memory>
-#include <vector>
+#include <cstdint>
+#include <string_view>
 
+#include "base/length.h"
 #include "layout/layout_enum.h"
 
+namespace base {
+class ThreadPool;
+}
+
 namespace starlight {
 
+class AsyncLayout;
 class LayoutAlgorithm;
+class LayoutContext;
+class LayoutTree;
+class TextLayout;
 class CSSStyle;
+class StyleSheet;
+struct GridLine;
+struct GridTrackList;
+
+// a `name: value` pair of a declaration block
+struct StyleDeclaration {
+  std::string_view name_;
+  std::string_view value_;
+};
 
 // handle percentage value
 // value: top[0] -> left[1] -> bottom[2] -> right[3]
 struct LayoutInfo {
   LayoutInfo()
-      : min_width_(.0f), min_height_(.0f), max_width_(10E6), max_height_(10E6) {
-    padding_.resize(4, .0f);
-    margin_.resize(4, .0f);
-  }
+      : min_width_(.0f),
+        min_height_(.0f),
+        max_width_(10E6),
+        max_height_(10E6),
+        padding_{.0f, .0f, .0f, .0f},
+        margin_{.0f, .0f, .0f, .0f} {}
   float min_width_;
   float min_height_;
   float max_width_;
   float max_height_;
-  std::vector<float> padding_;
-  std::vector<float> margin_;
+  float padding_[4];
+  float margin_[4];
+};
+
+// constraints a node is measured with
+struct LayoutConstraints {
+  LayoutConstraints(float width,
+                    float height,
+                    LayoutMode width_mode,
+                    LayoutMode height_mode)
+      : width_(width),
+        height_(height),
+        width_mode_(width_mode),
+        height_mode_(height_mode) {}
+  bool operator==(const LayoutConstraints& other) const {
+    return width_ == other.width_ && height_ == other.height_ &&
+           width_mode_ == other.width_mode_ &&
+           height_mode_ == other.height_mode_;
+  }
+  bool operator!=(const LayoutConstraints& other) const {
+    return !(*this == other);
+  }
+  float width_;
+  float height_;
+  LayoutMode width_mode_;
+  LayoutMode height_mode_;
+};
+
+// position and size of a node in a published frame, see AsyncLayout
+struct LayoutResult {
+  LayoutResult()
+      : offset_top_(.0f),
+        offset_left_(.0f),
+        offset_width_(.0f),
+        offset_height_(.0f) {}
+  float offset_top_;
+  float offset_left_;
+  float offset_width_;
+  float offset_height_;
+};
+
+/**
+ * intrinsic size of the content of a leaf, e.g. text or an image, as known to
+ * the host. `context` is the node's context, sizes are of the content box.
+ * width and height are only meaningful with their mode not undefined: exact
+ * sizes are the one to fit, at-most sizes the most there is. a parallel
+ * ReLayout calls it from the threads of its pool.
+ */
+typedef FloatSize (*MeasureFunc)(void* context,
+                                 float width,
+                                 LayoutMode width_mode,
+                                 float height,
+                                 LayoutMode height_mode);
+
+/**
+ * records measured sizes of a node under the constraints it has answered.
+ * results stay valid until the node or one of its descendants is marked dirty,
+ * or its min/max/padding resolve differently. oldest entry gets replaced when
+ * the cache is full.
+ */
+class MeasureCache {
+ public:
+  static const size_t kMaxEntries = 4;
+
+  MeasureCache() : size_(0), next_(0) {}
+
+  const FloatSize* Find(const LayoutConstraints& constraints) const {
+    for (size_t i = 0; i < size_; ++i) {
+      if (entries_[i].constraints_ == constraints) {
+        return &entries_[i].result_;
+      }
+    }
+    return nullptr;
+  }
+  void Insert(const LayoutConstraints& constraints, const FloatSize& result) {
+    entries_[next_] = Entry(constraints, result);
+    next_ = (next_ + 1) % kMaxEntries;
+    if (size_ < kMaxEntries) {
+      ++size_;
+    }
+  }
+  void Clear() {
+    size_ = 0;
+    next_ = 0;
+  }
+
+ private:
+  struct Entry {
+    Entry()
+        : constraints_(.0f, .0f, kLayoutModeUndefined, kLayoutModeUndefined),
+          result_(.0f, .0f) {}
+    Entry(const LayoutConstraints& constraints, const FloatSize& result)
+        : constraints_(constraints), result_(result) {}
+    LayoutConstraints constraints_;
+    FloatSize result_;
+  };
+  Entry entries_[kMaxEntries];
+  size_t size_;
+  size_t next_;
 };
 
+/**
+ * a node either lives on its own, created by `new`, or belongs to a LayoutTree
+ * which allocates it and destroys it with the tree. tree nodes must not be
+ * deleted one by one. styles are shared between the nodes of one
+ * LayoutContext, nodes of a tree share its context and children have to share
+ * the context of their parent.
+ */
 class LayoutNode {
  public:
+  // nodes on their own, bound to LayoutContext::Default() if there is no
+  // `layout_context`
   LayoutNode();
+  explicit LayoutNode(LayoutContext* layout_context);
   ~LayoutNode();
 
   // layout tree construct
@@ -44,20 +171,71 @@ class LayoutNode {
   LayoutNode* RemoveChild(int index);
 
   // CSS style
-  void SetStyle(const std::string& name,
-                const std::string& value,
+  void SetStyle(std::string_view name,
+                std::string_view value,
                 bool reset = false);
+  // parsed values, see CSSStyle::SetStyle
+  void SetStyle(StyleProperty property, const base::Length& value);
+  void SetStyle(StyleProperty property, float value);
+  void SetStyle(StyleProperty property, int value);
+  void SetStyle(StyleProperty property, PositionType value);
+  void SetStyle(StyleProperty property, DisplayType value);
+  void SetStyle(StyleProperty property, FlexDirectionType value);
+  void SetStyle(StyleProperty property, FlexWrapType value);
+  void SetStyle(StyleProperty property, JustifyContentType value);
+  void SetStyle(StyleProperty property, AlignItemsType value);
+  void SetStyle(StyleProperty property, AlignSelfType value);
+  void SetStyle(StyleProperty property, AlignContentType value);
+  void SetStyle(StyleProperty property, const GridTrackList& value);
+  void SetStyle(StyleProperty property, const GridLine& value);
+  // whole declaration blocks, applied at once. return whether any style
+  // changed
+  bool SetStyles(const StyleDeclaration* declarations, size_t count);
+  bool SetStyles(std::string_view declarations);
+  // adopts a rule of a precompiled stylesheet of the node's context, returns
+  // whether the style changed
+  bool ApplyStyleRule(const StyleSheet& style_sheet, uint32_t index);
 
   // dirty
   inline void MarkDirty(const bool recursion = true);
+  void MarkNeedsAlignment();
+  // the content behind the node's context changed, sizes the measure func
+  // returned for the context are dropped as well
+  void MarkMeasureDirty();
+
+  /**
+   * childless nodes with a measure func are sized by it instead of by a layout
+   * algorithm. results are shared by all nodes of a tree with the same func
+   * and context, see MeasureFuncCache.
+   */
+  void SetMeasureFunc(MeasureFunc measure_func);
+  /**
+   * childless nodes with text are sized by breaking it into lines of a font
+   * registered with the layout context, without calling into the host. text
+   * takes precedence over a measure func, an empty view removes the text.
+   */
+  void SetText(std::string_view text, int font);
 
   // clamp
   void UpdateLayoutInfo(float parent_width, float parent_height);
   float ApplyWidthConstraints(float width) const;
   float ApplyHeightConstraints(float height) const;
+  // padding and borders, the content box never gets negative
+  float MinBorderBoxWidth() const;
+  float MinBorderBoxHeight() const;
 
   // layout
   void ReLayout(int left, int top, int right, int bottom);
+  // lays out the node as a root, e.g. with an undefined height to size it to
+  // its content
+  void ReLayout(const LayoutConstraints& constraints);
+  // same results as the serial pass, subtrees which do not depend on each
+  // other are measured and aligned on the threads of `thread_pool`
+  void ReLayout(int left,
+                int top,
+                int right,
+                int bottom,
+                base::ThreadPool* thread_pool);
   FloatSize UpdateMeasure(float width,
                           float height,
                           LayoutMode width_mode,
@@ -66,6 +244,22 @@ class LayoutNode {
   void UpdateMeasureWithDisplayNone();
 
  private:
+  friend class AsyncLayout;
+  friend class LayoutTree;
+  LayoutNode(LayoutTree* tree, LayoutContext* layout_context);
+
+  template <typename Value>
+  void UpdateStyle(StyleProperty property, Value value);
+  bool UpdateStyle(const CSSStyle& css_style, unsigned changes);
+
+  FloatSize Measure(const LayoutConstraints& constraints);
+  void MeasureLeaf(const LayoutConstraints& constraints);
+  void ClearDirty();
+
+  // null for nodes created on their own
+  LayoutTree* tree_;
+  LayoutContext* layout_context_;
+
   LayoutNode* parent_;
   LayoutNode* prev_;
   LayoutNode* next_;
@@ -73,18 +267,42 @@ class LayoutNode {
   LayoutNode* last_child_;
   unsigned child_count_;
 
+  // a dirty node has been changed since the last layout pass. its ancestors
+  // are dirty as well, flags get cleared once ReLayout finishes.
   bool dirty_;
+  // children need to be positioned again, the node has been measured for
+  // real or had an alignment change since its last alignment
+  bool needs_alignment_;
+  // nothing but appending children has changed the node since the last layout
+  // pass, its resolved min/max/padding included. only children from
+  // `first_appended_child_` on can be dirty then.
+  bool children_appended_only_;
+  LayoutNode* first_appended_child_;
 
-  std::unique_ptr<CSSStyle> css_style_;
+  // shared, holds one reference
+  const CSSStyle* css_style_;
   LayoutAlgorithm* layout_algorithm_;
+  MeasureFunc measure_func_;
+  // owned, null for nodes without text
+  TextLayout* text_layout_;
 
   LayoutInfo layout_info_;
 
+  // measure cache. the layout state of the subtree always reflects
+  // `measured_constraints_`; a cache hit on other constraints is recorded in
+  // `requested_constraints_` and measured for real before alignment.
+  MeasureCache measure_cache_;
+  LayoutConstraints measured_constraints_;
+  LayoutConstraints requested_constraints_;
+
   // layout results
   float offset_top_;
   float offset_left_;
   float offset_width_;
   float offset_height_;
+  // front and back frame of an AsyncLayout, the host reads one while the
+  // layout thread publishes the other
+  LayoutResult frame_results_[2];
 
   void* context_ = nullptr;
 
@@ -97,8 +315,16 @@ class LayoutNode {
   inline LayoutNode* last_child() const { return last_child_; }
   inline unsigned child_count() const { return child_count_; }
   inline bool dirty() const { return dirty_; }
+  inline bool needs_alignment() const { return needs_alignment_; }
+  inline bool children_appended_only() const {
+    return children_appended_only_;
+  }
+  inline LayoutTree* tree() const { return tree_; }
+  inline LayoutContext* layout_context() const { return layout_context_; }
   const CSSStyle* css_style() const;
   inline LayoutAlgorithm* layout_algorithm() const { return layout_algorithm_; }
+  inline MeasureFunc measure_func() const { return measure_func_; }
+  inline TextLayout* text_layout() const { return text_layout_; }
   const LayoutInfo& layout_info() const { return layout_info_; }
   LayoutInfo& GetModifiableLayoutInfo() { return layout_info_; }
   inline float offset_top() const { return offset_top_; }
@@ -0,0 +1,32 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include "layout/layout_tree.h"
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+
+namespace starlight {
+
+LayoutTree::LayoutTree() : LayoutTree(LayoutContext::Default()) {}
+
+LayoutTree::LayoutTree(LayoutContext* layout_context)
+    : layout_context_(layout_context) {}
+
+LayoutTree::~LayoutTree() {
+  Clear();
+}
+
+LayoutNode* LayoutTree::CreateNode() {
+  return new (nodes_.Allocate()) LayoutNode(this, layout_context_);
+}
+
+/**
+ * nodes only release their layout algorithms and style references, all other
+ * per-node data lives inside the slabs
+ */
+void LayoutTree::Clear() {
+  nodes_.ForEach([](LayoutNode* node) { node->~LayoutNode(); });
+  nodes_.Reset();
+  measure_func_cache_.Clear();
+}
+
+}  // namespace starlight
\ No newline at end of file
@@ -0,0 +1,100 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#ifndef STARLIGHT_LAYOUT_LAYOUT_TREE_H_
+#define STARLIGHT_LAYOUT_LAYOUT_TREE_H_
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include "layout/measure_func_cache.h"
+
+namespace starlight {
+
+class LayoutContext;
+class LayoutNode;
+
+/**
+ * hands out storage for objects of type T from slabs of `kSlabSize` objects.
+ * storage is never returned one by one, Reset() makes all of it available
+ * again and slabs are only freed with the pool.
+ */
+template <typename T, size_t kSlabSize = 256>
+class SlabPool {
+ public:
+  SlabPool() : size_(0) {}
+  ~SlabPool() {
+    for (T* slab : slabs_) {
+      ::operator delete(slab);
+    }
+  }
+  SlabPool(const SlabPool&) = delete;
+  SlabPool& operator=(const SlabPool&) = delete;
+
+  void* Allocate() {
+    size_t slab = size_ / kSlabSize;
+    if (slab == slabs_.size()) {
+      slabs_.push_back(static_cast<T*>(::operator new(sizeof(T) * kSlabSize)));
+    }
+    return slabs_[slab] + size_++ % kSlabSize;
+  }
+
+  // visits every object handed out since last reset, in allocation order
+  template <typename Visitor>
+  void ForEach(Visitor visitor) {
+    size_t remaining = size_;
+    for (size_t slab = 0; remaining > 0; ++slab) {
+      size_t count = remaining < kSlabSize ? remaining : kSlabSize;
+      T* objects = slabs_[slab];
+      for (size_t i = 0; i < count; ++i) {
+        visitor(objects + i);
+      }
+      remaining -= count;
+    }
+  }
+
+  void Reset() { size_ = 0; }
+
+  size_t size() const { return size_; }
+
+ private:
+  std::vector<T*> slabs_;
+  size_t size_;
+};
+
+/**
+ * owns the nodes of one layout tree. nodes and their layout info are allocated
+ * from contiguous slabs instead of one heap block each, and the whole tree is
+ * dropped at once by Clear() or by destroying the tree. all nodes are bound to
+ * the context of the tree, LayoutContext::Default() if there is none given.
+ */
+class LayoutTree {
+ public:
+  LayoutTree();
+  explicit LayoutTree(LayoutContext* layout_context);
+  ~LayoutTree();
+  LayoutTree(const LayoutTree&) = delete;
+  LayoutTree& operator=(const LayoutTree&) = delete;
+
+  LayoutNode* CreateNode();
+
+  /**
+   * destroys all nodes created by the tree and forgets their measured sizes.
+   * slabs are kept for the nodes of the next tree built into it.
+   */
+  void Clear();
+
+  size_t node_count() const { return nodes_.size(); }
+  LayoutContext* layout_context() const { return layout_context_; }
+  // sizes returned by the measure funcs of the tree's nodes
+  MeasureFuncCache& measure_func_cache() { return measure_func_cache_; }
+
+ private:
+  LayoutContext* layout_context_;
+  SlabPool<LayoutNode> nodes_;
+  MeasureFuncCache measure_func_cache_;
+};
+
+}  // namespace starlight
+
+#endif
\ No newline at end of file
@@ -0,0 +1,101 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include <functional>
+
+#include "layout/measure_func_cache.h"
+
+namespace starlight {
+
+namespace {
+
+inline void HashCombine(size_t& seed, size_t value) {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+}  // namespace
+
+size_t MeasureFuncCache::KeyHash::operator()(const Key& key) const {
+  size_t seed = reinterpret_cast<size_t>(key.measure_func_);
+  HashCombine(seed, reinterpret_cast<size_t>(key.context_));
+  HashCombine(seed, std::hash<float>()(key.constraints_.width_));
+  HashCombine(seed, std::hash<float>()(key.constraints_.height_));
+  HashCombine(seed, static_cast<size_t>(key.constraints_.width_mode_));
+  HashCombine(seed, static_cast<size_t>(key.constraints_.height_mode_));
+  return seed;
+}
+
+/**
+ * a miss calls the func without holding the lock. two threads missing the
+ * same key both call it, the later result replaces the earlier one.
+ */
+FloatSize MeasureFuncCache::Measure(MeasureFunc measure_func,
+                                    void* context,
+                                    const LayoutConstraints& constraints) {
+  Key key(measure_func, context, constraints);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, found->second);
+      return found->second->size_;
+    }
+  }
+
+  FloatSize size = measure_func(context, constraints.width_,
+                                constraints.width_mode_, constraints.height_,
+                                constraints.height_mode_);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (capacity_ == 0) {
+    return size;
+  }
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    found->second->size_ = size;
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return size;
+  }
+  Shrink(capacity_ - 1);
+  entries_.emplace_front(key, size);
+  index_.emplace(key, entries_.begin());
+  return size;
+}
+
+void MeasureFuncCache::Erase(void* context) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto entry = entries_.begin(); entry != entries_.end();) {
+    if (entry->key_.context_ == context) {
+      index_.erase(entry->key_);
+      entry = entries_.erase(entry);
+    } else {
+      ++entry;
+    }
+  }
+}
+
+void MeasureFuncCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  index_.clear();
+  entries_.clear();
+}
+
+void MeasureFuncCache::SetCapacity(size_t capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  capacity_ = capacity;
+  Shrink(capacity_);
+}
+
+size_t MeasureFuncCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+// drops least recently used entries down to `capacity`, the lock is held
+void MeasureFuncCache::Shrink(size_t capacity) {
+  while (entries_.size() > capacity) {
+    index_.erase(entries_.back().key_);
+    entries_.pop_back();
+  }
+}
+
+}  // namespace starlight
\ No newline at end of file
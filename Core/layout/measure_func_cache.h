@@ -0,0 +1,81 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#ifndef STARLIGHT_LAYOUT_MEASURE_FUNC_CACHE_H_
+#define STARLIGHT_LAYOUT_MEASURE_FUNC_CACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "layout/layout_node.h"
+
+namespace starlight {
+
+/**
+ * sizes returned by measure funcs, keyed by func, context and content box
+ * constraints. leaves showing the same content share a context, and with it
+ * their results. at most `capacity` entries are kept, the least recently
+ * used one is dropped for a new one. subtrees measured on several threads
+ * share the cache, funcs themselves are called outside of its lock.
+ */
+class MeasureFuncCache {
+ public:
+  static const size_t kDefaultCapacity = 1024;
+
+  MeasureFuncCache() : capacity_(kDefaultCapacity) {}
+  MeasureFuncCache(const MeasureFuncCache&) = delete;
+  MeasureFuncCache& operator=(const MeasureFuncCache&) = delete;
+
+  // the cached size, else what `measure_func` returns
+  FloatSize Measure(MeasureFunc measure_func,
+                    void* context,
+                    const LayoutConstraints& constraints);
+
+  // entries of `context` for any func
+  void Erase(void* context);
+  void Clear();
+
+  // zero turns the cache off
+  void SetCapacity(size_t capacity);
+  size_t capacity() const { return capacity_; }
+  size_t size() const;
+
+ private:
+  struct Key {
+    Key(MeasureFunc measure_func,
+        void* context,
+        const LayoutConstraints& constraints)
+        : measure_func_(measure_func),
+          context_(context),
+          constraints_(constraints) {}
+    bool operator==(const Key& other) const {
+      return measure_func_ == other.measure_func_ &&
+             context_ == other.context_ && constraints_ == other.constraints_;
+    }
+    MeasureFunc measure_func_;
+    void* context_;
+    LayoutConstraints constraints_;
+  };
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+  struct Entry {
+    Entry(const Key& key, const FloatSize& size) : key_(key), size_(size) {}
+    Key key_;
+    FloatSize size_;
+  };
+  typedef std::list<Entry> EntryList;
+
+  void Shrink(size_t capacity);
+
+  mutable std::mutex mutex_;
+  size_t capacity_;
+  // most recently used first
+  EntryList entries_;
+  std::unordered_map<Key, EntryList::iterator, KeyHash> index_;
+};
+
+}  // namespace starlight
+
+#endif
\ No newline at end of file
@@ -1,6 +1,10 @@
 // Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <limits>
 
 #include "layout/style.h"
 #include "base/length_utils.h"
@@ -8,74 +12,558 @@
 
 namespace starlight {
 
-float CSSStyle::density_ = 1;
-float CSSStyle::screen_width_ = 1;
-float CSSStyle::zoom_ratio_ = 1;
+namespace {
+
+// `name` has the same length as `literal`
+template <size_t N>
+inline bool NameEquals(std::string_view name, const char (&literal)[N]) {
+  return std::memcmp(name.data(), literal, N - 1) == 0;
+}
 
 /**
- * support both '-' and camel case
+ * support both '-' and camel case. names are told apart by their length and
+ * then by one character, so at most a few names are compared in full.
  */
-StyleFuncMap CSSStyle::style_setters_ = {
-    {"width", &CSSStyle::SetWidth},
-    {"height", &CSSStyle::SetHeight},
-    {"min-width", &CSSStyle::SetMinWidth},
-    {"minWidth", &CSSStyle::SetMinWidth},
-    {"min-height", &CSSStyle::SetMinHeight},
-    {"minHeight", &CSSStyle::SetMinHeight},
-    {"max-width", &CSSStyle::SetMaxWidth},
-    {"maxWidth", &CSSStyle::SetMaxWidth},
-    {"max-height", &CSSStyle::SetMaxHeight},
-    {"maxHeight", &CSSStyle::SetMaxHeight},
-    {"padding", &CSSStyle::SetPadding},
-    {"padding-top", &CSSStyle::SetPaddingTop},
-    {"paddingTop", &CSSStyle::SetPaddingTop},
-    {"padding-left", &CSSStyle::SetPaddingLeft},
-    {"paddingLeft", &CSSStyle::SetPaddingLeft},
-    {"padding-bottom", &CSSStyle::SetPaddingBottom},
-    {"paddingBottom", &CSSStyle::SetPaddingBottom},
-    {"padding-right", &CSSStyle::SetPaddingRight},
-    {"paddingRight", &CSSStyle::SetPaddingRight},
-    {"margin", &CSSStyle::SetMargin},
-    {"margin-top", &CSSStyle::SetMarginTop},
-    {"marginTop", &CSSStyle::SetMarginTop},
-    {"margin-left", &CSSStyle::SetMarginLeft},
-    {"marginLeft", &CSSStyle::SetMarginLeft},
-    {"margin-bottom", &CSSStyle::SetMarginBottom},
-    {"marginBottom", &CSSStyle::SetMarginBottom},
-    {"margin-right", &CSSStyle::SetMarginRight},
-    {"marginRight", &CSSStyle::SetMarginRight},
-    {"border-width", &CSSStyle::SetBorder},
-    {"borderWidth", &CSSStyle::SetBorder},
-    {"border-top", &CSSStyle::SetBorderTop},
-    {"borderTop", &CSSStyle::SetBorderTop},
-    {"border-left", &CSSStyle::SetBorderLeft},
-    {"borderLeft", &CSSStyle::SetBorderLeft},
-    {"border-bottom", &CSSStyle::SetBorderBottom},
-    {"borderBottom", &CSSStyle::SetBorderBottom},
-    {"border-right", &CSSStyle::SetBorderRight},
-    {"borderRight", &CSSStyle::SetBorderRight},
-    {"position", &CSSStyle::SetPosition},
-    {"display", &CSSStyle::SetDisplay},
-    {"flex", &CSSStyle::SetFlex},
-    {"flex-grow", &CSSStyle::SetFlexGrow},
-    {"flexGrow", &CSSStyle::SetFlexGrow},
-    {"flex-shrink", &CSSStyle::SetFlexShrink},
-    {"flexShrink", &CSSStyle::SetFlexShrink},
-    {"flex-direction", &CSSStyle::SetFlexDirection},
-    {"flexDirection", &CSSStyle::SetFlexDirection},
-    {"flex-wrap", &CSSStyle::SetFlexWrap},
-    {"flexWrap", &CSSStyle::SetFlexWrap},
-    {"flex-flow", &CSSStyle::SetFlexFlow},
-    {"flexFlow", &CSSStyle::SetFlexFlow},
-    {"justify-content", &CSSStyle::SetJustifyContent},
-    {"justifyContent", &CSSStyle::SetJustifyContent},
-    {"align-items", &CSSStyle::SetAlignItems},
-    {"alignItems", &CSSStyle::SetAlignItems},
-    {"align-self", &CSSStyle::SetAlignSelf},
-    {"alignSelf", &CSSStyle::SetAlignSelf},
-    {"align-content", &CSSStyle::SetAlignContent},
-    {"alignContent", &CSSStyle::SetAlignContent},
-    {"order", &CSSStyle::SetOrder}};
+StyleFunc FindStyleSetter(std::string_view name) {
+  switch (name.size()) {
+    case 3:
+      if (NameEquals(name, "top")) {
+        return &CSSStyle::SetTop;
+      }
+      break;
+    case 4:
+      switch (name[0]) {
+        case 'f':
+          if (NameEquals(name, "flex")) {
+            return &CSSStyle::SetFlex;
+          }
+          break;
+        case 'l':
+          if (NameEquals(name, "left")) {
+            return &CSSStyle::SetLeft;
+          }
+          break;
+      }
+      break;
+    case 5:
+      switch (name[0]) {
+        case 'o':
+          if (NameEquals(name, "order")) {
+            return &CSSStyle::SetOrder;
+          }
+          break;
+        case 'r':
+          if (NameEquals(name, "right")) {
+            return &CSSStyle::SetRight;
+          }
+          break;
+        case 'w':
+          if (NameEquals(name, "width")) {
+            return &CSSStyle::SetWidth;
+          }
+          break;
+      }
+      break;
+    case 6:
+      switch (name[0]) {
+        case 'b':
+          if (NameEquals(name, "bottom")) {
+            return &CSSStyle::SetBottom;
+          }
+          break;
+        case 'h':
+          if (NameEquals(name, "height")) {
+            return &CSSStyle::SetHeight;
+          }
+          break;
+        case 'm':
+          if (NameEquals(name, "margin")) {
+            return &CSSStyle::SetMargin;
+          }
+          break;
+      }
+      break;
+    case 7:
+      switch (name[0]) {
+        case 'd':
+          if (NameEquals(name, "display")) {
+            return &CSSStyle::SetDisplay;
+          }
+          break;
+        case 'g':
+          if (NameEquals(name, "gridRow")) {
+            return &CSSStyle::SetGridRow;
+          }
+          break;
+        case 'p':
+          if (NameEquals(name, "padding")) {
+            return &CSSStyle::SetPadding;
+          }
+          break;
+      }
+      break;
+    case 8:
+      switch (name[4]) {
+        case '-':
+          if (NameEquals(name, "grid-row")) {
+            return &CSSStyle::SetGridRow;
+          }
+          break;
+        case 'F':
+          if (NameEquals(name, "flexFlow")) {
+            return &CSSStyle::SetFlexFlow;
+          }
+          break;
+        case 'G':
+          if (NameEquals(name, "flexGrow")) {
+            return &CSSStyle::SetFlexGrow;
+          }
+          break;
+        case 'W':
+          if (NameEquals(name, "flexWrap")) {
+            return &CSSStyle::SetFlexWrap;
+          }
+          break;
+        case 'i':
+          if (NameEquals(name, "maxWidth")) {
+            return &CSSStyle::SetMaxWidth;
+          }
+          if (NameEquals(name, "minWidth")) {
+            return &CSSStyle::SetMinWidth;
+          }
+          break;
+        case 't':
+          if (NameEquals(name, "position")) {
+            return &CSSStyle::SetPosition;
+          }
+          break;
+      }
+      break;
+    case 9:
+      switch (name[5]) {
+        case 'S':
+          if (NameEquals(name, "alignSelf")) {
+            return &CSSStyle::SetAlignSelf;
+          }
+          break;
+        case 'a':
+          if (NameEquals(name, "flexBasis")) {
+            return &CSSStyle::SetFlexBasis;
+          }
+          break;
+        case 'f':
+          if (NameEquals(name, "flex-flow")) {
+            return &CSSStyle::SetFlexFlow;
+          }
+          break;
+        case 'g':
+          if (NameEquals(name, "flex-grow")) {
+            return &CSSStyle::SetFlexGrow;
+          }
+          break;
+        case 'i':
+          if (NameEquals(name, "max-width")) {
+            return &CSSStyle::SetMaxWidth;
+          }
+          if (NameEquals(name, "maxHeight")) {
+            return &CSSStyle::SetMaxHeight;
+          }
+          if (NameEquals(name, "min-width")) {
+            return &CSSStyle::SetMinWidth;
+          }
+          if (NameEquals(name, "minHeight")) {
+            return &CSSStyle::SetMinHeight;
+          }
+          break;
+        case 'n':
+          if (NameEquals(name, "marginTop")) {
+            return &CSSStyle::SetMarginTop;
+          }
+          break;
+        case 'r':
+          if (NameEquals(name, "borderTop")) {
+            return &CSSStyle::SetBorderTop;
+          }
+          break;
+        case 'w':
+          if (NameEquals(name, "flex-wrap")) {
+            return &CSSStyle::SetFlexWrap;
+          }
+          break;
+      }
+      break;
+    case 10:
+      switch (name[6]) {
+        case '-':
+          if (NameEquals(name, "border-top")) {
+            return &CSSStyle::SetBorderTop;
+          }
+          if (NameEquals(name, "margin-top")) {
+            return &CSSStyle::SetMarginTop;
+          }
+          break;
+        case 'L':
+          if (NameEquals(name, "borderLeft")) {
+            return &CSSStyle::SetBorderLeft;
+          }
+          if (NameEquals(name, "marginLeft")) {
+            return &CSSStyle::SetMarginLeft;
+          }
+          break;
+        case 'a':
+          if (NameEquals(name, "flex-basis")) {
+            return &CSSStyle::SetFlexBasis;
+          }
+          break;
+        case 'g':
+          if (NameEquals(name, "paddingTop")) {
+            return &CSSStyle::SetPaddingTop;
+          }
+          break;
+        case 'i':
+          if (NameEquals(name, "max-height")) {
+            return &CSSStyle::SetMaxHeight;
+          }
+          if (NameEquals(name, "min-height")) {
+            return &CSSStyle::SetMinHeight;
+          }
+          break;
+        case 'l':
+          if (NameEquals(name, "gridColumn")) {
+            return &CSSStyle::SetGridColumn;
+          }
+          break;
+        case 'r':
+          if (NameEquals(name, "flexShrink")) {
+            return &CSSStyle::SetFlexShrink;
+          }
+          break;
+        case 's':
+          if (NameEquals(name, "align-self")) {
+            return &CSSStyle::SetAlignSelf;
+          }
+          break;
+        case 't':
+          if (NameEquals(name, "alignItems")) {
+            return &CSSStyle::SetAlignItems;
+          }
+          break;
+        case 'w':
+          if (NameEquals(name, "gridRowEnd")) {
+            return &CSSStyle::SetGridRowEnd;
+          }
+          break;
+      }
+      break;
+    case 11:
+      switch (name[6]) {
+        case '-':
+          if (NameEquals(name, "border-left")) {
+            return &CSSStyle::SetBorderLeft;
+          }
+          if (NameEquals(name, "margin-left")) {
+            return &CSSStyle::SetMarginLeft;
+          }
+          break;
+        case 'R':
+          if (NameEquals(name, "borderRight")) {
+            return &CSSStyle::SetBorderRight;
+          }
+          if (NameEquals(name, "marginRight")) {
+            return &CSSStyle::SetMarginRight;
+          }
+          break;
+        case 'W':
+          if (NameEquals(name, "borderWidth")) {
+            return &CSSStyle::SetBorder;
+          }
+          break;
+        case 'g':
+          if (NameEquals(name, "padding-top")) {
+            return &CSSStyle::SetPaddingTop;
+          }
+          if (NameEquals(name, "paddingLeft")) {
+            return &CSSStyle::SetPaddingLeft;
+          }
+          break;
+        case 'h':
+          if (NameEquals(name, "flex-shrink")) {
+            return &CSSStyle::SetFlexShrink;
+          }
+          break;
+        case 'i':
+          if (NameEquals(name, "align-items")) {
+            return &CSSStyle::SetAlignItems;
+          }
+          break;
+        case 'o':
+          if (NameEquals(name, "grid-column")) {
+            return &CSSStyle::SetGridColumn;
+          }
+          break;
+      }
+      break;
+    case 12:
+      switch (name[7]) {
+        case '-':
+          if (NameEquals(name, "padding-left")) {
+            return &CSSStyle::SetPaddingLeft;
+          }
+          break;
+        case 'R':
+          if (NameEquals(name, "paddingRight")) {
+            return &CSSStyle::SetPaddingRight;
+          }
+          break;
+        case 'S':
+          if (NameEquals(name, "gridRowStart")) {
+            return &CSSStyle::SetGridRowStart;
+          }
+          break;
+        case 'n':
+          if (NameEquals(name, "alignContent")) {
+            return &CSSStyle::SetAlignContent;
+          }
+          break;
+        case 'o':
+          if (NameEquals(name, "borderBottom")) {
+            return &CSSStyle::SetBorderBottom;
+          }
+          if (NameEquals(name, "marginBottom")) {
+            return &CSSStyle::SetMarginBottom;
+          }
+          break;
+        case 'r':
+          if (NameEquals(name, "border-right")) {
+            return &CSSStyle::SetBorderRight;
+          }
+          if (NameEquals(name, "margin-right")) {
+            return &CSSStyle::SetMarginRight;
+          }
+          break;
+        case 'w':
+          if (NameEquals(name, "border-width")) {
+            return &CSSStyle::SetBorder;
+          }
+          if (NameEquals(name, "grid-row-end")) {
+            return &CSSStyle::SetGridRowEnd;
+          }
+          break;
+      }
+      break;
+    case 13:
+      switch (name[0]) {
+        case 'a':
+          if (NameEquals(name, "align-content")) {
+            return &CSSStyle::SetAlignContent;
+          }
+          break;
+        case 'b':
+          if (NameEquals(name, "border-bottom")) {
+            return &CSSStyle::SetBorderBottom;
+          }
+          break;
+        case 'f':
+          if (NameEquals(name, "flexDirection")) {
+            return &CSSStyle::SetFlexDirection;
+          }
+          break;
+        case 'g':
+          if (NameEquals(name, "gridColumnEnd")) {
+            return &CSSStyle::SetGridColumnEnd;
+          }
+          break;
+        case 'm':
+          if (NameEquals(name, "margin-bottom")) {
+            return &CSSStyle::SetMarginBottom;
+          }
+          break;
+        case 'p':
+          if (NameEquals(name, "padding-right")) {
+            return &CSSStyle::SetPaddingRight;
+          }
+          if (NameEquals(name, "paddingBottom")) {
+            return &CSSStyle::SetPaddingBottom;
+          }
+          break;
+      }
+      break;
+    case 14:
+      switch (name[0]) {
+        case 'f':
+          if (NameEquals(name, "flex-direction")) {
+            return &CSSStyle::SetFlexDirection;
+          }
+          break;
+        case 'g':
+          if (NameEquals(name, "grid-row-start")) {
+            return &CSSStyle::SetGridRowStart;
+          }
+          break;
+        case 'j':
+          if (NameEquals(name, "justifyContent")) {
+            return &CSSStyle::SetJustifyContent;
+          }
+          break;
+        case 'p':
+          if (NameEquals(name, "padding-bottom")) {
+            return &CSSStyle::SetPaddingBottom;
+          }
+          break;
+      }
+      break;
+    case 15:
+      switch (name[0]) {
+        case 'g':
+          if (NameEquals(name, "grid-column-end")) {
+            return &CSSStyle::SetGridColumnEnd;
+          }
+          if (NameEquals(name, "gridColumnStart")) {
+            return &CSSStyle::SetGridColumnStart;
+          }
+          break;
+        case 'j':
+          if (NameEquals(name, "justify-content")) {
+            return &CSSStyle::SetJustifyContent;
+          }
+          break;
+      }
+      break;
+    case 16:
+      if (NameEquals(name, "gridTemplateRows")) {
+        return &CSSStyle::SetGridTemplateRows;
+      }
+      break;
+    case 17:
+      if (NameEquals(name, "grid-column-start")) {
+        return &CSSStyle::SetGridColumnStart;
+      }
+      break;
+    case 18:
+      if (NameEquals(name, "grid-template-rows")) {
+        return &CSSStyle::SetGridTemplateRows;
+      }
+      break;
+    case 19:
+      if (NameEquals(name, "gridTemplateColumns")) {
+        return &CSSStyle::SetGridTemplateColumns;
+      }
+      break;
+    case 21:
+      if (NameEquals(name, "grid-template-columns")) {
+        return &CSSStyle::SetGridTemplateColumns;
+      }
+      break;
+  }
+  return nullptr;
+}
+
+// `auto`, `<number>fr` or a length in pixels
+bool ToGridTrackSize(std::string_view value, GridTrackSize& track) {
+  if (value == "auto") {
+    track = GridTrackSize(kGridTrackAuto, .0f);
+    return true;
+  }
+  if (value.size() > 2 && value.substr(value.size() - 2) == "fr") {
+    float fraction;
+    if (!base::StringToFloat(value.substr(0, value.size() - 2), fraction) ||
+        fraction < 0) {
+      return false;
+    }
+    track = GridTrackSize(kGridTrackFraction, fraction);
+    return true;
+  }
+  Length length(base::kLengthAuto);
+  if (!base::ToLength(value, length) || !length.IsFixed()) {
+    return false;
+  }
+  track = GridTrackSize(kGridTrackFixed, length.value());
+  return true;
+}
+
+/**
+ * `none`, or track sizes separated by spaces, where `repeat(<count>, <track
+ * sizes>)` stands for its tracks `count` times. returns false for anything
+ * else or more than GridTrackList::kMaxCount tracks.
+ */
+bool ToGridTrackList(std::string_view value, GridTrackList& tracks) {
+  GridTrackList parsed;
+  value = base::TrimString(value);
+  if (value == "none") {
+    tracks = parsed;
+    return true;
+  }
+  while (!value.empty()) {
+    size_t repeat_count = 1;
+    std::string_view sizes;
+    if (value.substr(0, 7) == "repeat(") {
+      size_t comma = value.find(',');
+      size_t close = value.find(')');
+      int64_t count = 0;
+      if (comma == std::string_view::npos || close == std::string_view::npos ||
+          comma > close ||
+          !base::StringToInt(base::TrimString(value.substr(7, comma - 7)),
+                             count) ||
+          count < 1) {
+        return false;
+      }
+      repeat_count = count;
+      sizes = value.substr(comma + 1, close - comma - 1);
+      value.remove_prefix(close + 1);
+    } else {
+      size_t end = std::min(value.find(' '), value.size());
+      sizes = value.substr(0, end);
+      value.remove_prefix(end);
+    }
+    // one more than fits, to tell a full list from one with tracks left over
+    std::string_view track_values[GridTrackList::kMaxCount + 1];
+    size_t track_count = base::SplitString(sizes, ' ', track_values,
+                                           GridTrackList::kMaxCount + 1);
+    // divided, the count of a repeat cannot overflow
+    if (track_count == 0 || track_count > GridTrackList::kMaxCount ||
+        repeat_count >
+            (GridTrackList::kMaxCount - parsed.count_) / track_count) {
+      return false;
+    }
+    for (size_t i = 0; i < repeat_count; ++i) {
+      for (size_t j = 0; j < track_count; ++j) {
+        if (!ToGridTrackSize(track_values[j],
+                             parsed.tracks_[parsed.count_++])) {
+          return false;
+        }
+      }
+    }
+    value = base::TrimString(value);
+  }
+  tracks = parsed;
+  return true;
+}
+
+// `auto`, a line number or `span <count>`, numbers are clamped to
+// GridLine::kMaxValue
+bool ToGridLine(std::string_view value, GridLine& line) {
+  value = base::TrimString(value);
+  if (value == "auto") {
+    line = GridLine();
+    return true;
+  }
+  bool span = false;
+  if (value.substr(0, 5) == "span ") {
+    span = true;
+    value = base::TrimString(value.substr(5));
+  }
+  int64_t number = 0;
+  if (!base::StringToInt(value, number) || number < 1 ||
+      number > std::numeric_limits<int>::max()) {
+    return false;
+  }
+  line = GridLine(number > GridLine::kMaxValue ? GridLine::kMaxValue
+                                                : static_cast<int>(number),
+                  span);
+  return true;
+}
+
+}  // namespace
 
 /**
  * default style values
@@ -101,6 +589,10 @@ const float CSS_STYLE_DEFAULT_BORDER_RIGHT_ = .0f;
 
 const PositionType CSS_STYLE_DEFAULT_POSITION_ = kPositionRelative;
 const DisplayType CSS_STYLE_DEFAULT_DISPLAY_ = kDisplayFlex;
+const Length CSS_STYLE_DEFAULT_TOP_ = Length(base::kLengthAuto);
+const Length CSS_STYLE_DEFAULT_LEFT_ = Length(base::kLengthAuto);
+const Length CSS_STYLE_DEFAULT_BOTTOM_ = Length(base::kLengthAuto);
+const Length CSS_STYLE_DEFAULT_RIGHT_ = Length(base::kLengthAuto);
 
 const Length CSS_STYLE_DEFAULT_FLEX_BASIS_ = Length(base::kLengthAuto);
 const float CSS_STYLE_DEFAULT_FLEX_GROW_ = .0f;
@@ -115,11 +607,156 @@ const AlignContentType CSS_STYLE_DEFAULT_ALIGN_CONTENT_ =
     kAlignContentFlexStart;
 const int CSS_STYLE_DEFAULT_ORDER_ = 0;
 
-CSSStyle::CSSStyle() {
+const GridTrackList CSS_STYLE_DEFAULT_GRID_TEMPLATE_ROWS_ = GridTrackList();
+const GridTrackList CSS_STYLE_DEFAULT_GRID_TEMPLATE_COLUMNS_ = GridTrackList();
+const GridLine CSS_STYLE_DEFAULT_GRID_ROW_START_ = GridLine();
+const GridLine CSS_STYLE_DEFAULT_GRID_ROW_END_ = GridLine();
+const GridLine CSS_STYLE_DEFAULT_GRID_COLUMN_START_ = GridLine();
+const GridLine CSS_STYLE_DEFAULT_GRID_COLUMN_END_ = GridLine();
+
+namespace {
+
+// assigns `value` and reports `change` if it differs from `field`
+template <typename T>
+inline StyleChangeType UpdateStyleValue(T& field,
+                                        const T& value,
+                                        StyleChangeType change) {
+  if (field == value) {
+    return kStyleChangeNone;
+  }
+  field = value;
+  return change;
+}
+
+// track lists are stored out of line, an empty one as null
+inline StyleChangeType UpdateGridTracks(
+    std::shared_ptr<const GridTrackList>& field,
+    const GridTrackList& value) {
+  if (field ? *field == value : value.count_ == 0) {
+    return kStyleChangeNone;
+  }
+  field = value.count_ == 0 ? nullptr
+                            : std::make_shared<const GridTrackList>(value);
+  return kStyleChangeChildrenSize;
+}
+
+inline void HashCombine(size_t& seed, size_t value) {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+inline void HashCombine(size_t& seed, float value) {
+  HashCombine(seed, std::hash<float>()(value));
+}
+
+inline void HashCombine(size_t& seed, const Length& value) {
+  HashCombine(seed, static_cast<size_t>(value.type()));
+  HashCombine(seed, value.value());
+}
+
+inline void HashCombine(size_t& seed, const GridTrackList& value) {
+  HashCombine(seed, value.count_);
+  for (size_t i = 0; i < value.count_; ++i) {
+    HashCombine(seed, static_cast<size_t>(value.tracks_[i].type_));
+    HashCombine(seed, value.tracks_[i].value_);
+  }
+}
+
+inline void HashCombine(size_t& seed, const GridLine& value) {
+  HashCombine(seed, static_cast<size_t>(value.value_));
+  HashCombine(seed, static_cast<size_t>(value.span_));
+}
+
+}  // namespace
+
+bool GridTrackList::operator==(const GridTrackList& other) const {
+  return count_ == other.count_ &&
+         std::equal(tracks_, tracks_ + count_, other.tracks_);
+}
+
+CSSStyle::CSSStyle() : ref_count_(0) {
   ResetAllStyles();
 }
 
-CSSStyle::~CSSStyle() {}
+bool CSSStyle::operator==(const CSSStyle& other) const {
+  return width_ == other.width_ && height_ == other.height_ &&
+         min_width_ == other.min_width_ && min_height_ == other.min_height_ &&
+         max_width_ == other.max_width_ && max_height_ == other.max_height_ &&
+         padding_top_ == other.padding_top_ &&
+         padding_left_ == other.padding_left_ &&
+         padding_bottom_ == other.padding_bottom_ &&
+         padding_right_ == other.padding_right_ &&
+         margin_top_ == other.margin_top_ &&
+         margin_left_ == other.margin_left_ &&
+         margin_bottom_ == other.margin_bottom_ &&
+         margin_right_ == other.margin_right_ &&
+         border_top_ == other.border_top_ &&
+         border_left_ == other.border_left_ &&
+         border_bottom_ == other.border_bottom_ &&
+         border_right_ == other.border_right_ &&
+         position_ == other.position_ && display_ == other.display_ &&
+         top_ == other.top_ && left_ == other.left_ &&
+         bottom_ == other.bottom_ && right_ == other.right_ &&
+         flex_basis_ == other.flex_basis_ &&
+         flex_grow_ == other.flex_grow_ &&
+         flex_shrink_ == other.flex_shrink_ &&
+         flex_direction_ == other.flex_direction_ &&
+         flex_wrap_ == other.flex_wrap_ &&
+         justify_content_ == other.justify_content_ &&
+         align_items_ == other.align_items_ &&
+         align_self_ == other.align_self_ &&
+         align_content_ == other.align_content_ && order_ == other.order_ &&
+         grid_template_rows() == other.grid_template_rows() &&
+         grid_template_columns() == other.grid_template_columns() &&
+         grid_row_start_ == other.grid_row_start_ &&
+         grid_row_end_ == other.grid_row_end_ &&
+         grid_column_start_ == other.grid_column_start_ &&
+         grid_column_end_ == other.grid_column_end_;
+}
+
+size_t CSSStyle::Hash() const {
+  size_t seed = 0;
+  HashCombine(seed, width_);
+  HashCombine(seed, height_);
+  HashCombine(seed, min_width_);
+  HashCombine(seed, min_height_);
+  HashCombine(seed, max_width_);
+  HashCombine(seed, max_height_);
+  HashCombine(seed, padding_top_);
+  HashCombine(seed, padding_left_);
+  HashCombine(seed, padding_bottom_);
+  HashCombine(seed, padding_right_);
+  HashCombine(seed, margin_top_);
+  HashCombine(seed, margin_left_);
+  HashCombine(seed, margin_bottom_);
+  HashCombine(seed, margin_right_);
+  HashCombine(seed, border_top_);
+  HashCombine(seed, border_left_);
+  HashCombine(seed, border_bottom_);
+  HashCombine(seed, border_right_);
+  HashCombine(seed, static_cast<size_t>(position_));
+  HashCombine(seed, static_cast<size_t>(display_));
+  HashCombine(seed, top_);
+  HashCombine(seed, left_);
+  HashCombine(seed, bottom_);
+  HashCombine(seed, right_);
+  HashCombine(seed, flex_basis_);
+  HashCombine(seed, flex_grow_);
+  HashCombine(seed, flex_shrink_);
+  HashCombine(seed, static_cast<size_t>(flex_direction_));
+  HashCombine(seed, static_cast<size_t>(flex_wrap_));
+  HashCombine(seed, static_cast<size_t>(justify_content_));
+  HashCombine(seed, static_cast<size_t>(align_items_));
+  HashCombine(seed, static_cast<size_t>(align_self_));
+  HashCombine(seed, static_cast<size_t>(align_content_));
+  HashCombine(seed, static_cast<size_t>(order_));
+  HashCombine(seed, grid_template_rows());
+  HashCombine(seed, grid_template_columns());
+  HashCombine(seed, grid_row_start_);
+  HashCombine(seed, grid_row_end_);
+  HashCombine(seed, grid_column_start_);
+  HashCombine(seed, grid_column_end_);
+  return seed;
+}
 
 void CSSStyle::ResetAllStyles() {
   width_ = CSS_STYLE_DEFAULT_WIDTH_;
@@ -144,6 +781,10 @@ void CSSStyle::ResetAllStyles() {
   // display style
   position_ = CSS_STYLE_DEFAULT_POSITION_;
   display_ = CSS_STYLE_DEFAULT_DISPLAY_;
+  top_ = CSS_STYLE_DEFAULT_TOP_;
+  left_ = CSS_STYLE_DEFAULT_LEFT_;
+  bottom_ = CSS_STYLE_DEFAULT_BOTTOM_;
+  right_ = CSS_STYLE_DEFAULT_RIGHT_;
 
   // flex style
   flex_basis_ = CSS_STYLE_DEFAULT_FLEX_BASIS_;
@@ -156,17 +797,350 @@ void CSSStyle::ResetAllStyles() {
   align_self_ = CSS_STYLE_DEFAULT_ALIGN_SELF_;
   align_content_ = CSS_STYLE_DEFAULT_ALIGN_CONTENT_;
   order_ = CSS_STYLE_DEFAULT_ORDER_;
+
+  // grid style
+  grid_template_rows_ = nullptr;
+  grid_template_columns_ = nullptr;
+  grid_row_start_ = CSS_STYLE_DEFAULT_GRID_ROW_START_;
+  grid_row_end_ = CSS_STYLE_DEFAULT_GRID_ROW_END_;
+  grid_column_start_ = CSS_STYLE_DEFAULT_GRID_COLUMN_START_;
+  grid_column_end_ = CSS_STYLE_DEFAULT_GRID_COLUMN_END_;
+}
+
+StyleChangeType CSSStyle::SetStyle(std::string_view name,
+                                   std::string_view value,
+                                   bool reset) {
+  StyleFunc func = FindStyleSetter(name);
+  if (func == nullptr) {
+    return kStyleChangeNone;
+  }
+  return (this->*func)(value, reset);
 }
 
-void CSSStyle::SetStyle(const std::string& name,
-                        const std::string& value,
-                        bool reset) {
-  StyleFuncMap::iterator iter = style_setters_.find(name);
-  if (iter == style_setters_.end()) {
-    return;
+/**
+ * typed setters take values as they are stored, a value whose type does not
+ * match the property is ignored
+ */
+StyleChangeType CSSStyle::SetStyle(StyleProperty property,
+                                   const Length& value) {
+  switch (property) {
+    case kStylePropertyWidth:
+      return UpdateStyleValue(width_, value, kStyleChangeSelfSize);
+    case kStylePropertyHeight:
+      return UpdateStyleValue(height_, value, kStyleChangeSelfSize);
+    case kStylePropertyMinWidth:
+      return UpdateStyleValue(min_width_, value, kStyleChangeSelfSize);
+    case kStylePropertyMinHeight:
+      return UpdateStyleValue(min_height_, value, kStyleChangeSelfSize);
+    case kStylePropertyMaxWidth:
+      return UpdateStyleValue(max_width_, value, kStyleChangeSelfSize);
+    case kStylePropertyMaxHeight:
+      return UpdateStyleValue(max_height_, value, kStyleChangeSelfSize);
+    case kStylePropertyPadding: {
+      // sides change the same way
+      return std::max({SetStyle(kStylePropertyPaddingTop, value),
+                       SetStyle(kStylePropertyPaddingLeft, value),
+                       SetStyle(kStylePropertyPaddingBottom, value),
+                       SetStyle(kStylePropertyPaddingRight, value)});
+    }
+    case kStylePropertyPaddingTop:
+      return UpdateStyleValue(padding_top_, value, kStyleChangeChildrenSize);
+    case kStylePropertyPaddingLeft:
+      return UpdateStyleValue(padding_left_, value, kStyleChangeChildrenSize);
+    case kStylePropertyPaddingBottom:
+      return UpdateStyleValue(padding_bottom_, value, kStyleChangeChildrenSize);
+    case kStylePropertyPaddingRight:
+      return UpdateStyleValue(padding_right_, value, kStyleChangeChildrenSize);
+    case kStylePropertyMargin: {
+      // sides change the same way
+      return std::max({SetStyle(kStylePropertyMarginTop, value),
+                       SetStyle(kStylePropertyMarginLeft, value),
+                       SetStyle(kStylePropertyMarginBottom, value),
+                       SetStyle(kStylePropertyMarginRight, value)});
+    }
+    case kStylePropertyMarginTop:
+      return UpdateStyleValue(margin_top_, value, kStyleChangeSelfSize);
+    case kStylePropertyMarginLeft:
+      return UpdateStyleValue(margin_left_, value, kStyleChangeSelfSize);
+    case kStylePropertyMarginBottom:
+      return UpdateStyleValue(margin_bottom_, value, kStyleChangeSelfSize);
+    case kStylePropertyMarginRight:
+      return UpdateStyleValue(margin_right_, value, kStyleChangeSelfSize);
+    // insets only move an out-of-flow node inside its parent
+    case kStylePropertyTop:
+      return UpdateStyleValue(top_, value, kStyleChangeAlignment);
+    case kStylePropertyLeft:
+      return UpdateStyleValue(left_, value, kStyleChangeAlignment);
+    case kStylePropertyBottom:
+      return UpdateStyleValue(bottom_, value, kStyleChangeAlignment);
+    case kStylePropertyRight:
+      return UpdateStyleValue(right_, value, kStyleChangeAlignment);
+    case kStylePropertyFlexBasis:
+      return UpdateStyleValue(flex_basis_, value, kStyleChangeSelfSize);
+    default:
+      return kStyleChangeNone;
+  }
+}
+
+StyleChangeType CSSStyle::SetStyle(StyleProperty property, float value) {
+  switch (property) {
+    case kStylePropertyBorder: {
+      // sides change the same way
+      return std::max({SetStyle(kStylePropertyBorderTop, value),
+                       SetStyle(kStylePropertyBorderLeft, value),
+                       SetStyle(kStylePropertyBorderBottom, value),
+                       SetStyle(kStylePropertyBorderRight, value)});
+    }
+    case kStylePropertyBorderTop:
+      return UpdateStyleValue(border_top_, value, kStyleChangeChildrenSize);
+    case kStylePropertyBorderLeft:
+      return UpdateStyleValue(border_left_, value, kStyleChangeChildrenSize);
+    case kStylePropertyBorderBottom:
+      return UpdateStyleValue(border_bottom_, value, kStyleChangeChildrenSize);
+    case kStylePropertyBorderRight:
+      return UpdateStyleValue(border_right_, value, kStyleChangeChildrenSize);
+    case kStylePropertyFlex: {
+      // `flex: <positive-number>`
+      return std::max(
+          {SetStyle(kStylePropertyFlexBasis, Length(base::kLengthFixed)),
+           SetStyle(kStylePropertyFlexGrow, value),
+           SetStyle(kStylePropertyFlexShrink, 1.0f)});
+    }
+    case kStylePropertyFlexGrow:
+      return UpdateStyleValue(flex_grow_, value, kStyleChangeSelfSize);
+    case kStylePropertyFlexShrink:
+      return UpdateStyleValue(flex_shrink_, value, kStyleChangeSelfSize);
+    case kStylePropertyOrder:
+      return SetStyle(property, static_cast<int>(value));
+    default:
+      return kStyleChangeNone;
+  }
+}
+
+StyleChangeType CSSStyle::SetStyle(StyleProperty property, int value) {
+  if (property != kStylePropertyOrder) {
+    return SetStyle(property, static_cast<float>(value));
+  }
+  return UpdateStyleValue(order_, value, kStyleChangeSelfSize);
+}
+
+StyleChangeType CSSStyle::SetStyle(StyleProperty property, PositionType value) {
+  if (property != kStylePropertyPosition || position_ == value) {
+    return kStyleChangeNone;
+  }
+  position_ = value;
+  return kStyleChangeSelfSize;
+}
+
+StyleChangeType CSSStyle::SetStyle(StyleProperty property, DisplayType value) {
+  if (property != kStylePropertyDisplay || display_ == value) {
+    return kStyleChangeNone;
+  }
+  display_ = value;
+  return kStyleChangeChildrenSize;
+}
+
+StyleChangeType CSSStyle::SetStyle(StyleProperty property,
+                                   FlexDirectionType value) {
+  if (property != kStylePropertyFlexDirection || flex_direction_ == value) {
+    return kStyleChangeNone;
+  }
+  flex_direction_ = value;
+  return kStyleChangeChildrenSize;
+}
+
+StyleChangeType CSSStyle::SetStyle(StyleProperty property, FlexWrapType value) {
+  if (property != kStylePropertyFlexWrap || flex_wrap_ == value) {
+    return kStyleChangeNone;
+  }
+  flex_wrap_ = value;
+  return kStyleChangeChildrenSize;
+}
+
+StyleChangeType CSSStyle::SetStyle(StyleProperty property,
+                                   JustifyContentType value) {
+  if (property != kStylePropertyJustifyContent || justify_content_ == value) {
+    return kStyleChangeNone;
   }
-  StyleFunc func = iter->second;
-  (this->*func)(value, reset);
+  justify_content_ = value;
+  return kStyleChangeAlignment;
+}
+
+StyleChangeType CSSStyle::SetStyle(StyleProperty property,
+                                   AlignItemsType value) {
+  if (property != kStylePropertyAlignItems || align_items_ == value) {
+    return kStyleChangeNone;
+  }
+  AlignItemsType align_items = align_items_;
+  align_items_ = value;
+  // stretched items are sized by the container, other values only move them
+  return align_items_ == kAlignItemsStretch || align_items == kAlignItemsStretch
+             ? kStyleChangeChildrenSize
+             : kStyleChangeAlignment;
+}
+
+StyleChangeType CSSStyle::SetStyle(StyleProperty property,
+                                   AlignSelfType value) {
+  if (property != kStylePropertyAlignSelf || align_self_ == value) {
+    return kStyleChangeNone;
+  }
+  AlignSelfType align_self = align_self_;
+  align_self_ = value;
+  // `auto` may resolve to stretch, which sizes the item
+  bool may_stretch = align_self_ == kAlignSelfStretch ||
+                     align_self_ == kAlignSelfAuto ||
+                     align_self == kAlignSelfStretch ||
+                     align_self == kAlignSelfAuto;
+  return may_stretch ? kStyleChangeSelfSize : kStyleChangeAlignment;
+}
+
+StyleChangeType CSSStyle::SetStyle(StyleProperty property,
+                                   AlignContentType value) {
+  if (property != kStylePropertyAlignContent || align_content_ == value) {
+    return kStyleChangeNone;
+  }
+  AlignContentType align_content = align_content_;
+  align_content_ = value;
+  // stretch expands flex lines, other values only move them
+  return align_content_ == kAlignContentStretch ||
+                 align_content == kAlignContentStretch
+             ? kStyleChangeChildrenSize
+             : kStyleChangeAlignment;
+}
+
+StyleChangeType CSSStyle::SetStyle(StyleProperty property,
+                                   const GridTrackList& value) {
+  switch (property) {
+    case kStylePropertyGridTemplateRows:
+      return UpdateGridTracks(grid_template_rows_, value);
+    case kStylePropertyGridTemplateColumns:
+      return UpdateGridTracks(grid_template_columns_, value);
+    default:
+      return kStyleChangeNone;
+  }
+}
+
+StyleChangeType CSSStyle::SetStyle(StyleProperty property,
+                                   const GridLine& value) {
+  switch (property) {
+    case kStylePropertyGridRowStart:
+      return UpdateStyleValue(grid_row_start_, value, kStyleChangeSelfSize);
+    case kStylePropertyGridRowEnd:
+      return UpdateStyleValue(grid_row_end_, value, kStyleChangeSelfSize);
+    case kStylePropertyGridColumnStart:
+      return UpdateStyleValue(grid_column_start_, value, kStyleChangeSelfSize);
+    case kStylePropertyGridColumnEnd:
+      return UpdateStyleValue(grid_column_end_, value, kStyleChangeSelfSize);
+    default:
+      return kStyleChangeNone;
+  }
+}
+
+/**
+ * declarations are separated by ';', name and value by ':'. malformed ones are
+ * skipped. the changes are returned as a bit set of StyleChangeType.
+ */
+unsigned CSSStyle::SetStyles(std::string_view declarations) {
+  unsigned changes = 0;
+  while (!declarations.empty()) {
+    size_t end = std::min(declarations.find(';'), declarations.size());
+    std::string_view declaration = declarations.substr(0, end);
+    declarations.remove_prefix(std::min(end + 1, declarations.size()));
+    size_t colon = declaration.find(':');
+    if (colon == std::string_view::npos) {
+      continue;
+    }
+    changes |= StyleChangeBit(
+        SetStyle(base::TrimString(declaration.substr(0, colon)),
+                 base::TrimString(declaration.substr(colon + 1))));
+  }
+  return changes;
+}
+
+/**
+ * takes over all values of `other`, the changes are returned as a bit set of
+ * StyleChangeType
+ */
+unsigned CSSStyle::SetAllStyles(const CSSStyle& other) {
+  unsigned changes = 0;
+  changes |= StyleChangeBit(SetStyle(kStylePropertyWidth, other.width_));
+  changes |= StyleChangeBit(SetStyle(kStylePropertyHeight, other.height_));
+  changes |= StyleChangeBit(SetStyle(kStylePropertyMinWidth, other.min_width_));
+  changes |=
+      StyleChangeBit(SetStyle(kStylePropertyMinHeight, other.min_height_));
+  changes |= StyleChangeBit(SetStyle(kStylePropertyMaxWidth, other.max_width_));
+  changes |=
+      StyleChangeBit(SetStyle(kStylePropertyMaxHeight, other.max_height_));
+  changes |=
+      StyleChangeBit(SetStyle(kStylePropertyPaddingTop, other.padding_top_));
+  changes |=
+      StyleChangeBit(SetStyle(kStylePropertyPaddingLeft, other.padding_left_));
+  changes |= StyleChangeBit(
+      SetStyle(kStylePropertyPaddingBottom, other.padding_bottom_));
+  changes |= StyleChangeBit(
+      SetStyle(kStylePropertyPaddingRight, other.padding_right_));
+  changes |=
+      StyleChangeBit(SetStyle(kStylePropertyMarginTop, other.margin_top_));
+  changes |=
+      StyleChangeBit(SetStyle(kStylePropertyMarginLeft, other.margin_left_));
+  changes |= StyleChangeBit(
+      SetStyle(kStylePropertyMarginBottom, other.margin_bottom_));
+  changes |=
+      StyleChangeBit(SetStyle(kStylePropertyMarginRight, other.margin_right_));
+  changes |=
+      StyleChangeBit(SetStyle(kStylePropertyBorderTop, other.border_top_));
+  changes |=
+      StyleChangeBit(SetStyle(kStylePropertyBorderLeft, other.border_left_));
+  changes |= StyleChangeBit(
+      SetStyle(kStylePropertyBorderBottom, other.border_bottom_));
+  changes |=
+      StyleChangeBit(SetStyle(kStylePropertyBorderRight, other.border_right_));
+  changes |= StyleChangeBit(SetStyle(kStylePropertyPosition, other.position_));
+  changes |= StyleChangeBit(SetStyle(kStylePropertyDisplay, other.display_));
+  changes |= StyleChangeBit(SetStyle(kStylePropertyTop, other.top_));
+  changes |= StyleChangeBit(SetStyle(kStylePropertyLeft, other.left_));
+  changes |= StyleChangeBit(SetStyle(kStylePropertyBottom, other.bottom_));
+  changes |= StyleChangeBit(SetStyle(kStylePropertyRight, other.right_));
+  changes |=
+      StyleChangeBit(SetStyle(kStylePropertyFlexBasis, other.flex_basis_));
+  changes |= StyleChangeBit(SetStyle(kStylePropertyFlexGrow, other.flex_grow_));
+  changes |=
+      StyleChangeBit(SetStyle(kStylePropertyFlexShrink, other.flex_shrink_));
+  changes |= StyleChangeBit(
+      SetStyle(kStylePropertyFlexDirection, other.flex_direction_));
+  changes |= StyleChangeBit(SetStyle(kStylePropertyFlexWrap, other.flex_wrap_));
+  changes |= StyleChangeBit(
+      SetStyle(kStylePropertyJustifyContent, other.justify_content_));
+  changes |=
+      StyleChangeBit(SetStyle(kStylePropertyAlignItems, other.align_items_));
+  changes |=
+      StyleChangeBit(SetStyle(kStylePropertyAlignSelf, other.align_self_));
+  changes |= StyleChangeBit(
+      SetStyle(kStylePropertyAlignContent, other.align_content_));
+  changes |= StyleChangeBit(SetStyle(kStylePropertyOrder, other.order_));
+  changes |= StyleChangeBit(
+      SetStyle(kStylePropertyGridTemplateRows, other.grid_template_rows()));
+  changes |= StyleChangeBit(SetStyle(kStylePropertyGridTemplateColumns,
+                                     other.grid_template_columns()));
+  changes |= StyleChangeBit(
+      SetStyle(kStylePropertyGridRowStart, other.grid_row_start_));
+  changes |=
+      StyleChangeBit(SetStyle(kStylePropertyGridRowEnd, other.grid_row_end_));
+  changes |= StyleChangeBit(
+      SetStyle(kStylePropertyGridColumnStart, other.grid_column_start_));
+  changes |= StyleChangeBit(
+      SetStyle(kStylePropertyGridColumnEnd, other.grid_column_end_));
+  return changes;
+}
+
+const GridTrackList& CSSStyle::grid_template_rows() const {
+  return grid_template_rows_ ? *grid_template_rows_
+                             : CSS_STYLE_DEFAULT_GRID_TEMPLATE_ROWS_;
+}
+
+const GridTrackList& CSSStyle::grid_template_columns() const {
+  return grid_template_columns_ ? *grid_template_columns_
+                                : CSS_STYLE_DEFAULT_GRID_TEMPLATE_COLUMNS_;
 }
 
 bool CSSStyle::IsMainAxisHorizontal() const {
@@ -185,258 +1159,292 @@ void CSSStyle::Print() const {
   std::cout << "height: " << height_.value() << std::endl;
 }
 
-void CSSStyle::SetWidth(const std::string& value, bool reset) {
-  if (reset) {
-    width_ = CSS_STYLE_DEFAULT_WIDTH_;
-  }
-  base::ToLength(value, width_);
+StyleChangeType CSSStyle::SetWidth(std::string_view value, bool reset) {
+  Length width = reset ? CSS_STYLE_DEFAULT_WIDTH_ : width_;
+  base::ToLength(value, width);
+  return SetStyle(kStylePropertyWidth, width);
 }
 
-void CSSStyle::SetHeight(const std::string& value, bool reset) {
-  if (reset) {
-    height_ = CSS_STYLE_DEFAULT_HEIGHT_;
-  }
-  base::ToLength(value, height_);
+StyleChangeType CSSStyle::SetHeight(std::string_view value, bool reset) {
+  Length height = reset ? CSS_STYLE_DEFAULT_HEIGHT_ : height_;
+  base::ToLength(value, height);
+  return SetStyle(kStylePropertyHeight, height);
 }
 
-void CSSStyle::SetMinWidth(const std::string& value, bool reset) {
-  if (reset) {
-    min_width_ = CSS_STYLE_DEFAULT_MIN_WIDTH_;
-  }
-  base::ToLength(value, min_width_);
+StyleChangeType CSSStyle::SetMinWidth(std::string_view value, bool reset) {
+  Length min_width = reset ? CSS_STYLE_DEFAULT_MIN_WIDTH_ : min_width_;
+  base::ToLength(value, min_width);
+  return SetStyle(kStylePropertyMinWidth, min_width);
 }
 
-void CSSStyle::SetMinHeight(const std::string& value, bool reset) {
-  if (reset) {
-    min_height_ = CSS_STYLE_DEFAULT_MIN_HEIGHT_;
-  }
-  base::ToLength(value, min_height_);
+StyleChangeType CSSStyle::SetMinHeight(std::string_view value, bool reset) {
+  Length min_height = reset ? CSS_STYLE_DEFAULT_MIN_HEIGHT_ : min_height_;
+  base::ToLength(value, min_height);
+  return SetStyle(kStylePropertyMinHeight, min_height);
 }
 
-void CSSStyle::SetMaxWidth(const std::string& value, bool reset) {
-  if (reset) {
-    max_width_ = CSS_STYLE_DEFAULT_MAX_WIDTH_;
-  }
-  base::ToLength(value, max_width_);
+StyleChangeType CSSStyle::SetMaxWidth(std::string_view value, bool reset) {
+  Length max_width = reset ? CSS_STYLE_DEFAULT_MAX_WIDTH_ : max_width_;
+  base::ToLength(value, max_width);
+  return SetStyle(kStylePropertyMaxWidth, max_width);
 }
 
-void CSSStyle::SetMaxHeight(const std::string& value, bool reset) {
-  if (reset) {
-    max_height_ = CSS_STYLE_DEFAULT_MAX_HEIGHT_;
-  }
-  base::ToLength(value, max_height_);
+StyleChangeType CSSStyle::SetMaxHeight(std::string_view value, bool reset) {
+  Length max_height = reset ? CSS_STYLE_DEFAULT_MAX_HEIGHT_ : max_height_;
+  base::ToLength(value, max_height);
+  return SetStyle(kStylePropertyMaxHeight, max_height);
 }
 
-void CSSStyle::SetPadding(const std::string& value, bool reset) {
+StyleChangeType CSSStyle::SetPadding(std::string_view value, bool reset) {
+  Length padding_top = padding_top_;
+  Length padding_left = padding_left_;
+  Length padding_bottom = padding_bottom_;
+  Length padding_right = padding_right_;
   if (reset) {
     padding_top_ = CSS_STYLE_DEFAULT_PADDING_TOP_;
     padding_left_ = CSS_STYLE_DEFAULT_PADDING_LEFT_;
     padding_bottom_ = CSS_STYLE_DEFAULT_PADDING_BOTTOM_;
     padding_right_ = CSS_STYLE_DEFAULT_PADDING_RIGHT_;
   }
-  std::vector<std::string> values;
-  base::SplitString(value, ' ', values);
-  if (values.size() == 1) {
+  std::string_view values[4];
+  size_t count = base::SplitString(value, ' ', values, 4);
+  if (count == 1) {
     SetPaddingTop(values[0]);
     SetPaddingLeft(values[0]);
     SetPaddingBottom(values[0]);
     SetPaddingRight(values[0]);
-  } else if (values.size() == 2) {
+  } else if (count == 2) {
     SetPaddingTop(values[0]);
     SetPaddingLeft(values[1]);
     SetPaddingBottom(values[0]);
     SetPaddingRight(values[1]);
-  } else if (values.size() == 3) {
+  } else if (count == 3) {
     SetPaddingTop(values[0]);
     SetPaddingLeft(values[1]);
     SetPaddingBottom(values[2]);
     SetPaddingRight(values[1]);
-  } else if (values.size() > 3) {
+  } else if (count > 3) {
     SetPaddingTop(values[0]);
     SetPaddingLeft(values[3]);
     SetPaddingBottom(values[2]);
     SetPaddingRight(values[1]);
   }
+
+  bool changed = padding_top_ != padding_top || padding_left_ != padding_left ||
+                 padding_bottom_ != padding_bottom ||
+                 padding_right_ != padding_right;
+  return changed ? kStyleChangeChildrenSize : kStyleChangeNone;
 }
 
-void CSSStyle::SetPaddingTop(const std::string& value, bool reset) {
-  if (reset) {
-    padding_top_ = CSS_STYLE_DEFAULT_PADDING_TOP_;
-  }
-  base::ToLength(value, padding_top_);
+StyleChangeType CSSStyle::SetPaddingTop(std::string_view value, bool reset) {
+  Length padding_top = reset ? CSS_STYLE_DEFAULT_PADDING_TOP_ : padding_top_;
+  base::ToLength(value, padding_top);
+  return SetStyle(kStylePropertyPaddingTop, padding_top);
 }
 
-void CSSStyle::SetPaddingLeft(const std::string& value, bool reset) {
-  if (reset) {
-    padding_left_ = CSS_STYLE_DEFAULT_PADDING_LEFT_;
-  }
-  base::ToLength(value, padding_left_);
+StyleChangeType CSSStyle::SetPaddingLeft(std::string_view value, bool reset) {
+  Length padding_left = reset ? CSS_STYLE_DEFAULT_PADDING_LEFT_ : padding_left_;
+  base::ToLength(value, padding_left);
+  return SetStyle(kStylePropertyPaddingLeft, padding_left);
 }
 
-void CSSStyle::SetPaddingBottom(const std::string& value, bool reset) {
-  if (reset) {
-    padding_bottom_ = CSS_STYLE_DEFAULT_PADDING_BOTTOM_;
-  }
-  base::ToLength(value, padding_bottom_);
+StyleChangeType CSSStyle::SetPaddingBottom(std::string_view value, bool reset) {
+  Length padding_bottom =
+      reset ? CSS_STYLE_DEFAULT_PADDING_BOTTOM_ : padding_bottom_;
+  base::ToLength(value, padding_bottom);
+  return SetStyle(kStylePropertyPaddingBottom, padding_bottom);
 }
 
-void CSSStyle::SetPaddingRight(const std::string& value, bool reset) {
-  if (reset) {
-    padding_right_ = CSS_STYLE_DEFAULT_PADDING_RIGHT_;
-  }
-  base::ToLength(value, padding_right_);
+StyleChangeType CSSStyle::SetPaddingRight(std::string_view value, bool reset) {
+  Length padding_right =
+      reset ? CSS_STYLE_DEFAULT_PADDING_RIGHT_ : padding_right_;
+  base::ToLength(value, padding_right);
+  return SetStyle(kStylePropertyPaddingRight, padding_right);
 }
 
-void CSSStyle::SetMargin(const std::string& value, bool reset) {
+StyleChangeType CSSStyle::SetMargin(std::string_view value, bool reset) {
+  Length margin_top = margin_top_;
+  Length margin_left = margin_left_;
+  Length margin_bottom = margin_bottom_;
+  Length margin_right = margin_right_;
   if (reset) {
     margin_top_ = CSS_STYLE_DEFAULT_MARGIN_TOP_;
     margin_left_ = CSS_STYLE_DEFAULT_MARGIN_LEFT_;
     margin_bottom_ = CSS_STYLE_DEFAULT_MARGIN_BOTTOM_;
     margin_right_ = CSS_STYLE_DEFAULT_MARGIN_RIGHT_;
   }
-  std::vector<std::string> values;
-  base::SplitString(value, ' ', values);
-  if (values.size() == 1) {
+  std::string_view values[4];
+  size_t count = base::SplitString(value, ' ', values, 4);
+  if (count == 1) {
     SetMarginTop(values[0]);
     SetMarginLeft(values[0]);
     SetMarginBottom(values[0]);
     SetMarginRight(values[0]);
-  } else if (values.size() == 2) {
+  } else if (count == 2) {
     SetMarginTop(values[0]);
     SetMarginLeft(values[1]);
     SetMarginBottom(values[0]);
     SetMarginRight(values[1]);
-  } else if (values.size() == 3) {
+  } else if (count == 3) {
     SetMarginTop(values[0]);
     SetMarginLeft(values[1]);
     SetMarginBottom(values[2]);
     SetMarginRight(values[1]);
-  } else if (values.size() > 3) {
+  } else if (count > 3) {
     SetMarginTop(values[0]);
     SetMarginLeft(values[3]);
     SetMarginBottom(values[2]);
     SetMarginRight(values[1]);
   }
+
+  bool changed = margin_top_ != margin_top || margin_left_ != margin_left ||
+                 margin_bottom_ != margin_bottom ||
+                 margin_right_ != margin_right;
+  return changed ? kStyleChangeSelfSize : kStyleChangeNone;
 }
 
-void CSSStyle::SetMarginTop(const std::string& value, bool reset) {
-  if (reset) {
-    margin_top_ = CSS_STYLE_DEFAULT_MARGIN_TOP_;
-  }
-  base::ToLength(value, margin_top_);
+StyleChangeType CSSStyle::SetMarginTop(std::string_view value, bool reset) {
+  Length margin_top = reset ? CSS_STYLE_DEFAULT_MARGIN_TOP_ : margin_top_;
+  base::ToLength(value, margin_top);
+  return SetStyle(kStylePropertyMarginTop, margin_top);
 }
 
-void CSSStyle::SetMarginLeft(const std::string& value, bool reset) {
-  if (reset) {
-    margin_left_ = CSS_STYLE_DEFAULT_MARGIN_LEFT_;
-  }
-  base::ToLength(value, margin_left_);
+StyleChangeType CSSStyle::SetMarginLeft(std::string_view value, bool reset) {
+  Length margin_left = reset ? CSS_STYLE_DEFAULT_MARGIN_LEFT_ : margin_left_;
+  base::ToLength(value, margin_left);
+  return SetStyle(kStylePropertyMarginLeft, margin_left);
 }
 
-void CSSStyle::SetMarginBottom(const std::string& value, bool reset) {
-  if (reset) {
-    margin_bottom_ = CSS_STYLE_DEFAULT_MARGIN_BOTTOM_;
-  }
-  base::ToLength(value, margin_bottom_);
+StyleChangeType CSSStyle::SetMarginBottom(std::string_view value, bool reset) {
+  Length margin_bottom =
+      reset ? CSS_STYLE_DEFAULT_MARGIN_BOTTOM_ : margin_bottom_;
+  base::ToLength(value, margin_bottom);
+  return SetStyle(kStylePropertyMarginBottom, margin_bottom);
 }
 
-void CSSStyle::SetMarginRight(const std::string& value, bool reset) {
-  if (reset) {
-    margin_right_ = CSS_STYLE_DEFAULT_MARGIN_RIGHT_;
-  }
-  base::ToLength(value, margin_right_);
+StyleChangeType CSSStyle::SetMarginRight(std::string_view value, bool reset) {
+  Length margin_right = reset ? CSS_STYLE_DEFAULT_MARGIN_RIGHT_ : margin_right_;
+  base::ToLength(value, margin_right);
+  return SetStyle(kStylePropertyMarginRight, margin_right);
 }
 
-void CSSStyle::SetBorder(const std::string& value, bool reset) {
+StyleChangeType CSSStyle::SetBorder(std::string_view value, bool reset) {
+  float border_top = border_top_;
+  float border_left = border_left_;
+  float border_bottom = border_bottom_;
+  float border_right = border_right_;
   if (reset) {
     border_top_ = CSS_STYLE_DEFAULT_BORDER_TOP_;
     border_left_ = CSS_STYLE_DEFAULT_BORDER_LEFT_;
     border_bottom_ = CSS_STYLE_DEFAULT_BORDER_BOTTOM_;
     border_right_ = CSS_STYLE_DEFAULT_BORDER_RIGHT_;
   }
-  std::vector<std::string> values;
-  base::SplitString(value, ' ', values);
-  if (values.size() == 1) {
+  std::string_view values[4];
+  size_t count = base::SplitString(value, ' ', values, 4);
+  if (count == 1) {
     SetBorderTop(values[0]);
     SetBorderLeft(values[0]);
     SetBorderBottom(values[0]);
     SetBorderRight(values[0]);
-  } else if (values.size() == 2) {
+  } else if (count == 2) {
     SetBorderTop(values[0]);
     SetBorderLeft(values[1]);
     SetBorderBottom(values[0]);
     SetBorderRight(values[1]);
-  } else if (values.size() == 3) {
+  } else if (count == 3) {
     SetBorderTop(values[0]);
     SetBorderLeft(values[1]);
     SetBorderBottom(values[2]);
     SetBorderRight(values[1]);
-  } else if (values.size() > 3) {
+  } else if (count > 3) {
     SetBorderTop(values[0]);
     SetBorderLeft(values[3]);
     SetBorderBottom(values[2]);
     SetBorderRight(values[1]);
   }
+
+  bool changed = border_top_ != border_top || border_left_ != border_left ||
+                 border_bottom_ != border_bottom ||
+                 border_right_ != border_right;
+  return changed ? kStyleChangeChildrenSize : kStyleChangeNone;
 }
 
-void CSSStyle::SetBorderTop(const std::string& value, bool reset) {
-  if (reset) {
-    border_top_ = CSS_STYLE_DEFAULT_BORDER_TOP_;
-  }
+StyleChangeType CSSStyle::SetBorderTop(std::string_view value, bool reset) {
   Length length_value = Length();
   base::ToLength(value, length_value);
-  border_top_ = length_value.value();
+  return SetStyle(kStylePropertyBorderTop, length_value.value());
 }
 
-void CSSStyle::SetBorderLeft(const std::string& value, bool reset) {
-  if (reset) {
-    border_left_ = CSS_STYLE_DEFAULT_BORDER_LEFT_;
-  }
+StyleChangeType CSSStyle::SetBorderLeft(std::string_view value, bool reset) {
   Length length_value = Length();
   base::ToLength(value, length_value);
-  border_left_ = length_value.value();
+  return SetStyle(kStylePropertyBorderLeft, length_value.value());
 }
 
-void CSSStyle::SetBorderBottom(const std::string& value, bool reset) {
-  if (reset) {
-    border_bottom_ = CSS_STYLE_DEFAULT_BORDER_BOTTOM_;
-  }
+StyleChangeType CSSStyle::SetBorderBottom(std::string_view value, bool reset) {
   Length length_value = Length();
   base::ToLength(value, length_value);
-  border_bottom_ = length_value.value();
+  return SetStyle(kStylePropertyBorderBottom, length_value.value());
 }
 
-void CSSStyle::SetBorderRight(const std::string& value, bool reset) {
-  if (reset) {
-    border_right_ = CSS_STYLE_DEFAULT_BORDER_RIGHT_;
-  }
+StyleChangeType CSSStyle::SetBorderRight(std::string_view value, bool reset) {
   Length length_value = Length();
   base::ToLength(value, length_value);
-  border_right_ = length_value.value();
+  return SetStyle(kStylePropertyBorderRight, length_value.value());
 }
 
-void CSSStyle::SetPosition(const std::string& value, bool reset) {
+StyleChangeType CSSStyle::SetPosition(std::string_view value, bool reset) {
+  PositionType position = position_;
   if (reset) {
-    position_ = CSS_STYLE_DEFAULT_POSITION_;
+    position = CSS_STYLE_DEFAULT_POSITION_;
   } else if (value.compare("relative") == 0) {
-    position_ = kPositionRelative;
+    position = kPositionRelative;
   } else if (value.compare("absolute") == 0) {
-    position_ = kPositionAbsolute;
+    position = kPositionAbsolute;
   } else if (value.compare("fixed") == 0) {
-    position_ = kPositionFixed;
+    position = kPositionFixed;
   }
+
+  return SetStyle(kStylePropertyPosition, position);
 }
 
-void CSSStyle::SetDisplay(const std::string& value, bool reset) {
+StyleChangeType CSSStyle::SetDisplay(std::string_view value, bool reset) {
+  DisplayType display = display_;
   if (reset) {
-    display_ = CSS_STYLE_DEFAULT_DISPLAY_;
+    display = CSS_STYLE_DEFAULT_DISPLAY_;
   } else if (value.compare("flex") == 0) {
-    display_ = kDisplayFlex;
+    display = kDisplayFlex;
   } else if (value.compare("grid") == 0) {
-    display_ = kDisplayGrid;
+    display = kDisplayGrid;
   } else if (value.compare("none") == 0) {
-    display_ = kDisplayNone;
+    display = kDisplayNone;
   }
+
+  return SetStyle(kStylePropertyDisplay, display);
+}
+
+StyleChangeType CSSStyle::SetTop(std::string_view value, bool reset) {
+  Length top = reset ? CSS_STYLE_DEFAULT_TOP_ : top_;
+  base::ToLength(value, top);
+  return SetStyle(kStylePropertyTop, top);
+}
+
+StyleChangeType CSSStyle::SetLeft(std::string_view value, bool reset) {
+  Length left = reset ? CSS_STYLE_DEFAULT_LEFT_ : left_;
+  base::ToLength(value, left);
+  return SetStyle(kStylePropertyLeft, left);
+}
+
+StyleChangeType CSSStyle::SetBottom(std::string_view value, bool reset) {
+  Length bottom = reset ? CSS_STYLE_DEFAULT_BOTTOM_ : bottom_;
+  base::ToLength(value, bottom);
+  return SetStyle(kStylePropertyBottom, bottom);
+}
+
+StyleChangeType CSSStyle::SetRight(std::string_view value, bool reset) {
+  Length right = reset ? CSS_STYLE_DEFAULT_RIGHT_ : right_;
+  base::ToLength(value, right);
+  return SetStyle(kStylePropertyRight, right);
 }
 
 /**
@@ -446,7 +1454,10 @@ void CSSStyle::SetDisplay(const std::string& value, bool reset) {
  * `flex: none`: Equivalent to `flex: 0 0 auto`.
  * `flex: <positive-number>`: Equivalent to `flex: <positive-number> 1 0`.
  */
-void CSSStyle::SetFlex(const std::string& value, bool reset) {
+StyleChangeType CSSStyle::SetFlex(std::string_view value, bool reset) {
+  Length flex_basis = flex_basis_;
+  float flex_grow = flex_grow_;
+  float flex_shrink = flex_shrink_;
   if (reset) {
     flex_basis_.SetTypeAndValue(base::kLengthAuto, .0f);
     flex_grow_ = .0f;
@@ -467,146 +1478,230 @@ void CSSStyle::SetFlex(const std::string& value, bool reset) {
       flex_shrink_ = 1.0f;
     }
   }
+
+  bool changed = flex_basis_ != flex_basis || flex_grow_ != flex_grow ||
+                 flex_shrink_ != flex_shrink;
+  return changed ? kStyleChangeSelfSize : kStyleChangeNone;
 }
 
-void CSSStyle::SetFlexBasis(const std::string& value, bool reset) {
-  if (reset) {
-    flex_basis_ = CSS_STYLE_DEFAULT_FLEX_BASIS_;
-  }
-  base::ToLength(value, flex_basis_);
+StyleChangeType CSSStyle::SetFlexBasis(std::string_view value, bool reset) {
+  Length flex_basis = reset ? CSS_STYLE_DEFAULT_FLEX_BASIS_ : flex_basis_;
+  base::ToLength(value, flex_basis);
+  return SetStyle(kStylePropertyFlexBasis, flex_basis);
 }
-void CSSStyle::SetFlexGrow(const std::string& value, bool reset) {
-  if (reset) {
-    flex_grow_ = CSS_STYLE_DEFAULT_FLEX_GROW_;
-  }
-  base::StringToFloat(value, flex_grow_);
+StyleChangeType CSSStyle::SetFlexGrow(std::string_view value, bool reset) {
+  float flex_grow = reset ? CSS_STYLE_DEFAULT_FLEX_GROW_ : flex_grow_;
+  base::StringToFloat(value, flex_grow);
+  return SetStyle(kStylePropertyFlexGrow, flex_grow);
 }
 
-void CSSStyle::SetFlexShrink(const std::string& value, bool reset) {
-  if (reset) {
-    flex_shrink_ = CSS_STYLE_DEFAULT_FLEX_SHRINK_;
-  }
-  base::StringToFloat(value, flex_shrink_);
+StyleChangeType CSSStyle::SetFlexShrink(std::string_view value, bool reset) {
+  float flex_shrink = reset ? CSS_STYLE_DEFAULT_FLEX_SHRINK_ : flex_shrink_;
+  base::StringToFloat(value, flex_shrink);
+  return SetStyle(kStylePropertyFlexShrink, flex_shrink);
 }
 
-void CSSStyle::SetFlexDirection(const std::string& value, bool reset) {
+StyleChangeType CSSStyle::SetFlexDirection(std::string_view value, bool reset) {
+  FlexDirectionType flex_direction = flex_direction_;
   if (reset) {
-    flex_direction_ = CSS_STYLE_DEFAULT_FLEX_DIRECTION_;
+    flex_direction = CSS_STYLE_DEFAULT_FLEX_DIRECTION_;
   } else if (value.compare("column") == 0) {
-    flex_direction_ = kFlexDirectionColumn;
+    flex_direction = kFlexDirectionColumn;
   } else if (value.compare("row") == 0) {
-    flex_direction_ = kFlexDirectionRow;
+    flex_direction = kFlexDirectionRow;
   } else if (value.compare("column-reverse") == 0) {
-    flex_direction_ = kFlexDirectionColumnReverse;
+    flex_direction = kFlexDirectionColumnReverse;
   } else if (value.compare("row-reverse") == 0) {
-    flex_direction_ = kFlexDirectionRowReverse;
+    flex_direction = kFlexDirectionRowReverse;
   }
+
+  return SetStyle(kStylePropertyFlexDirection, flex_direction);
 }
 
-void CSSStyle::SetFlexWrap(const std::string& value, bool reset) {
+StyleChangeType CSSStyle::SetFlexWrap(std::string_view value, bool reset) {
+  FlexWrapType flex_wrap = flex_wrap_;
   if (reset) {
-    flex_wrap_ = CSS_STYLE_DEFAULT_FLEX_WRAP_;
+    flex_wrap = CSS_STYLE_DEFAULT_FLEX_WRAP_;
   } else if (value.compare("nowrap") == 0) {
-    flex_wrap_ = kFlexWrapNoWrap;
+    flex_wrap = kFlexWrapNoWrap;
   } else if (value.compare("wrap") == 0) {
-    flex_wrap_ = kFlexWrapWrap;
+    flex_wrap = kFlexWrapWrap;
   } else if (value.compare("wrap-reverse") == 0) {
-    flex_wrap_ = kFlexWrapWrapReverse;
+    flex_wrap = kFlexWrapWrapReverse;
   }
+
+  return SetStyle(kStylePropertyFlexWrap, flex_wrap);
 }
 
 /**
  * The flex-flow property is a shorthand for setting the flex-direction and
  * flex-wrap properties*/
-void CSSStyle::SetFlexFlow(const std::string& value, bool reset) {
+StyleChangeType CSSStyle::SetFlexFlow(std::string_view value, bool reset) {
+  FlexDirectionType flex_direction = flex_direction_;
+  FlexWrapType flex_wrap = flex_wrap_;
   if (reset) {
     SetFlexDirection("", true);
     SetFlexWrap("", true);
-    return;
-  }
-  std::vector<std::string> values;
-  base::SplitString(value, ' ', values);
-  if (values.size() > 0) {
-    SetFlexDirection(values[0]);
-  }
-  if (values.size() > 1) {
-    SetFlexWrap(values[1]);
+  } else {
+    std::string_view values[2];
+    size_t count = base::SplitString(value, ' ', values, 2);
+    if (count > 0) {
+      SetFlexDirection(values[0]);
+    }
+    if (count > 1) {
+      SetFlexWrap(values[1]);
+    }
   }
+
+  bool changed = flex_direction_ != flex_direction || flex_wrap_ != flex_wrap;
+  return changed ? kStyleChangeChildrenSize : kStyleChangeNone;
 }
 
-void CSSStyle::SetJustifyContent(const std::string& value, bool reset) {
+StyleChangeType CSSStyle::SetJustifyContent(std::string_view value,
+                                            bool reset) {
+  JustifyContentType justify_content = justify_content_;
   if (reset) {
-    justify_content_ = CSS_STYLE_DEFAULT_JUSTIFY_CONTENT_;
+    justify_content = CSS_STYLE_DEFAULT_JUSTIFY_CONTENT_;
   } else if (value.compare("flex-start") == 0) {
-    justify_content_ = kJustifyContentFlexStart;
+    justify_content = kJustifyContentFlexStart;
   } else if (value.compare("flex-end") == 0) {
-    justify_content_ = kJustifyContentFlexEnd;
+    justify_content = kJustifyContentFlexEnd;
   } else if (value.compare("center") == 0) {
-    justify_content_ = kJustifyContentCenter;
+    justify_content = kJustifyContentCenter;
   } else if (value.compare("space-between") == 0) {
-    justify_content_ = kJustifyContentSpaceBetween;
+    justify_content = kJustifyContentSpaceBetween;
   } else if (value.compare("space-around") == 0) {
-    justify_content_ = kJustifyContentSpaceAround;
+    justify_content = kJustifyContentSpaceAround;
   }
+
+  return SetStyle(kStylePropertyJustifyContent, justify_content);
 }
 
-void CSSStyle::SetAlignItems(const std::string& value, bool reset) {
+StyleChangeType CSSStyle::SetAlignItems(std::string_view value, bool reset) {
+  AlignItemsType align_items = align_items_;
   if (reset) {
-    align_items_ = CSS_STYLE_DEFAULT_ALIGN_ITEMS_;
+    align_items = CSS_STYLE_DEFAULT_ALIGN_ITEMS_;
   } else if (value.compare("flex-start") == 0) {
-    align_items_ = kAlignItemsFlexStart;
+    align_items = kAlignItemsFlexStart;
   } else if (value.compare("center") == 0) {
-    align_items_ = kAlignItemsCenter;
+    align_items = kAlignItemsCenter;
   } else if (value.compare("flex-end") == 0) {
-    align_items_ = kAlignItemsFlexEnd;
+    align_items = kAlignItemsFlexEnd;
   } else if (value.compare("stretch") == 0) {
-    align_items_ = kAlignItemsStretch;
+    align_items = kAlignItemsStretch;
   }
+
+  return SetStyle(kStylePropertyAlignItems, align_items);
 }
 
-void CSSStyle::SetAlignSelf(const std::string& value, bool reset) {
+StyleChangeType CSSStyle::SetAlignSelf(std::string_view value, bool reset) {
+  AlignSelfType align_self = align_self_;
   if (reset) {
-    align_self_ = CSS_STYLE_DEFAULT_ALIGN_SELF_;
+    align_self = CSS_STYLE_DEFAULT_ALIGN_SELF_;
   } else if (value.compare("auto") == 0) {
-    align_self_ = kAlignSelfAuto;
+    align_self = kAlignSelfAuto;
   } else if (value.compare("flex-start") == 0) {
-    align_self_ = kAlignSelfFlexStart;
+    align_self = kAlignSelfFlexStart;
   } else if (value.compare("center") == 0) {
-    align_self_ = kAlignSelfCenter;
+    align_self = kAlignSelfCenter;
   } else if (value.compare("flex-end") == 0) {
-    align_self_ = kAlignSelfFlexEnd;
+    align_self = kAlignSelfFlexEnd;
   } else if (value.compare("stretch") == 0) {
-    align_self_ = kAlignSelfStretch;
+    align_self = kAlignSelfStretch;
   }
+
+  return SetStyle(kStylePropertyAlignSelf, align_self);
 }
 
-void CSSStyle::SetAlignContent(const std::string& value, bool reset) {
+StyleChangeType CSSStyle::SetAlignContent(std::string_view value, bool reset) {
+  AlignContentType align_content = align_content_;
   if (reset) {
-    align_content_ = CSS_STYLE_DEFAULT_ALIGN_CONTENT_;
-    if (value.compare("flex-start") == 0) {
-      align_content_ = kAlignContentFlexStart;
-    } else if (value.compare("center") == 0) {
-      align_content_ = kAlignContentCenter;
-    } else if (value.compare("flex-end") == 0) {
-      align_content_ = kAlignContentFlexEnd;
-    } else if (value.compare("stretch") == 0) {
-      align_content_ = kAlignContentStretch;
-    } else if (value.compare("space-between") == 0) {
-      align_content_ = kAlignContentSpaceBetween;
-    } else if (value.compare("space-around") == 0) {
-      align_content_ = kAlignContentSpaceAround;
-    }
+    align_content = CSS_STYLE_DEFAULT_ALIGN_CONTENT_;
+  } else if (value.compare("flex-start") == 0) {
+    align_content = kAlignContentFlexStart;
+  } else if (value.compare("center") == 0) {
+    align_content = kAlignContentCenter;
+  } else if (value.compare("flex-end") == 0) {
+    align_content = kAlignContentFlexEnd;
+  } else if (value.compare("stretch") == 0) {
+    align_content = kAlignContentStretch;
+  } else if (value.compare("space-between") == 0) {
+    align_content = kAlignContentSpaceBetween;
+  } else if (value.compare("space-around") == 0) {
+    align_content = kAlignContentSpaceAround;
   }
+
+  return SetStyle(kStylePropertyAlignContent, align_content);
 }
 
-void CSSStyle::SetOrder(const std::string& value, bool reset) {
-  if (reset) {
-    order_ = CSS_STYLE_DEFAULT_ORDER_;
-  }
-  int64_t order = 0;
-  if (base::StringToInt(value, order)) {
-    order_ = order;
+StyleChangeType CSSStyle::SetOrder(std::string_view value, bool reset) {
+  int order = reset ? CSS_STYLE_DEFAULT_ORDER_ : order_;
+  int64_t parsed_order = 0;
+  if (base::StringToInt(value, parsed_order)) {
+    order = parsed_order;
   }
+  return SetStyle(kStylePropertyOrder, order);
+}
+
+StyleChangeType CSSStyle::SetGridTemplateRows(std::string_view value,
+                                              bool reset) {
+  GridTrackList tracks =
+      reset ? CSS_STYLE_DEFAULT_GRID_TEMPLATE_ROWS_ : grid_template_rows();
+  ToGridTrackList(value, tracks);
+  return SetStyle(kStylePropertyGridTemplateRows, tracks);
+}
+
+StyleChangeType CSSStyle::SetGridTemplateColumns(std::string_view value,
+                                                 bool reset) {
+  GridTrackList tracks = reset ? CSS_STYLE_DEFAULT_GRID_TEMPLATE_COLUMNS_
+                               : grid_template_columns();
+  ToGridTrackList(value, tracks);
+  return SetStyle(kStylePropertyGridTemplateColumns, tracks);
+}
+
+// `<start> / <end>`, or `<start>` with an auto end
+StyleChangeType CSSStyle::SetGridRow(std::string_view value, bool reset) {
+  size_t slash = std::min(value.find('/'), value.size());
+  StyleChangeType start = SetGridRowStart(value.substr(0, slash), reset);
+  StyleChangeType end =
+      SetGridRowEnd(slash < value.size() ? value.substr(slash + 1) : "auto",
+                    reset);
+  return std::max(start, end);
+}
+
+StyleChangeType CSSStyle::SetGridRowStart(std::string_view value, bool reset) {
+  GridLine line = reset ? CSS_STYLE_DEFAULT_GRID_ROW_START_ : grid_row_start_;
+  ToGridLine(value, line);
+  return SetStyle(kStylePropertyGridRowStart, line);
+}
+
+StyleChangeType CSSStyle::SetGridRowEnd(std::string_view value, bool reset) {
+  GridLine line = reset ? CSS_STYLE_DEFAULT_GRID_ROW_END_ : grid_row_end_;
+  ToGridLine(value, line);
+  return SetStyle(kStylePropertyGridRowEnd, line);
+}
+
+StyleChangeType CSSStyle::SetGridColumn(std::string_view value, bool reset) {
+  size_t slash = std::min(value.find('/'), value.size());
+  StyleChangeType start = SetGridColumnStart(value.substr(0, slash), reset);
+  StyleChangeType end = SetGridColumnEnd(
+      slash < value.size() ? value.substr(slash + 1) : "auto", reset);
+  return std::max(start, end);
+}
+
+StyleChangeType CSSStyle::SetGridColumnStart(std::string_view value,
+                                             bool reset) {
+  GridLine line =
+      reset ? CSS_STYLE_DEFAULT_GRID_COLUMN_START_ : grid_column_start_;
+  ToGridLine(value, line);
+  return SetStyle(kStylePropertyGridColumnStart, line);
+}
+
+StyleChangeType CSSStyle::SetGridColumnEnd(std::string_view value,
+                                           bool reset) {
+  GridLine line = reset ? CSS_STYLE_DEFAULT_GRID_COLUMN_END_ : grid_column_end_;
+  ToGridLine(value, line);
+  return SetStyle(kStylePropertyGridColumnEnd, line);
 }
 
 }  // namespace starlight
\ No newline at end of file
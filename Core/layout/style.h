@@ -3,8 +3,8 @@
 #ifndef STARLIGHT_LAYOUT_STYLE_H_
 #define STARLIGHT_LAYOUT_STYLE_H_
 
-#include <string>
-#include <unordered_map>
+#include <memory>
+#include <string_view>
 
 #include "base/length.h"
 #include "layout/layout_enum.h"
@@ -12,24 +12,96 @@
 namespace starlight {
 
 /**
- * support 2 ways of setting styles: by string | by acutal value
+ * support 2 ways of setting styles: by string | by acutal value. both report
+ * which layout work the change needs.
  */
 class CSSStyle;
-typedef void (CSSStyle::*StyleFunc)(const std::string&, bool);
-typedef std::unordered_map<std::string, StyleFunc> StyleFuncMap;
+typedef StyleChangeType (CSSStyle::*StyleFunc)(std::string_view, bool);
 using base::Length;
 using base::LengthType;
 
+struct GridTrackSize {
+  GridTrackSize() : type_(kGridTrackAuto), value_(.0f) {}
+  GridTrackSize(GridTrackType type, float value) : type_(type), value_(value) {}
+  bool operator==(const GridTrackSize& other) const {
+    return type_ == other.type_ && value_ == other.value_;
+  }
+  bool operator!=(const GridTrackSize& other) const {
+    return !(*this == other);
+  }
+  GridTrackType type_;
+  // pixels or `fr`
+  float value_;
+};
+
+// `grid-template-rows` or `grid-template-columns`, only the first `count_`
+// tracks are part of the value
+struct GridTrackList {
+  static const size_t kMaxCount = 24;
+  GridTrackList() : count_(0) {}
+  bool operator==(const GridTrackList& other) const;
+  bool operator!=(const GridTrackList& other) const {
+    return !(*this == other);
+  }
+  size_t count_;
+  GridTrackSize tracks_[kMaxCount];
+};
+
+// a grid line numbered from 1, or a span of tracks from the line on the other
+// side of the item. zero is auto
+struct GridLine {
+  // lines and spans past it are clamped to it, as browsers bound the grid
+  static const int kMaxValue = 10000;
+  GridLine() : value_(0), span_(false) {}
+  GridLine(int value, bool span) : value_(value), span_(span) {}
+  bool operator==(const GridLine& other) const {
+    return value_ == other.value_ && span_ == other.span_;
+  }
+  bool operator!=(const GridLine& other) const { return !(*this == other); }
+  bool IsAuto() const { return value_ == 0; }
+  int value_;
+  bool span_;
+};
+
+/**
+ * styles used by layout nodes are shared: equal styles are interned by the
+ * LayoutContext into one reference counted instance which is never modified.
+ * a change is applied to a copy of the style, which is interned again.
+ */
 class CSSStyle {
  public:
   CSSStyle();
-  ~CSSStyle();
+
+  // references are only counted by the context which interned the style
+  void Retain() const { ++ref_count_; }
+  // returns whether the last reference was dropped
+  bool Release() const { return --ref_count_ == 0; }
+  unsigned ref_count() const { return ref_count_; }
+
+  bool operator==(const CSSStyle& other) const;
+  bool operator!=(const CSSStyle& other) const { return !(*this == other); }
+  size_t Hash() const;
 
   void ResetAllStyles();
 
-  void SetStyle(const std::string& name,
-                const std::string& value,
-                bool reset = false);
+  StyleChangeType SetStyle(std::string_view name,
+                           std::string_view value,
+                           bool reset = false);
+  StyleChangeType SetStyle(StyleProperty property, const Length& value);
+  StyleChangeType SetStyle(StyleProperty property, float value);
+  StyleChangeType SetStyle(StyleProperty property, int value);
+  StyleChangeType SetStyle(StyleProperty property, PositionType value);
+  StyleChangeType SetStyle(StyleProperty property, DisplayType value);
+  StyleChangeType SetStyle(StyleProperty property, FlexDirectionType value);
+  StyleChangeType SetStyle(StyleProperty property, FlexWrapType value);
+  StyleChangeType SetStyle(StyleProperty property, JustifyContentType value);
+  StyleChangeType SetStyle(StyleProperty property, AlignItemsType value);
+  StyleChangeType SetStyle(StyleProperty property, AlignSelfType value);
+  StyleChangeType SetStyle(StyleProperty property, AlignContentType value);
+  StyleChangeType SetStyle(StyleProperty property, const GridTrackList& value);
+  StyleChangeType SetStyle(StyleProperty property, const GridLine& value);
+  unsigned SetStyles(std::string_view declarations);
+  unsigned SetAllStyles(const CSSStyle& other);
 
   bool IsMainAxisHorizontal() const;
   bool IsMainAxisReverse() const;
@@ -60,6 +132,11 @@ class CSSStyle {
   // display style
   PositionType position_ : 2;
   DisplayType display_ : 2;
+  // insets of out-of-flow nodes
+  Length top_;
+  Length left_;
+  Length bottom_;
+  Length right_;
 
   // flex style
   Length flex_basis_;
@@ -73,10 +150,19 @@ class CSSStyle {
   AlignContentType align_content_ : 3;
   int order_;
 
-  static float density_;
-  static float screen_width_;
-  static float zoom_ratio_;
-  static StyleFuncMap style_setters_;
+  // grid style. track lists are kept out of line and shared by copies of the
+  // style, null for `none`, so styles of other layouts do not carry them
+  std::shared_ptr<const GridTrackList> grid_template_rows_;
+  std::shared_ptr<const GridTrackList> grid_template_columns_;
+  GridLine grid_row_start_;
+  GridLine grid_row_end_;
+  GridLine grid_column_start_;
+  GridLine grid_column_end_;
+
+  friend class LayoutContext;
+
+  // references of an interned style, not part of its value
+  mutable unsigned ref_count_;
 
  public:
   // getters
@@ -101,6 +187,10 @@ class CSSStyle {
 
   PositionType position() const { return position_; }
   DisplayType display() const { return display_; }
+  const Length& top() const { return top_; }
+  const Length& left() const { return left_; }
+  const Length& bottom() const { return bottom_; }
+  const Length& right() const { return right_; }
 
   const Length& flex_basis() const { return flex_basis_; }
   float flex_grow() const { return flex_grow_; }
@@ -113,44 +203,67 @@ class CSSStyle {
   AlignContentType align_content() const { return align_content_; }
   float order() const { return order_; }
 
+  const GridTrackList& grid_template_rows() const;
+  const GridTrackList& grid_template_columns() const;
+  const GridLine& grid_row_start() const { return grid_row_start_; }
+  const GridLine& grid_row_end() const { return grid_row_end_; }
+  const GridLine& grid_column_start() const { return grid_column_start_; }
+  const GridLine& grid_column_end() const { return grid_column_end_; }
+
   // setter
-  void SetWidth(const std::string& value, bool reset = false);
-  void SetHeight(const std::string& value, bool reset = false);
-  void SetMinWidth(const std::string& value, bool reset = false);
-  void SetMinHeight(const std::string& value, bool reset = false);
-  void SetMaxWidth(const std::string& value, bool reset = false);
-  void SetMaxHeight(const std::string& value, bool reset = false);
-  void SetPadding(const std::string& value, bool reset = false);
-  void SetPaddingTop(const std::string& value, bool reset = false);
-  void SetPaddingLeft(const std::string& value, bool reset = false);
-  void SetPaddingBottom(const std::string& value, bool reset = false);
-  void SetPaddingRight(const std::string& value, bool reset = false);
-  void SetMargin(const std::string& value, bool reset = false);
-  void SetMarginTop(const std::string& value, bool reset = false);
-  void SetMarginLeft(const std::string& value, bool reset = false);
-  void SetMarginBottom(const std::string& value, bool reset = false);
-  void SetMarginRight(const std::string& value, bool reset = false);
-  void SetBorder(const std::string& value, bool reset = false);
-  void SetBorderTop(const std::string& value, bool reset = false);
-  void SetBorderLeft(const std::string& value, bool reset = false);
-  void SetBorderBottom(const std::string& value, bool reset = false);
-  void SetBorderRight(const std::string& value, bool reset = false);
-
-  void SetPosition(const std::string& value, bool reset = false);
-  void SetDisplay(const std::string& value, bool reset = false);
-
-  void SetFlex(const std::string& value, bool reset = false);
-  void SetFlexBasis(const std::string& value, bool reset = false);
-  void SetFlexGrow(const std::string& value, bool reset = false);
-  void SetFlexShrink(const std::string& value, bool reset = false);
-  void SetFlexDirection(const std::string& value, bool reset = false);
-  void SetFlexWrap(const std::string& value, bool reset = false);
-  void SetFlexFlow(const std::string& value, bool reset = false);
-  void SetJustifyContent(const std::string& value, bool reset = false);
-  void SetAlignItems(const std::string& value, bool reset = false);
-  void SetAlignSelf(const std::string& value, bool reset = false);
-  void SetAlignContent(const std::string& value, bool reset = false);
-  void SetOrder(const std::string& value, bool reset = false);
+  StyleChangeType SetWidth(std::string_view value, bool reset = false);
+  StyleChangeType SetHeight(std::string_view value, bool reset = false);
+  StyleChangeType SetMinWidth(std::string_view value, bool reset = false);
+  StyleChangeType SetMinHeight(std::string_view value, bool reset = false);
+  StyleChangeType SetMaxWidth(std::string_view value, bool reset = false);
+  StyleChangeType SetMaxHeight(std::string_view value, bool reset = false);
+  StyleChangeType SetPadding(std::string_view value, bool reset = false);
+  StyleChangeType SetPaddingTop(std::string_view value, bool reset = false);
+  StyleChangeType SetPaddingLeft(std::string_view value, bool reset = false);
+  StyleChangeType SetPaddingBottom(std::string_view value, bool reset = false);
+  StyleChangeType SetPaddingRight(std::string_view value, bool reset = false);
+  StyleChangeType SetMargin(std::string_view value, bool reset = false);
+  StyleChangeType SetMarginTop(std::string_view value, bool reset = false);
+  StyleChangeType SetMarginLeft(std::string_view value, bool reset = false);
+  StyleChangeType SetMarginBottom(std::string_view value, bool reset = false);
+  StyleChangeType SetMarginRight(std::string_view value, bool reset = false);
+  StyleChangeType SetBorder(std::string_view value, bool reset = false);
+  StyleChangeType SetBorderTop(std::string_view value, bool reset = false);
+  StyleChangeType SetBorderLeft(std::string_view value, bool reset = false);
+  StyleChangeType SetBorderBottom(std::string_view value, bool reset = false);
+  StyleChangeType SetBorderRight(std::string_view value, bool reset = false);
+
+  StyleChangeType SetPosition(std::string_view value, bool reset = false);
+  StyleChangeType SetDisplay(std::string_view value, bool reset = false);
+  StyleChangeType SetTop(std::string_view value, bool reset = false);
+  StyleChangeType SetLeft(std::string_view value, bool reset = false);
+  StyleChangeType SetBottom(std::string_view value, bool reset = false);
+  StyleChangeType SetRight(std::string_view value, bool reset = false);
+
+  StyleChangeType SetFlex(std::string_view value, bool reset = false);
+  StyleChangeType SetFlexBasis(std::string_view value, bool reset = false);
+  StyleChangeType SetFlexGrow(std::string_view value, bool reset = false);
+  StyleChangeType SetFlexShrink(std::string_view value, bool reset = false);
+  StyleChangeType SetFlexDirection(std::string_view value, bool reset = false);
+  StyleChangeType SetFlexWrap(std::string_view value, bool reset = false);
+  StyleChangeType SetFlexFlow(std::string_view value, bool reset = false);
+  StyleChangeType SetJustifyContent(std::string_view value, bool reset = false);
+  StyleChangeType SetAlignItems(std::string_view value, bool reset = false);
+  StyleChangeType SetAlignSelf(std::string_view value, bool reset = false);
+  StyleChangeType SetAlignContent(std::string_view value, bool reset = false);
+  StyleChangeType SetOrder(std::string_view value, bool reset = false);
+
+  StyleChangeType SetGridTemplateRows(std::string_view value,
+                                      bool reset = false);
+  StyleChangeType SetGridTemplateColumns(std::string_view value,
+                                         bool reset = false);
+  StyleChangeType SetGridRow(std::string_view value, bool reset = false);
+  StyleChangeType SetGridRowStart(std::string_view value, bool reset = false);
+  StyleChangeType SetGridRowEnd(std::string_view value, bool reset = false);
+  StyleChangeType SetGridColumn(std::string_view value, bool reset = false);
+  StyleChangeType SetGridColumnStart(std::string_view value,
+                                     bool reset = false);
+  StyleChangeType SetGridColumnEnd(std::string_view value, bool reset = false);
 };
 
 }  // namespace starlight
@@ -0,0 +1,418 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include "layout/style_sheet.h"
+#include "layout/layout_context.h"
+#include "layout/style.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+namespace starlight {
+
+namespace {
+
+const uint32_t kStyleSheetMagic = 0x53534c53;  // "SLSS"
+const uint32_t kStyleSheetVersion = 3;
+
+LengthRecord ToRecord(const Length& length) {
+  LengthRecord record;
+  record.value_ = length.value();
+  record.type_ = length.type();
+  return record;
+}
+
+Length FromRecord(const LengthRecord& record) {
+  return Length(static_cast<LengthType>(record.type_), record.value_);
+}
+
+bool IsValid(const LengthRecord& record) {
+  return record.type_ <= base::kLengthAuto;
+}
+
+static_assert(sizeof(GridTrackListRecord::tracks_) /
+                      sizeof(GridTrackRecord) ==
+                  GridTrackList::kMaxCount,
+              "grid track records have to hold all tracks");
+
+GridTrackListRecord ToRecord(const GridTrackList& tracks) {
+  GridTrackListRecord record;
+  std::memset(&record, 0, sizeof(record));
+  record.count_ = tracks.count_;
+  for (size_t i = 0; i < tracks.count_; ++i) {
+    record.tracks_[i].value_ = tracks.tracks_[i].value_;
+    record.tracks_[i].type_ = tracks.tracks_[i].type_;
+  }
+  return record;
+}
+
+GridTrackList FromRecord(const GridTrackListRecord& record) {
+  GridTrackList tracks;
+  tracks.count_ = record.count_;
+  for (size_t i = 0; i < tracks.count_; ++i) {
+    tracks.tracks_[i] =
+        GridTrackSize(static_cast<GridTrackType>(record.tracks_[i].type_),
+                      record.tracks_[i].value_);
+  }
+  return tracks;
+}
+
+bool IsValid(const GridTrackListRecord& record) {
+  if (record.count_ > GridTrackList::kMaxCount) {
+    return false;
+  }
+  for (size_t i = 0; i < record.count_; ++i) {
+    if (record.tracks_[i].type_ > kGridTrackAuto) {
+      return false;
+    }
+  }
+  return true;
+}
+
+GridLineRecord ToRecord(const GridLine& line) {
+  GridLineRecord record;
+  record.value_ = line.value_;
+  record.span_ = line.span_;
+  return record;
+}
+
+GridLine FromRecord(const GridLineRecord& record) {
+  return GridLine(record.value_, record.span_ != 0);
+}
+
+// auto, or a line or span the parser clamped to GridLine::kMaxValue
+bool IsValid(const GridLineRecord& record) {
+  return record.value_ == 0 ? record.span_ == 0
+                            : record.value_ > 0 &&
+                                  record.value_ <= GridLine::kMaxValue;
+}
+
+StyleRecord ToRecord(const CSSStyle& style) {
+  StyleRecord record;
+  std::memset(&record, 0, sizeof(record));
+  record.width_ = ToRecord(style.width());
+  record.height_ = ToRecord(style.height());
+  record.min_width_ = ToRecord(style.min_width());
+  record.min_height_ = ToRecord(style.min_height());
+  record.max_width_ = ToRecord(style.max_width());
+  record.max_height_ = ToRecord(style.max_height());
+  record.padding_[kCSSDirectionTop] = ToRecord(style.padding_top());
+  record.padding_[kCSSDirectionLeft] = ToRecord(style.padding_left());
+  record.padding_[kCSSDirectionBottom] = ToRecord(style.padding_bottom());
+  record.padding_[kCSSDirectionRight] = ToRecord(style.padding_right());
+  record.margin_[kCSSDirectionTop] = ToRecord(style.margin_top());
+  record.margin_[kCSSDirectionLeft] = ToRecord(style.margin_left());
+  record.margin_[kCSSDirectionBottom] = ToRecord(style.margin_bottom());
+  record.margin_[kCSSDirectionRight] = ToRecord(style.margin_right());
+  record.inset_[kCSSDirectionTop] = ToRecord(style.top());
+  record.inset_[kCSSDirectionLeft] = ToRecord(style.left());
+  record.inset_[kCSSDirectionBottom] = ToRecord(style.bottom());
+  record.inset_[kCSSDirectionRight] = ToRecord(style.right());
+  record.flex_basis_ = ToRecord(style.flex_basis());
+  record.border_[kCSSDirectionTop] = style.border_top();
+  record.border_[kCSSDirectionLeft] = style.border_left();
+  record.border_[kCSSDirectionBottom] = style.border_bottom();
+  record.border_[kCSSDirectionRight] = style.border_right();
+  record.flex_grow_ = style.flex_grow();
+  record.flex_shrink_ = style.flex_shrink();
+  record.order_ = static_cast<int32_t>(style.order());
+  record.position_ = style.position();
+  record.display_ = style.display();
+  record.flex_direction_ = style.flex_direction();
+  record.flex_wrap_ = style.flex_wrap();
+  record.justify_content_ = style.justify_content();
+  record.align_items_ = style.align_items();
+  record.align_self_ = style.align_self();
+  record.align_content_ = style.align_content();
+  record.grid_template_rows_ = ToRecord(style.grid_template_rows());
+  record.grid_template_columns_ = ToRecord(style.grid_template_columns());
+  record.grid_row_start_ = ToRecord(style.grid_row_start());
+  record.grid_row_end_ = ToRecord(style.grid_row_end());
+  record.grid_column_start_ = ToRecord(style.grid_column_start());
+  record.grid_column_end_ = ToRecord(style.grid_column_end());
+  return record;
+}
+
+void FromRecord(const StyleRecord& record, CSSStyle& style) {
+  style.SetStyle(kStylePropertyWidth, FromRecord(record.width_));
+  style.SetStyle(kStylePropertyHeight, FromRecord(record.height_));
+  style.SetStyle(kStylePropertyMinWidth, FromRecord(record.min_width_));
+  style.SetStyle(kStylePropertyMinHeight, FromRecord(record.min_height_));
+  style.SetStyle(kStylePropertyMaxWidth, FromRecord(record.max_width_));
+  style.SetStyle(kStylePropertyMaxHeight, FromRecord(record.max_height_));
+  style.SetStyle(kStylePropertyPaddingTop,
+                 FromRecord(record.padding_[kCSSDirectionTop]));
+  style.SetStyle(kStylePropertyPaddingLeft,
+                 FromRecord(record.padding_[kCSSDirectionLeft]));
+  style.SetStyle(kStylePropertyPaddingBottom,
+                 FromRecord(record.padding_[kCSSDirectionBottom]));
+  style.SetStyle(kStylePropertyPaddingRight,
+                 FromRecord(record.padding_[kCSSDirectionRight]));
+  style.SetStyle(kStylePropertyMarginTop,
+                 FromRecord(record.margin_[kCSSDirectionTop]));
+  style.SetStyle(kStylePropertyMarginLeft,
+                 FromRecord(record.margin_[kCSSDirectionLeft]));
+  style.SetStyle(kStylePropertyMarginBottom,
+                 FromRecord(record.margin_[kCSSDirectionBottom]));
+  style.SetStyle(kStylePropertyMarginRight,
+                 FromRecord(record.margin_[kCSSDirectionRight]));
+  style.SetStyle(kStylePropertyTop,
+                 FromRecord(record.inset_[kCSSDirectionTop]));
+  style.SetStyle(kStylePropertyLeft,
+                 FromRecord(record.inset_[kCSSDirectionLeft]));
+  style.SetStyle(kStylePropertyBottom,
+                 FromRecord(record.inset_[kCSSDirectionBottom]));
+  style.SetStyle(kStylePropertyRight,
+                 FromRecord(record.inset_[kCSSDirectionRight]));
+  style.SetStyle(kStylePropertyFlexBasis, FromRecord(record.flex_basis_));
+  style.SetStyle(kStylePropertyBorderTop, record.border_[kCSSDirectionTop]);
+  style.SetStyle(kStylePropertyBorderLeft, record.border_[kCSSDirectionLeft]);
+  style.SetStyle(kStylePropertyBorderBottom,
+                 record.border_[kCSSDirectionBottom]);
+  style.SetStyle(kStylePropertyBorderRight, record.border_[kCSSDirectionRight]);
+  style.SetStyle(kStylePropertyFlexGrow, record.flex_grow_);
+  style.SetStyle(kStylePropertyFlexShrink, record.flex_shrink_);
+  style.SetStyle(kStylePropertyOrder, static_cast<int>(record.order_));
+  style.SetStyle(kStylePropertyPosition,
+                 static_cast<PositionType>(record.position_));
+  style.SetStyle(kStylePropertyDisplay,
+                 static_cast<DisplayType>(record.display_));
+  style.SetStyle(kStylePropertyFlexDirection,
+                 static_cast<FlexDirectionType>(record.flex_direction_));
+  style.SetStyle(kStylePropertyFlexWrap,
+                 static_cast<FlexWrapType>(record.flex_wrap_));
+  style.SetStyle(kStylePropertyJustifyContent,
+                 static_cast<JustifyContentType>(record.justify_content_));
+  style.SetStyle(kStylePropertyAlignItems,
+                 static_cast<AlignItemsType>(record.align_items_));
+  style.SetStyle(kStylePropertyAlignSelf,
+                 static_cast<AlignSelfType>(record.align_self_));
+  style.SetStyle(kStylePropertyAlignContent,
+                 static_cast<AlignContentType>(record.align_content_));
+  style.SetStyle(kStylePropertyGridTemplateRows,
+                 FromRecord(record.grid_template_rows_));
+  style.SetStyle(kStylePropertyGridTemplateColumns,
+                 FromRecord(record.grid_template_columns_));
+  style.SetStyle(kStylePropertyGridRowStart,
+                 FromRecord(record.grid_row_start_));
+  style.SetStyle(kStylePropertyGridRowEnd, FromRecord(record.grid_row_end_));
+  style.SetStyle(kStylePropertyGridColumnStart,
+                 FromRecord(record.grid_column_start_));
+  style.SetStyle(kStylePropertyGridColumnEnd,
+                 FromRecord(record.grid_column_end_));
+}
+
+// enum values have to fit the bit fields of CSSStyle, grid lines the range
+// the grid layout places items in
+bool IsValid(const StyleRecord& record) {
+  bool lengths_valid = IsValid(record.width_) && IsValid(record.height_) &&
+                       IsValid(record.min_width_) &&
+                       IsValid(record.min_height_) &&
+                       IsValid(record.max_width_) &&
+                       IsValid(record.max_height_) &&
+                       IsValid(record.flex_basis_);
+  for (size_t i = 0; i < 4; ++i) {
+    lengths_valid &= IsValid(record.padding_[i]) &&
+                     IsValid(record.margin_[i]) && IsValid(record.inset_[i]);
+  }
+  return lengths_valid && IsValid(record.grid_template_rows_) &&
+         IsValid(record.grid_template_columns_) &&
+         IsValid(record.grid_row_start_) && IsValid(record.grid_row_end_) &&
+         IsValid(record.grid_column_start_) &&
+         IsValid(record.grid_column_end_) &&
+         record.position_ <= kPositionFixed &&
+         record.display_ <= kDisplayNone &&
+         record.flex_direction_ <= kFlexDirectionRowReverse &&
+         record.flex_wrap_ <= kFlexWrapWrapReverse &&
+         record.justify_content_ <= kJustifyContentSpaceAround &&
+         record.align_items_ <= kAlignItemsStretch &&
+         record.align_self_ <= kAlignSelfAuto &&
+         record.align_content_ <= kAlignContentStretch;
+}
+
+}  // namespace
+
+StyleSheet::StyleSheet(LayoutContext* layout_context,
+                       const uint8_t* data,
+                       uint32_t rule_count)
+    : layout_context_(layout_context),
+      data_(data),
+      rule_count_(rule_count),
+      mapped_data_(nullptr),
+      mapped_size_(0),
+      styles_(rule_count, nullptr) {}
+
+StyleSheet::~StyleSheet() {
+  for (const CSSStyle* style : styles_) {
+    if (style) {
+      layout_context_->ReleaseStyle(style);
+    }
+  }
+  if (mapped_data_) {
+    munmap(mapped_data_, mapped_size_);
+  }
+}
+
+/**
+ * rules are resolved by the same parser as LayoutNode::SetStyles, starting
+ * from the default style
+ */
+std::vector<uint8_t> StyleSheet::Compile(const std::vector<StyleRule>& rules) {
+  std::vector<uint32_t> name_offsets;
+  std::string names;
+  for (const StyleRule& rule : rules) {
+    if (rule.name_.empty() || rule.name_.find('\0') != std::string::npos) {
+      return std::vector<uint8_t>();
+    }
+    name_offsets.push_back(static_cast<uint32_t>(names.size()));
+    names.append(rule.name_);
+    names.push_back('\0');
+  }
+  if (names.size() > UINT32_MAX) {
+    return std::vector<uint8_t>();
+  }
+
+  StyleSheetHeader header;
+  header.magic_ = kStyleSheetMagic;
+  header.version_ = kStyleSheetVersion;
+  header.rule_count_ = static_cast<uint32_t>(rules.size());
+  header.record_size_ = sizeof(StyleRecord);
+  header.names_size_ = static_cast<uint32_t>(names.size());
+
+  size_t records_size = rules.size() * sizeof(StyleRecord);
+  size_t offsets_size = rules.size() * sizeof(uint32_t);
+  std::vector<uint8_t> blob(sizeof(header) + records_size + offsets_size +
+                            names.size());
+  uint8_t* cursor = blob.data();
+  std::memcpy(cursor, &header, sizeof(header));
+  cursor += sizeof(header);
+  for (const StyleRule& rule : rules) {
+    CSSStyle style;
+    style.SetStyles(rule.declarations_);
+    StyleRecord record = ToRecord(style);
+    std::memcpy(cursor, &record, sizeof(record));
+    cursor += sizeof(record);
+  }
+  if (offsets_size > 0) {
+    std::memcpy(cursor, name_offsets.data(), offsets_size);
+    cursor += offsets_size;
+  }
+  if (!names.empty()) {
+    std::memcpy(cursor, names.data(), names.size());
+  }
+  return blob;
+}
+
+std::unique_ptr<StyleSheet> StyleSheet::Create(LayoutContext* layout_context,
+                                               const void* data,
+                                               size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  StyleSheetHeader header;
+  if (bytes == nullptr || size < sizeof(header)) {
+    return nullptr;
+  }
+  std::memcpy(&header, bytes, sizeof(header));
+  if (header.magic_ != kStyleSheetMagic ||
+      header.version_ != kStyleSheetVersion ||
+      header.record_size_ != sizeof(StyleRecord)) {
+    return nullptr;
+  }
+  uint64_t rule_count = header.rule_count_;
+  uint64_t expected_size = sizeof(header) +
+                           rule_count * sizeof(StyleRecord) +
+                           rule_count * sizeof(uint32_t) + header.names_size_;
+  if (expected_size != size) {
+    return nullptr;
+  }
+
+  // a malformed blob is refused as a whole, records are not checked again
+  // when they are resolved
+  const uint8_t* records = bytes + sizeof(header);
+  const uint8_t* offsets = records + rule_count * sizeof(StyleRecord);
+  const char* names = reinterpret_cast<const char*>(
+      offsets + rule_count * sizeof(uint32_t));
+  if (rule_count > 0 &&
+      (header.names_size_ == 0 || names[header.names_size_ - 1] != '\0')) {
+    return nullptr;
+  }
+  for (uint64_t i = 0; i < rule_count; ++i) {
+    StyleRecord record;
+    std::memcpy(&record, records + i * sizeof(StyleRecord), sizeof(record));
+    uint32_t name_offset;
+    std::memcpy(&name_offset, offsets + i * sizeof(uint32_t),
+                sizeof(name_offset));
+    if (!IsValid(record) || name_offset >= header.names_size_) {
+      return nullptr;
+    }
+  }
+  return std::unique_ptr<StyleSheet>(
+      new StyleSheet(layout_context, bytes, header.rule_count_));
+}
+
+std::unique_ptr<StyleSheet> StyleSheet::MapFile(LayoutContext* layout_context,
+                                                const char* path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+    close(fd);
+    return nullptr;
+  }
+  size_t size = static_cast<size_t>(file_stat.st_size);
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return nullptr;
+  }
+  std::unique_ptr<StyleSheet> style_sheet =
+      Create(layout_context, data, size);
+  if (!style_sheet) {
+    munmap(data, size);
+    return nullptr;
+  }
+  style_sheet->mapped_data_ = data;
+  style_sheet->mapped_size_ = size;
+  return style_sheet;
+}
+
+const CSSStyle* StyleSheet::GetStyle(uint32_t index) const {
+  if (index >= rule_count_) {
+    return nullptr;
+  }
+  if (styles_[index] == nullptr) {
+    StyleRecord record;
+    std::memcpy(&record,
+                data_ + sizeof(StyleSheetHeader) + index * sizeof(StyleRecord),
+                sizeof(record));
+    CSSStyle style;
+    FromRecord(record, style);
+    styles_[index] = layout_context_->InternStyle(style);
+  }
+  return styles_[index];
+}
+
+/**
+ * linear in the number of rules, meant for mapping names to indices once
+ */
+uint32_t StyleSheet::FindRule(std::string_view name) const {
+  const uint8_t* offsets = data_ + sizeof(StyleSheetHeader) +
+                           rule_count_ * sizeof(StyleRecord);
+  const char* names = reinterpret_cast<const char*>(
+      offsets + rule_count_ * sizeof(uint32_t));
+  for (uint32_t i = 0; i < rule_count_; ++i) {
+    uint32_t name_offset;
+    std::memcpy(&name_offset, offsets + i * sizeof(uint32_t),
+                sizeof(name_offset));
+    if (name == names + name_offset) {
+      return i;
+    }
+  }
+  return rule_count_;
+}
+
+}  // namespace starlight
\ No newline at end of file
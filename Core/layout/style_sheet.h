@@ -0,0 +1,141 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#ifndef STARLIGHT_LAYOUT_STYLE_SHEET_H_
+#define STARLIGHT_LAYOUT_STYLE_SHEET_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace starlight {
+
+class CSSStyle;
+class LayoutContext;
+
+// a named rule given to the compiler, declarations as in LayoutNode::SetStyles
+struct StyleRule {
+  std::string name_;
+  std::string declarations_;
+};
+
+/**
+ * binary layout: a StyleSheetHeader, `rule_count_` StyleRecords, `rule_count_`
+ * offsets of rule names and the null terminated names. all values are in host
+ * byte order, a blob is only valid for the platform which compiled it.
+ */
+struct StyleSheetHeader {
+  uint32_t magic_;
+  uint32_t version_;
+  uint32_t rule_count_;
+  uint32_t record_size_;
+  uint32_t names_size_;
+};
+
+struct LengthRecord {
+  float value_;
+  uint32_t type_;
+};
+
+struct GridTrackRecord {
+  float value_;
+  uint32_t type_;
+};
+
+struct GridLineRecord {
+  int32_t value_;
+  uint32_t span_;
+};
+
+// tracks past `count_` are zero
+struct GridTrackListRecord {
+  uint32_t count_;
+  GridTrackRecord tracks_[24];
+};
+
+// values of a resolved CSSStyle, independent of its in-memory layout
+struct StyleRecord {
+  LengthRecord width_;
+  LengthRecord height_;
+  LengthRecord min_width_;
+  LengthRecord min_height_;
+  LengthRecord max_width_;
+  LengthRecord max_height_;
+  LengthRecord padding_[4];
+  LengthRecord margin_[4];
+  LengthRecord inset_[4];
+  LengthRecord flex_basis_;
+  float border_[4];
+  float flex_grow_;
+  float flex_shrink_;
+  int32_t order_;
+  uint8_t position_;
+  uint8_t display_;
+  uint8_t flex_direction_;
+  uint8_t flex_wrap_;
+  uint8_t justify_content_;
+  uint8_t align_items_;
+  uint8_t align_self_;
+  uint8_t align_content_;
+  GridTrackListRecord grid_template_rows_;
+  GridTrackListRecord grid_template_columns_;
+  GridLineRecord grid_row_start_;
+  GridLineRecord grid_row_end_;
+  GridLineRecord grid_column_start_;
+  GridLineRecord grid_column_end_;
+};
+
+/**
+ * rules of a precompiled stylesheet. records are read straight from the blob,
+ * which usually is a mapped file, and resolved to shared styles of the
+ * stylesheet's context on first use, so nodes adopt a rule without any
+ * parsing. contexts on other threads create their own stylesheet from the same
+ * blob.
+ */
+class StyleSheet {
+ public:
+  ~StyleSheet();
+  StyleSheet(const StyleSheet&) = delete;
+  StyleSheet& operator=(const StyleSheet&) = delete;
+
+  // returns an empty blob if a rule has no name or the names do not fit
+  static std::vector<uint8_t> Compile(const std::vector<StyleRule>& rules);
+
+  /**
+   * `data` has to outlive the stylesheet, it is not copied. returns null if
+   * the blob is malformed or was compiled by another version.
+   */
+  static std::unique_ptr<StyleSheet> Create(LayoutContext* layout_context,
+                                            const void* data,
+                                            size_t size);
+  // maps the compiled file at `path` read-only
+  static std::unique_ptr<StyleSheet> MapFile(LayoutContext* layout_context,
+                                             const char* path);
+
+  // null for an out of range index
+  const CSSStyle* GetStyle(uint32_t index) const;
+  // index of the rule named `name`, or rule_count() if there is none
+  uint32_t FindRule(std::string_view name) const;
+
+  uint32_t rule_count() const { return rule_count_; }
+
+ private:
+  StyleSheet(LayoutContext* layout_context,
+             const uint8_t* data,
+             uint32_t rule_count);
+
+  LayoutContext* layout_context_;
+  const uint8_t* data_;
+  uint32_t rule_count_;
+  // region to unmap when the stylesheet mapped a file itself
+  void* mapped_data_;
+  size_t mapped_size_;
+  // resolved shared styles, each holds one reference
+  mutable std::vector<const CSSStyle*> styles_;
+};
+
+}  // namespace starlight
+
+#endif
\ No newline at end of file
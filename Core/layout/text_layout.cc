@@ -0,0 +1,147 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include <algorithm>
+
+#include "layout/text_layout.h"
+
+namespace starlight {
+
+namespace {
+
+const uint32_t kReplacementCharacter = 0xFFFD;
+
+/**
+ * code point starting at `offset`, which is moved past it. malformed
+ * sequences decode to one replacement character per byte.
+ */
+uint32_t DecodeUtf8(std::string_view text, size_t& offset) {
+  uint8_t lead = static_cast<uint8_t>(text[offset++]);
+  if (lead < 0x80) {
+    return lead;
+  }
+  size_t length = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+  if (length == 0 || lead >= 0xF8 || offset + length > text.size()) {
+    return kReplacementCharacter;
+  }
+  uint32_t code_point = lead & (0x3F >> length);
+  for (size_t i = 0; i < length; ++i) {
+    uint8_t trail = static_cast<uint8_t>(text[offset + i]);
+    if ((trail & 0xC0) != 0x80) {
+      return kReplacementCharacter;
+    }
+    code_point = (code_point << 6) | (trail & 0x3F);
+  }
+  offset += length;
+  return code_point;
+}
+
+// lines may break before and after these, as between words
+bool IsIdeographic(uint32_t code_point) {
+  return (code_point >= 0x2E80 && code_point <= 0x9FFF) ||
+         (code_point >= 0xAC00 && code_point <= 0xD7AF) ||
+         (code_point >= 0xF900 && code_point <= 0xFAFF) ||
+         (code_point >= 0xFF00 && code_point <= 0xFFEF) ||
+         (code_point >= 0x20000 && code_point <= 0x3FFFF);
+}
+
+}  // namespace
+
+TextLayout::TextLayout(std::string_view text, const FontMetrics& font)
+    : line_height_(font.line_height_), cached_count_(0), next_(0) {
+  // the last word takes more characters until a space or line feed follows
+  bool word_open = false;
+  size_t offset = 0;
+  while (offset < text.size()) {
+    size_t start = offset;
+    uint32_t code_point = DecodeUtf8(text, offset);
+    bool line_feed = code_point == '\n';
+    if (line_feed || code_point == ' ' || code_point == '\t') {
+      // spaces opening the text or a line make a word without width
+      if (words_.empty() || words_.back().line_feed_) {
+        words_.push_back(Word(start));
+      }
+      if (line_feed) {
+        words_.back().line_feed_ = true;
+      } else {
+        words_.back().space_width_ += font.Advance(code_point);
+      }
+      word_open = false;
+      continue;
+    }
+    bool ideographic = IsIdeographic(code_point);
+    if (!word_open || ideographic) {
+      words_.push_back(Word(start));
+    }
+    words_.back().width_ += font.Advance(code_point);
+    word_open = !ideographic;
+  }
+}
+
+FloatSize TextLayout::Measure(float width, LayoutMode width_mode) {
+  return Break(width, width_mode).size_;
+}
+
+const std::vector<size_t>& TextLayout::LineStarts(float width,
+                                                  LayoutMode width_mode) {
+  return Break(width, width_mode).starts_;
+}
+
+/**
+ * a word goes onto the current line if it fits, or if the line holds nothing
+ * yet: words wider than the line overflow it
+ */
+const TextLayout::Lines& TextLayout::Break(float width,
+                                           LayoutMode width_mode) {
+  if (width_mode == kLayoutModeUndefined) {
+    width = .0f;
+  }
+  for (size_t i = 0; i < cached_count_; ++i) {
+    if (lines_[i].width_ == width && lines_[i].width_mode_ == width_mode) {
+      return lines_[i];
+    }
+  }
+
+  Lines& lines = lines_[next_];
+  next_ = (next_ + 1) % kMaxCachedWidths;
+  if (cached_count_ < kMaxCachedWidths) {
+    ++cached_count_;
+  }
+  lines.width_ = width;
+  lines.width_mode_ = width_mode;
+  lines.starts_.clear();
+  if (words_.empty()) {
+    lines.size_ = FloatSize(.0f, .0f);
+    return lines;
+  }
+
+  bool wraps = width_mode != kLayoutModeUndefined;
+  float max_line_width = .0f;
+  float line_width = .0f;
+  // spaces after the last word on the line, counted once another word follows
+  float pending_space = .0f;
+  bool line_empty = true;
+  for (const Word& word : words_) {
+    if (line_empty) {
+      lines.starts_.push_back(word.offset_);
+      line_width = word.width_;
+    } else if (wraps && line_width + pending_space + word.width_ > width) {
+      max_line_width = std::max(max_line_width, line_width);
+      lines.starts_.push_back(word.offset_);
+      line_width = word.width_;
+    } else {
+      line_width += pending_space + word.width_;
+    }
+    pending_space = word.space_width_;
+    line_empty = word.line_feed_;
+    if (line_empty) {
+      max_line_width = std::max(max_line_width, line_width);
+    }
+  }
+  max_line_width = std::max(max_line_width, line_width);
+
+  lines.size_ =
+      FloatSize(max_line_width, lines.starts_.size() * line_height_);
+  return lines;
+}
+
+}  // namespace starlight
\ No newline at end of file
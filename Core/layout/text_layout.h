@@ -0,0 +1,81 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#ifndef STARLIGHT_LAYOUT_TEXT_LAYOUT_H_
+#define STARLIGHT_LAYOUT_TEXT_LAYOUT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "layout/layout_enum.h"
+
+namespace starlight {
+
+/**
+ * glyph advances of one font at one size, registered by the host with the
+ * LayoutContext. code points past the table advance by `default_advance_`.
+ */
+struct FontMetrics {
+  FontMetrics() : default_advance_(.0f), line_height_(.0f) {}
+  float Advance(uint32_t code_point) const {
+    return code_point < advances_.size() ? advances_[code_point]
+                                         : default_advance_;
+  }
+  std::vector<float> advances_;
+  float default_advance_;
+  float line_height_;
+};
+
+/**
+ * lines of a text leaf, broken greedily at spaces and around CJK characters,
+ * and at every line feed. spaces at the end of a line hang and take no width.
+ * words are measured once when the text is set, breaks of the last few widths
+ * are kept.
+ */
+class TextLayout {
+ public:
+  static const size_t kMaxCachedWidths = 4;
+
+  TextLayout(std::string_view text, const FontMetrics& font);
+
+  // size of the lines within `width`, or of the unbroken text with
+  // `width_mode` undefined
+  FloatSize Measure(float width, LayoutMode width_mode);
+  // byte offsets of the text at which lines start
+  const std::vector<size_t>& LineStarts(float width, LayoutMode width_mode);
+
+ private:
+  struct Word {
+    explicit Word(size_t offset)
+        : offset_(offset),
+          width_(.0f),
+          space_width_(.0f),
+          line_feed_(false) {}
+    size_t offset_;
+    float width_;
+    // spaces after the word
+    float space_width_;
+    // a new line starts after the word and its spaces
+    bool line_feed_;
+  };
+  struct Lines {
+    Lines() : width_(.0f), width_mode_(kLayoutModeUndefined), size_(.0f, .0f) {}
+    float width_;
+    LayoutMode width_mode_;
+    std::vector<size_t> starts_;
+    FloatSize size_;
+  };
+
+  const Lines& Break(float width, LayoutMode width_mode);
+
+  std::vector<Word> words_;
+  float line_height_;
+  Lines lines_[kMaxCachedWidths];
+  size_t cached_count_;
+  size_t next_;
+};
+
+}  // namespace starlight
+
+#endif
\ No newline at end of file
@@ -0,0 +1,46 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#ifndef STARLIGHT_LAYOUT_TEST_BENCHMARK_BENCHMARK_UTIL_H_
+#define STARLIGHT_LAYOUT_TEST_BENCHMARK_BENCHMARK_UTIL_H_
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+// what the layout benchmarks share, each of them only builds its scenario
+namespace benchmark {
+
+// same sequence on every platform
+class Random {
+ public:
+  explicit Random(uint32_t seed) : state_(seed) {}
+  int Next(int bound) {
+    state_ = state_ * 1103515245u + 12345u;
+    return static_cast<int>((state_ >> 8) % static_cast<uint32_t>(bound));
+  }
+
+ private:
+  uint32_t state_;
+};
+
+// command line argument `index` as a number, `fallback` if it is not given
+inline int IntArgument(int argc, char** argv, int index, int fallback) {
+  return argc > index ? atoi(argv[index]) : fallback;
+}
+
+// average wall time of `layout(i)` for i from 0 to `layouts` - 1
+template <typename Layout>
+double MillisecondsPerLayout(int layouts, Layout layout) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < layouts; ++i) {
+    layout(i);
+  }
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         layouts;
+}
+
+}  // namespace benchmark
+
+#endif
\ No newline at end of file
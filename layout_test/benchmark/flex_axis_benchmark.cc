@@ -0,0 +1,74 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+// cost of the flex steps per item: one container holding many fixed-size
+// leaves laid out at changing sizes, for every direction and wrap. leaves
+// keep their cached sizes, the time is spent on the container's flex basis,
+// lines, flexible lengths and alignment.
+// usage: flex_axis_benchmark [items] [layouts]
+
+#include <cstdio>
+#include <string>
+
+#include "benchmark_util.h"
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+
+namespace {
+
+using benchmark::Random;
+using starlight::LayoutContext;
+using starlight::LayoutNode;
+using starlight::LayoutTree;
+
+// nanoseconds per item and layout
+double Run(const char* direction, const char* wrap, int items, int layouts) {
+  LayoutContext layout_context;
+  LayoutTree tree(&layout_context);
+  LayoutNode* container = tree.CreateNode();
+  container->SetStyle("flex-direction", direction);
+  container->SetStyle("flex-wrap", wrap);
+  container->SetStyle("align-items", "center");
+  container->SetStyle("justify-content", "space-between");
+  Random random(1);
+  for (int i = 0; i < items; ++i) {
+    LayoutNode* item = tree.CreateNode();
+    item->SetStyle("width", std::to_string(8 + random.Next(40)) + "px");
+    item->SetStyle("height", std::to_string(8 + random.Next(40)) + "px");
+    item->SetStyle("margin", "2px");
+    item->SetStyle("flex-shrink", "0");
+    container->InsertChild(item);
+  }
+
+  // sizes of a few passes first, so leaves have their results cached
+  int sizes = 8;
+  for (int i = 0; i < sizes; ++i) {
+    container->ReLayout(0, 0, 2000 + i * 10, 2000 + i * 10);
+  }
+  double milliseconds =
+      benchmark::MillisecondsPerLayout(layouts, [&](int i) {
+        int size = 2000 + i % sizes * 10;
+        container->ReLayout(0, 0, size, size);
+      });
+  return milliseconds * 1e6 / items;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int items = benchmark::IntArgument(argc, argv, 1, 10000);
+  int layouts = benchmark::IntArgument(argc, argv, 2, 200);
+  const char* directions[] = {"row", "row-reverse", "column",
+                              "column-reverse"};
+  const char* wraps[] = {"nowrap", "wrap", "wrap-reverse"};
+  double total = .0;
+  for (const char* direction : directions) {
+    for (const char* wrap : wraps) {
+      double nanoseconds = Run(direction, wrap, items, layouts);
+      total += nanoseconds;
+      printf("%-15s %-13s %7.2f ns/item\n", direction, wrap, nanoseconds);
+    }
+  }
+  printf("%-29s %7.2f ns/item\n", "mean", total / 12);
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+// a feed of cards the way apps build them: rows of fixed-size icons, a
+// column of text lines, a row of buttons, most containers holding inflexible
+// items or a single one. laid out with and without the closed forms for
+// trivial flex lines, printing time per layout and whether boxes agree.
+// usage: flex_fast_path_benchmark [cards] [layouts]
+
+#include <cstdio>
+#include <vector>
+
+#include "benchmark_util.h"
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+
+namespace {
+
+using starlight::LayoutContext;
+using starlight::LayoutNode;
+using starlight::LayoutTree;
+
+LayoutNode* CreateNode(LayoutTree& tree,
+                       LayoutNode* parent,
+                       const char* styles,
+                       std::vector<LayoutNode*>& nodes) {
+  LayoutNode* node = tree.CreateNode();
+  node->SetStyles(styles);
+  if (parent) {
+    parent->InsertChild(node);
+  }
+  nodes.push_back(node);
+  return node;
+}
+
+void BuildCard(LayoutTree& tree,
+               LayoutNode* feed,
+               int index,
+               std::vector<LayoutNode*>& nodes) {
+  LayoutNode* card = CreateNode(
+      tree, feed, "flex-direction: column; padding: 12px; margin: 4px", nodes);
+
+  LayoutNode* header = CreateNode(
+      tree, card, "flex-direction: row; align-items: center", nodes);
+  CreateNode(tree, header, "width: 40px; height: 40px; flex-shrink: 0",
+             nodes);
+  LayoutNode* names = CreateNode(
+      tree, header, "flex-direction: column; margin-left: 8px", nodes);
+  CreateNode(tree, names, "height: 18px; width: 120px", nodes);
+  CreateNode(tree, names, "height: 14px; width: 80px", nodes);
+
+  // a single child, taking the rest of the row
+  LayoutNode* body = CreateNode(tree, card, "flex-direction: row", nodes);
+  CreateNode(tree, body,
+             index % 3 ? "flex-grow: 1; height: 60px"
+                       : "flex-grow: 1; height: 60px; max-width: 240px",
+             nodes);
+
+  LayoutNode* actions = CreateNode(
+      tree, card,
+      "flex-direction: row; justify-content: space-between; margin-top: 8px",
+      nodes);
+  for (int i = 0; i < 4; ++i) {
+    LayoutNode* button = CreateNode(
+        tree, actions,
+        "flex-direction: row; align-items: center; flex-shrink: 0; "
+        "padding: 4px",
+        nodes);
+    CreateNode(tree, button, "width: 16px; height: 16px", nodes);
+    CreateNode(tree, button, "width: 24px; height: 12px; margin-left: 4px",
+               nodes);
+  }
+}
+
+// boxes of all nodes after laying the feed out `layouts` times at widths the
+// nodes have not cached sizes for
+std::vector<float> Run(int cards,
+                       int layouts,
+                       bool fast_paths,
+                       double& milliseconds) {
+  LayoutContext layout_context;
+  layout_context.SetFlexFastPaths(fast_paths);
+  LayoutTree tree(&layout_context);
+  std::vector<LayoutNode*> nodes;
+  LayoutNode* feed =
+      CreateNode(tree, nullptr, "flex-direction: column", nodes);
+  for (int i = 0; i < cards; ++i) {
+    BuildCard(tree, feed, i, nodes);
+  }
+
+  milliseconds = benchmark::MillisecondsPerLayout(layouts, [&](int i) {
+    feed->ReLayout(0, 0, 320 + i % 8 * 20, 100000);
+  });
+
+  std::vector<float> boxes;
+  for (LayoutNode* node : nodes) {
+    boxes.insert(boxes.end(),
+                 {node->offset_left(), node->offset_top(),
+                  node->offset_width(), node->offset_height()});
+  }
+  return boxes;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int cards = benchmark::IntArgument(argc, argv, 1, 5000);
+  int layouts = benchmark::IntArgument(argc, argv, 2, 20);
+
+  double milliseconds = .0;
+  std::vector<float> loop_boxes = Run(cards, layouts, false, milliseconds);
+  printf("%-10s %8.3f ms/layout\n", "spec loop", milliseconds);
+
+  std::vector<float> fast_boxes = Run(cards, layouts, true, milliseconds);
+  int differences = 0;
+  for (size_t i = 0; i < fast_boxes.size(); ++i) {
+    differences += fast_boxes[i] != loop_boxes[i];
+  }
+  printf("%-10s %8.3f ms/layout %6d values differ\n", "fast paths",
+         milliseconds, differences);
+  return 0;
+}
\ No newline at end of file
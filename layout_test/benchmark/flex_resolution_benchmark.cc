@@ -0,0 +1,127 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+// resolving the flexible lengths of single long flex lines with each
+// FlexResolution, and whether they agree with the spec loop.
+// usage: flex_resolution_benchmark [items] [layouts]
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "benchmark_util.h"
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+
+namespace {
+
+using benchmark::Random;
+using starlight::FlexResolution;
+using starlight::LayoutContext;
+using starlight::LayoutNode;
+using starlight::LayoutTree;
+
+std::string Pixels(int value) {
+  return std::to_string(value) + "px";
+}
+
+// tags growing from nothing, most of them held up by the width of their text
+void BuildTagCloud(LayoutTree& tree, LayoutNode* line, int items) {
+  Random random(1);
+  for (int i = 0; i < items; ++i) {
+    LayoutNode* tag = tree.CreateNode();
+    tag->SetStyles("flex-grow: 1; flex-basis: 0px; height: 24px");
+    if (random.Next(10) < 8) {
+      tag->SetStyle("min-width", Pixels(20 + random.Next(180)));
+    }
+    line->InsertChild(tag);
+  }
+}
+
+// factors over several magnitudes and both clamps, lines take most rounds
+void BuildMixedClamps(LayoutTree& tree, LayoutNode* line, int items) {
+  Random random(2);
+  for (int i = 0; i < items; ++i) {
+    LayoutNode* item = tree.CreateNode();
+    item->SetStyle("flex-grow", std::to_string(1 << random.Next(12)));
+    item->SetStyle("flex-shrink", std::to_string(1 << random.Next(12)));
+    item->SetStyle("flex-basis", Pixels(random.Next(300)));
+    if (random.Next(2)) {
+      item->SetStyle("min-width", Pixels(random.Next(400)));
+    }
+    if (random.Next(2)) {
+      item->SetStyle("max-width", Pixels(random.Next(400)));
+    }
+    line->InsertChild(item);
+  }
+}
+
+// widths of the items after laying the line out `layouts` times, alternating
+// between two widths so every layout resolves the line again
+std::vector<float> Run(void (*build)(LayoutTree&, LayoutNode*, int),
+                       int items,
+                       int layouts,
+                       const int widths[2],
+                       FlexResolution flex_resolution,
+                       double& milliseconds) {
+  LayoutContext layout_context;
+  layout_context.SetFlexResolution(flex_resolution);
+  LayoutTree tree(&layout_context);
+  LayoutNode* line = tree.CreateNode();
+  line->SetStyle("flex-direction", "row");
+  build(tree, line, items);
+
+  milliseconds = benchmark::MillisecondsPerLayout(layouts, [&](int i) {
+    line->ReLayout(0, 0, widths[i % 2], 100);
+  });
+
+  std::vector<float> sizes;
+  for (LayoutNode* item = line->first_child(); item; item = item->next()) {
+    sizes.push_back(item->offset_width());
+  }
+  return sizes;
+}
+
+void Compare(const char* name,
+             void (*build)(LayoutTree&, LayoutNode*, int),
+             int items,
+             int layouts,
+             const int widths[2]) {
+  static const struct {
+    const char* name_;
+    FlexResolution flex_resolution_;
+  } kResolutions[] = {
+      {"loop", starlight::kFlexResolutionLoop},
+      {"adaptive", starlight::kFlexResolutionAdaptive},
+      {"sweep", starlight::kFlexResolutionSweep},
+  };
+  std::vector<float> loop_sizes;
+  for (const auto& resolution : kResolutions) {
+    double milliseconds = .0;
+    std::vector<float> sizes = Run(build, items, layouts, widths,
+                                   resolution.flex_resolution_, milliseconds);
+    if (loop_sizes.empty()) {
+      loop_sizes = sizes;
+    }
+    int differences = 0;
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      differences += sizes[i] != loop_sizes[i];
+    }
+    printf("%-14s %-9s %8.3f ms/layout %6d items differ\n", name,
+           resolution.name_, milliseconds, differences);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int items = benchmark::IntArgument(argc, argv, 1, 10000);
+  int layouts = benchmark::IntArgument(argc, argv, 2, 50);
+
+  const int tag_cloud_widths[2] = {60 * items, 90 * items};
+  Compare("tag cloud", BuildTagCloud, items, layouts, tag_cloud_widths);
+  const int mixed_clamps_widths[2] = {90 * items, 250 * items};
+  Compare("mixed clamps", BuildMixedClamps, items, layouts,
+          mixed_clamps_widths);
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,148 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+// a dashboard of cards in rows of equal columns, laid out by a grid and by
+// the equivalent nested flex containers, and whether the cards agree.
+// usage: grid_layout_benchmark [columns] [rows] [layouts]
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "benchmark_util.h"
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+
+namespace {
+
+using benchmark::Random;
+using starlight::LayoutContext;
+using starlight::LayoutNode;
+using starlight::LayoutTree;
+
+// a title over a body of lines, as many as the card's content needs
+LayoutNode* CreateCard(LayoutTree& tree, Random& random) {
+  LayoutNode* card = tree.CreateNode();
+  card->SetStyles("flex-direction: column; padding: 8px; margin: 4px");
+  LayoutNode* title = tree.CreateNode();
+  title->SetStyles("height: 20px; margin-bottom: 6px");
+  card->InsertChild(title);
+  LayoutNode* body = tree.CreateNode();
+  body->SetStyle("flex-direction", "column");
+  for (int i = 1 + random.Next(6); i > 0; --i) {
+    LayoutNode* line = tree.CreateNode();
+    line->SetStyles("flex-direction: row; height: 14px");
+    LayoutNode* icon = tree.CreateNode();
+    icon->SetStyles("width: 14px; height: 14px");
+    line->InsertChild(icon);
+    body->InsertChild(line);
+  }
+  card->InsertChild(body);
+  return card;
+}
+
+LayoutNode* BuildGrid(LayoutTree& tree,
+                      int columns,
+                      int rows,
+                      std::vector<LayoutNode*>& cards) {
+  LayoutNode* dashboard = tree.CreateNode();
+  dashboard->SetStyle("display", "grid");
+  dashboard->SetStyle("grid-template-columns",
+                      "repeat(" + std::to_string(columns) + ", 1fr)");
+  Random random(1);
+  for (int i = 0; i < columns * rows; ++i) {
+    LayoutNode* card = CreateCard(tree, random);
+    dashboard->InsertChild(card);
+    cards.push_back(card);
+  }
+  return dashboard;
+}
+
+LayoutNode* BuildNestedFlex(LayoutTree& tree,
+                            int columns,
+                            int rows,
+                            std::vector<LayoutNode*>& cards) {
+  LayoutNode* dashboard = tree.CreateNode();
+  dashboard->SetStyle("flex-direction", "column");
+  Random random(1);
+  for (int r = 0; r < rows; ++r) {
+    LayoutNode* row = tree.CreateNode();
+    row->SetStyle("flex-direction", "row");
+    for (int c = 0; c < columns; ++c) {
+      LayoutNode* card = CreateCard(tree, random);
+      card->SetStyles("flex-grow: 1; flex-basis: 0px");
+      row->InsertChild(card);
+      cards.push_back(card);
+    }
+    dashboard->InsertChild(row);
+  }
+  return dashboard;
+}
+
+// border boxes of the cards relative to the dashboard after laying it out
+// `layouts` times, alternating between two widths so every layout sizes the
+// cards again
+std::vector<float> Run(LayoutNode* (*build)(LayoutTree&,
+                                            int,
+                                            int,
+                                            std::vector<LayoutNode*>&),
+                       int columns,
+                       int rows,
+                       int layouts,
+                       double& milliseconds) {
+  LayoutContext layout_context;
+  LayoutTree tree(&layout_context);
+  std::vector<LayoutNode*> cards;
+  LayoutNode* dashboard = build(tree, columns, rows, cards);
+
+  const int widths[2] = {150 * columns, 200 * columns};
+  milliseconds = benchmark::MillisecondsPerLayout(layouts, [&](int i) {
+    dashboard->ReLayout(starlight::LayoutConstraints(
+        widths[i % 2], .0f, starlight::kLayoutModeExact,
+        starlight::kLayoutModeUndefined));
+  });
+
+  std::vector<float> boxes;
+  for (LayoutNode* card : cards) {
+    float left = card->offset_left();
+    float top = card->offset_top();
+    for (LayoutNode* node = card->parent(); node != dashboard;
+         node = node->parent()) {
+      left += node->offset_left();
+      top += node->offset_top();
+    }
+    boxes.insert(boxes.end(),
+                 {left, top, card->offset_width(), card->offset_height()});
+  }
+  return boxes;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int columns = benchmark::IntArgument(argc, argv, 1, 8);
+  int rows = benchmark::IntArgument(argc, argv, 2, 500);
+  int layouts = benchmark::IntArgument(argc, argv, 3, 50);
+
+  double flex_milliseconds = .0;
+  std::vector<float> flex_boxes =
+      Run(BuildNestedFlex, columns, rows, layouts, flex_milliseconds);
+  printf("%-12s %8.3f ms/layout\n", "nested flex", flex_milliseconds);
+
+  double grid_milliseconds = .0;
+  std::vector<float> grid_boxes =
+      Run(BuildGrid, columns, rows, layouts, grid_milliseconds);
+  int differences = 0;
+  for (size_t i = 0; i < grid_boxes.size(); i += 4) {
+    for (size_t j = i; j < i + 4; ++j) {
+      if (std::abs(grid_boxes[j] - flex_boxes[j]) > .01f) {
+        ++differences;
+        break;
+      }
+    }
+  }
+  printf("%-12s %8.3f ms/layout %6d cards differ\n", "grid",
+         grid_milliseconds, differences);
+  return 0;
+}
\ No newline at end of file
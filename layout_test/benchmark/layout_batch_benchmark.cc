@@ -0,0 +1,96 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+// throughput of laying out many small independent cell trees, one by one and
+// as one batch. usage: layout_batch_benchmark [rows] [threads]
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "base/thread_pool.h"
+#include "benchmark_util.h"
+#include "layout/layout_batch.h"
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+
+namespace {
+
+using starlight::LayoutConstraints;
+using starlight::LayoutNode;
+using starlight::LayoutRequest;
+using starlight::LayoutTree;
+
+// a feed row: avatar, two text lines and a row of three buttons
+LayoutNode* BuildCell(LayoutTree& tree, int row) {
+  LayoutNode* cell = tree.CreateNode();
+  cell->SetStyles("flex-direction: row; padding: 8px; align-items: center");
+  LayoutNode* avatar = tree.CreateNode();
+  avatar->SetStyles("width: 40px; height: 40px; margin-right: 8px");
+  cell->InsertChild(avatar);
+
+  LayoutNode* content = tree.CreateNode();
+  content->SetStyles("flex-direction: column; flex-grow: 1; flex-shrink: 1");
+  cell->InsertChild(content);
+  LayoutNode* title = tree.CreateNode();
+  title->SetStyles("height: 20px");
+  content->InsertChild(title);
+  LayoutNode* text = tree.CreateNode();
+  // rows differ in the length of their text
+  text->SetStyle("height", row % 3 == 0 ? "60px" : "40px");
+  content->InsertChild(text);
+  LayoutNode* actions = tree.CreateNode();
+  actions->SetStyles("flex-direction: row; justify-content: space-between");
+  content->InsertChild(actions);
+  for (int i = 0; i < 3; ++i) {
+    LayoutNode* button = tree.CreateNode();
+    button->SetStyles("width: 48px; height: 24px");
+    actions->InsertChild(button);
+  }
+  return cell;
+}
+
+void Report(const char* name, int rows, double milliseconds) {
+  printf("%-24s %8.2f ms %10.0f rows/s\n", name, milliseconds,
+         rows / milliseconds * 1000);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int rows = benchmark::IntArgument(argc, argv, 1, 10000);
+  int threads = benchmark::IntArgument(
+      argc, argv, 2, static_cast<int>(std::thread::hardware_concurrency()));
+  base::ThreadPool thread_pool(threads > 1 ? threads - 1 : 0);
+
+  for (int pass = 0; pass < 2; ++pass) {
+    // fresh trees every pass, nothing is answered from the measure caches
+    LayoutTree tree;
+    std::vector<LayoutRequest> requests;
+    requests.reserve(rows);
+    for (int row = 0; row < rows; ++row) {
+      // width is given, height follows from the content
+      requests.emplace_back(
+          BuildCell(tree, row),
+          LayoutConstraints(360 + row % 4 * 10, .0f,
+                            starlight::kLayoutModeExact,
+                            starlight::kLayoutModeUndefined));
+    }
+
+    if (pass == 0) {
+      Report("ReLayout one by one", rows,
+             benchmark::MillisecondsPerLayout(1, [&](int) {
+               for (const LayoutRequest& request : requests) {
+                 request.root_->ReLayout(request.constraints_);
+               }
+             }));
+    } else {
+      Report("LayoutBatch", rows,
+             benchmark::MillisecondsPerLayout(1, [&](int) {
+               starlight::LayoutBatch(requests.data(), requests.size(),
+                                      &thread_pool);
+             }));
+    }
+  }
+  return 0;
+}
\ No newline at end of file
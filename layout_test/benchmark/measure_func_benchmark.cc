@@ -0,0 +1,161 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+// a feed of rows holding an avatar and a text label, labels repeat a small
+// set of strings. laid out with and without the tree's measure func cache,
+// counting calls into the measure func and whether label boxes agree.
+// usage: measure_func_benchmark [rows] [strings] [layouts]
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "benchmark_util.h"
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+
+namespace {
+
+using benchmark::Random;
+using starlight::FloatSize;
+using starlight::LayoutContext;
+using starlight::LayoutMode;
+using starlight::LayoutNode;
+using starlight::LayoutTree;
+
+const float kLineHeight = 18.f;
+
+int measure_calls = 0;
+
+// advance of a glyph, the way a host shaping text might spend its time
+float GlyphAdvance(char glyph) {
+  float advance = 6.f + static_cast<unsigned char>(glyph) % 5;
+  for (int i = 0; i < 16; ++i) {
+    advance = advance * 1.0001f + .0001f;
+  }
+  return advance;
+}
+
+// greedy line breaking at spaces within an exact or at-most width
+FloatSize MeasureText(void* context,
+                      float width,
+                      LayoutMode width_mode,
+                      float height,
+                      LayoutMode height_mode) {
+  ++measure_calls;
+  const std::string& text = *static_cast<const std::string*>(context);
+  bool wraps = width_mode != starlight::kLayoutModeUndefined;
+  float line_width = .0f;
+  float max_line_width = .0f;
+  int lines = 1;
+  size_t start = 0;
+  while (start < text.size()) {
+    size_t end = text.find(' ', start);
+    end = end == std::string::npos ? text.size() : end;
+    float word_width = .0f;
+    for (size_t i = start; i < end; ++i) {
+      word_width += GlyphAdvance(text[i]);
+    }
+    float space_width = line_width > 0 ? GlyphAdvance(' ') : .0f;
+    if (wraps && line_width > 0 &&
+        line_width + space_width + word_width > width) {
+      ++lines;
+      line_width = word_width;
+    } else {
+      line_width += space_width + word_width;
+    }
+    max_line_width = std::max(max_line_width, line_width);
+    start = end + 1;
+  }
+  return FloatSize(max_line_width, lines * kLineHeight);
+}
+
+std::vector<std::string> BuildStrings(int count) {
+  static const char* kWords[] = {"layout", "flex", "grid", "text", "label",
+                                 "row",    "node", "tree", "size", "width"};
+  Random random(1);
+  std::vector<std::string> strings;
+  for (int i = 0; i < count; ++i) {
+    std::string text;
+    for (int words = 1 + random.Next(12); words > 0; --words) {
+      text += text.empty() ? "" : " ";
+      text += kWords[random.Next(10)];
+    }
+    strings.push_back(text);
+  }
+  return strings;
+}
+
+// label boxes after laying the feed out `layouts` times, cycling through more
+// widths than a node caches sizes for so every layout measures the labels
+// again
+std::vector<float> Run(int rows,
+                       std::vector<std::string>& strings,
+                       int layouts,
+                       size_t cache_capacity,
+                       double& milliseconds,
+                       double& calls) {
+  LayoutContext layout_context;
+  LayoutTree tree(&layout_context);
+  tree.measure_func_cache().SetCapacity(cache_capacity);
+  LayoutNode* feed = tree.CreateNode();
+  feed->SetStyle("flex-direction", "column");
+  std::vector<LayoutNode*> labels;
+  Random random(2);
+  for (int i = 0; i < rows; ++i) {
+    LayoutNode* row = tree.CreateNode();
+    row->SetStyles("flex-direction: row; padding: 8px; align-items: center");
+    LayoutNode* avatar = tree.CreateNode();
+    avatar->SetStyles("width: 40px; height: 40px; margin-right: 8px");
+    row->InsertChild(avatar);
+    LayoutNode* label = tree.CreateNode();
+    label->SetStyles("flex-shrink: 1");
+    label->SetContext(&strings[random.Next(strings.size())]);
+    label->SetMeasureFunc(MeasureText);
+    row->InsertChild(label);
+    feed->InsertChild(row);
+    labels.push_back(label);
+  }
+
+  measure_calls = 0;
+  milliseconds = benchmark::MillisecondsPerLayout(layouts, [&](int i) {
+    feed->ReLayout(0, 0, 320 + i % 8 * 20, 100000);
+  });
+  calls = static_cast<double>(measure_calls) / layouts;
+
+  std::vector<float> boxes;
+  for (LayoutNode* label : labels) {
+    boxes.insert(boxes.end(),
+                 {label->offset_left(), label->offset_top(),
+                  label->offset_width(), label->offset_height()});
+  }
+  return boxes;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int rows = benchmark::IntArgument(argc, argv, 1, 20000);
+  int string_count = benchmark::IntArgument(argc, argv, 2, 200);
+  int layouts = benchmark::IntArgument(argc, argv, 3, 20);
+  std::vector<std::string> strings = BuildStrings(string_count);
+
+  double milliseconds = .0;
+  double calls = .0;
+  std::vector<float> uncached_boxes =
+      Run(rows, strings, layouts, 0, milliseconds, calls);
+  printf("%-10s %8.3f ms/layout %10.1f calls/layout\n", "per node",
+         milliseconds, calls);
+
+  std::vector<float> cached_boxes =
+      Run(rows, strings, layouts,
+          starlight::MeasureFuncCache::kDefaultCapacity, milliseconds, calls);
+  int differences = 0;
+  for (size_t i = 0; i < cached_boxes.size(); ++i) {
+    differences += cached_boxes[i] != uncached_boxes[i];
+  }
+  printf("%-10s %8.3f ms/layout %10.1f calls/layout %6d values differ\n",
+         "shared", milliseconds, calls, differences);
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+// a feed of rows holding an avatar and a text label, every label distinct so
+// no measure results can be shared. labels are sized once by a measure func
+// breaking the text on each call, as a host would, and once as text leaves
+// of a registered font. prints time per layout and whether label boxes agree.
+// usage: text_layout_benchmark [rows] [layouts]
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "benchmark_util.h"
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+
+namespace {
+
+using benchmark::Random;
+using starlight::FloatSize;
+using starlight::FontMetrics;
+using starlight::LayoutContext;
+using starlight::LayoutMode;
+using starlight::LayoutNode;
+using starlight::LayoutTree;
+
+FontMetrics BuildFont() {
+  FontMetrics font;
+  font.advances_.resize(128);
+  for (size_t i = 0; i < font.advances_.size(); ++i) {
+    font.advances_[i] = 5.f + i % 7 * .75f;
+  }
+  font.default_advance_ = 12.f;
+  font.line_height_ = 18.f;
+  return font;
+}
+
+const FontMetrics kFont = BuildFont();
+
+// greedy breaking at spaces of ascii text, the same way text leaves break it
+FloatSize MeasureText(void* context,
+                      float width,
+                      LayoutMode width_mode,
+                      float height,
+                      LayoutMode height_mode) {
+  const std::string& text = *static_cast<const std::string*>(context);
+  bool wraps = width_mode != starlight::kLayoutModeUndefined;
+  float max_line_width = .0f;
+  float line_width = .0f;
+  float pending_space = .0f;
+  int lines = 0;
+  size_t start = 0;
+  while (start < text.size()) {
+    size_t end = text.find(' ', start);
+    end = end == std::string::npos ? text.size() : end;
+    float word_width = .0f;
+    for (size_t i = start; i < end; ++i) {
+      word_width += kFont.Advance(static_cast<unsigned char>(text[i]));
+    }
+    if (lines == 0) {
+      ++lines;
+      line_width = word_width;
+    } else if (wraps && line_width + pending_space + word_width > width) {
+      max_line_width = std::max(max_line_width, line_width);
+      ++lines;
+      line_width = word_width;
+    } else {
+      line_width += pending_space + word_width;
+    }
+    pending_space = end < text.size() ? kFont.Advance(' ') : .0f;
+    start = end + 1;
+  }
+  max_line_width = std::max(max_line_width, line_width);
+  return FloatSize(max_line_width, lines * kFont.line_height_);
+}
+
+std::vector<std::string> BuildStrings(int count) {
+  Random random(1);
+  std::vector<std::string> strings;
+  for (int i = 0; i < count; ++i) {
+    std::string text;
+    for (int words = 1 + random.Next(12); words > 0; --words) {
+      text += text.empty() ? "" : " ";
+      for (int length = 2 + random.Next(8); length > 0; --length) {
+        text += static_cast<char>('a' + random.Next(26));
+      }
+    }
+    strings.push_back(text);
+  }
+  return strings;
+}
+
+// label boxes after laying the feed out `layouts` times, cycling through more
+// widths than a node caches sizes for so every layout measures the labels
+// again
+std::vector<float> Run(std::vector<std::string>& strings,
+                       int layouts,
+                       bool text_leaves,
+                       double& milliseconds) {
+  LayoutContext layout_context;
+  int font = layout_context.RegisterFont(kFont);
+  LayoutTree tree(&layout_context);
+  LayoutNode* feed = tree.CreateNode();
+  feed->SetStyle("flex-direction", "column");
+  std::vector<LayoutNode*> labels;
+  for (std::string& text : strings) {
+    LayoutNode* row = tree.CreateNode();
+    row->SetStyles("flex-direction: row; padding: 8px; align-items: center");
+    LayoutNode* avatar = tree.CreateNode();
+    avatar->SetStyles("width: 40px; height: 40px; margin-right: 8px");
+    row->InsertChild(avatar);
+    LayoutNode* label = tree.CreateNode();
+    label->SetStyles("flex-shrink: 1");
+    if (text_leaves) {
+      label->SetText(text, font);
+    } else {
+      label->SetContext(&text);
+      label->SetMeasureFunc(MeasureText);
+    }
+    row->InsertChild(label);
+    feed->InsertChild(row);
+    labels.push_back(label);
+  }
+
+  milliseconds = benchmark::MillisecondsPerLayout(layouts, [&](int i) {
+    feed->ReLayout(0, 0, 320 + i % 8 * 20, 100000);
+  });
+
+  std::vector<float> boxes;
+  for (LayoutNode* label : labels) {
+    boxes.insert(boxes.end(),
+                 {label->offset_left(), label->offset_top(),
+                  label->offset_width(), label->offset_height()});
+  }
+  return boxes;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int rows = benchmark::IntArgument(argc, argv, 1, 20000);
+  int layouts = benchmark::IntArgument(argc, argv, 2, 20);
+  std::vector<std::string> strings = BuildStrings(rows);
+
+  double milliseconds = .0;
+  std::vector<float> func_boxes = Run(strings, layouts, false, milliseconds);
+  printf("%-12s %8.3f ms/layout\n", "measure func", milliseconds);
+
+  std::vector<float> text_boxes = Run(strings, layouts, true, milliseconds);
+  int differences = 0;
+  for (size_t i = 0; i < text_boxes.size(); ++i) {
+    differences += text_boxes[i] != func_boxes[i];
+  }
+  printf("%-12s %8.3f ms/layout %6d values differ\n", "text leaf",
+         milliseconds, differences);
+  return 0;
+}
\ No newline at end of file
@@ -146,10 +146,8 @@ function processStyleKey(value) {
 	}
 	if (value.indexOf('-')>-1) {
 		var keySplit = value.split('-');
-		// 将第二个单词转为驼峰
-		var secWord = keySplit[1];
-		var upperSecWord = upperFirstWord(secWord);
-		return keySplit[0] + upperSecWord;
+		// 将第一个之后的单词都转为驼峰，如 grid-template-columns
+		return keySplit[0] + keySplit.slice(1).map(upperFirstWord).join('');
 	} else {
 		return value;
 	}
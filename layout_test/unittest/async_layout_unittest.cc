@@ -0,0 +1,145 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include <future>
+
+#include "gtest/gtest.h"
+
+#include "layout/async_layout.h"
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+
+namespace starlight {
+
+namespace {
+
+LayoutConstraints ExactConstraints(float width, float height) {
+  return LayoutConstraints(width, height, kLayoutModeExact, kLayoutModeExact);
+}
+
+}  // namespace
+
+/**
+ * a row holding two items, bound to an AsyncLayout. the tree is built before
+ * it is bound, later changes go through mutations.
+ */
+class AsyncLayoutTest : public testing::Test {
+ public:
+  AsyncLayoutTest() : tree_(&layout_context_) {
+    root_ = tree_.CreateNode();
+    root_->SetStyle("flex-direction", "row");
+    first_ = tree_.CreateNode();
+    first_->SetStyles("width: 40px; height: 20px");
+    root_->InsertChild(first_);
+    second_ = tree_.CreateNode();
+    second_->SetStyles("flex-grow: 1; height: 30px; margin-left: 10px");
+    root_->InsertChild(second_);
+  }
+
+ protected:
+  LayoutContext layout_context_;
+  LayoutTree tree_;
+  LayoutNode* root_;
+  LayoutNode* first_;
+  LayoutNode* second_;
+};
+
+TEST_F(AsyncLayoutTest, CommitPublishedFrame) {
+  AsyncLayout async_layout(root_);
+  EXPECT_FALSE(async_layout.Commit());
+  async_layout.RequestLayout(ExactConstraints(200, 100));
+  async_layout.WaitUntilIdle();
+  ASSERT_TRUE(async_layout.Commit());
+  // nothing new was published
+  EXPECT_FALSE(async_layout.Commit());
+
+  const LayoutResult& root = async_layout.GetResult(root_);
+  EXPECT_EQ(200, root.offset_width_);
+  EXPECT_EQ(100, root.offset_height_);
+  const LayoutResult& second = async_layout.GetResult(second_);
+  EXPECT_EQ(50, second.offset_left_);
+  EXPECT_EQ(0, second.offset_top_);
+  EXPECT_EQ(150, second.offset_width_);
+  EXPECT_EQ(30, second.offset_height_);
+}
+
+TEST_F(AsyncLayoutTest, MutationsApplyInOrder) {
+  AsyncLayout async_layout(root_);
+  LayoutNode* first = first_;
+  async_layout.Mutate([first] { first->SetStyle("width", "100px"); });
+  async_layout.Mutate([first] { first->SetStyle("width", "60px"); });
+  async_layout.RequestLayout(ExactConstraints(200, 100));
+  async_layout.WaitUntilIdle();
+  ASSERT_TRUE(async_layout.Commit());
+  EXPECT_EQ(60, async_layout.GetResult(first_).offset_width_);
+  EXPECT_EQ(70, async_layout.GetResult(second_).offset_left_);
+}
+
+// a published frame is not visible before Commit, the committed one stays
+TEST_F(AsyncLayoutTest, ResultsStayUntilCommit) {
+  AsyncLayout async_layout(root_);
+  async_layout.RequestLayout(ExactConstraints(200, 100));
+  async_layout.WaitUntilIdle();
+  ASSERT_TRUE(async_layout.Commit());
+
+  LayoutNode* first = first_;
+  async_layout.Mutate([first] {
+    first->SetStyles("height: 50px; margin-left: 5px");
+  });
+  async_layout.RequestLayout(ExactConstraints(300, 100));
+  async_layout.WaitUntilIdle();
+  EXPECT_EQ(200, async_layout.GetResult(root_).offset_width_);
+  EXPECT_EQ(20, async_layout.GetResult(first_).offset_height_);
+  EXPECT_EQ(0, async_layout.GetResult(first_).offset_left_);
+
+  ASSERT_TRUE(async_layout.Commit());
+  EXPECT_EQ(300, async_layout.GetResult(root_).offset_width_);
+  EXPECT_EQ(50, async_layout.GetResult(first_).offset_height_);
+  EXPECT_EQ(5, async_layout.GetResult(first_).offset_left_);
+}
+
+// the first pass is still running when the second is requested: it is never
+// published, only the second one is
+TEST_F(AsyncLayoutTest, SupersededPassIsNotPublished) {
+  std::promise<void> first_started;
+  std::promise<void> finish_first;
+  std::promise<void> second_started;
+  std::promise<void> finish_second;
+  AsyncLayout async_layout(root_);
+  async_layout.Mutate([&first_started, &finish_first] {
+    first_started.set_value();
+    finish_first.get_future().wait();
+  });
+  async_layout.RequestLayout(ExactConstraints(200, 100));
+  first_started.get_future().wait();
+
+  LayoutNode* first = first_;
+  async_layout.Mutate([&second_started, &finish_second, first] {
+    second_started.set_value();
+    finish_second.get_future().wait();
+    first->SetStyle("width", "80px");
+  });
+  async_layout.RequestLayout(ExactConstraints(250, 100));
+  finish_first.set_value();
+  second_started.get_future().wait();
+  EXPECT_FALSE(async_layout.Commit());
+
+  finish_second.set_value();
+  async_layout.WaitUntilIdle();
+  ASSERT_TRUE(async_layout.Commit());
+  EXPECT_EQ(250, async_layout.GetResult(root_).offset_width_);
+  EXPECT_EQ(80, async_layout.GetResult(first_).offset_width_);
+  EXPECT_FALSE(async_layout.Commit());
+}
+
+// mutations without a requested pass are dropped with the AsyncLayout
+TEST_F(AsyncLayoutTest, DestroyDropsQueuedMutations) {
+  bool applied = false;
+  {
+    AsyncLayout async_layout(root_);
+    async_layout.Mutate([&applied] { applied = true; });
+  }
+  EXPECT_FALSE(applied);
+}
+
+}  // namespace starlight
\ No newline at end of file
@@ -0,0 +1,152 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "layout/flex_kernels.h"
+
+namespace starlight {
+
+namespace {
+
+// a number below `bound` picked by `seed`, the same on every platform
+int Pick(uint32_t seed, int bound) {
+  seed = seed * 2654435761u;
+  seed ^= seed >> 15;
+  seed *= 2246822519u;
+  seed ^= seed >> 13;
+  return static_cast<int>(seed % static_cast<uint32_t>(bound));
+}
+
+// sizes in sevenths, factors over several magnitudes, some of them zero,
+// clamps which hold an item on either side and frozen items with a size
+void FillLine(FlexLineArrays& arrays, size_t count, uint32_t seed) {
+  arrays.Reset(count);
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t item_seed = seed + static_cast<uint32_t>(i) * 8;
+    arrays.flex_base_size_[i] = Pick(item_seed, 2100) / 7.f;
+    arrays.flex_grow_[i] = Pick(item_seed + 1, 4) == 0
+                               ? .0f
+                               : (1 << Pick(item_seed + 1, 10)) / 3.f;
+    arrays.flex_shrink_[i] = Pick(item_seed + 2, 4) == 0
+                                 ? .0f
+                                 : (1 << Pick(item_seed + 2, 10)) / 3.f;
+    arrays.min_size_[i] =
+        Pick(item_seed + 3, 2) ? Pick(item_seed + 4, 1750) / 7.f : .0f;
+    arrays.max_size_[i] = Pick(item_seed + 5, 2)
+                              ? Pick(item_seed + 6, 2800) / 7.f
+                              : std::numeric_limits<float>::max();
+    arrays.min_border_box_size_[i] = Pick(item_seed + 7, 4) == 0 ? 30.f : .0f;
+    arrays.frozen_[i] = Pick(item_seed + 3, 5) == 0 ? ~0u : 0u;
+    arrays.used_size_[i] = arrays.frozen_[i] ? arrays.flex_base_size_[i] : .0f;
+  }
+}
+
+// the per-item arithmetic the kernel replaces
+void ResolveOneByOne(FlexLineArrays& arrays,
+                     FreeSpaceShare share,
+                     float free_space,
+                     float total_factor) {
+  for (size_t i = 0; i < arrays.count_; ++i) {
+    if (arrays.frozen_[i]) {
+      continue;
+    }
+    float flex_base_size = arrays.flex_base_size_[i];
+    float extra_space = .0f;
+    if (share == kFreeSpaceShareGrow) {
+      extra_space = free_space * arrays.flex_grow_[i] / total_factor;
+    } else if (share == kFreeSpaceShareShrink && arrays.flex_shrink_[i] != 0) {
+      extra_space =
+          free_space * arrays.flex_shrink_[i] * flex_base_size / total_factor;
+    }
+    float target_size = flex_base_size + extra_space;
+    float used_size = std::max(target_size, arrays.min_size_[i]);
+    used_size = std::min(used_size, arrays.max_size_[i]);
+    used_size = std::max(used_size, arrays.min_border_box_size_[i]);
+    arrays.target_size_[i] = target_size;
+    arrays.used_size_[i] = used_size;
+  }
+}
+
+// bits of a float, so that zeros of either sign are told apart
+uint32_t Bits(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+}  // namespace
+
+TEST(FlexKernelsTest, ResetPadsWithFrozenItems) {
+  size_t lanes = kFlexLaneCount;
+  FlexLineArrays arrays;
+  arrays.Reset(lanes + 1);
+  EXPECT_EQ(lanes + 1, arrays.count_);
+  ASSERT_EQ(2 * lanes, arrays.frozen_.size());
+  EXPECT_EQ(2 * lanes, arrays.used_size_.size());
+  for (size_t i = lanes + 1; i < arrays.frozen_.size(); ++i) {
+    EXPECT_EQ(~0u, arrays.frozen_[i]);
+  }
+
+  arrays.Reset(0);
+  EXPECT_EQ(0u, arrays.count_);
+  EXPECT_TRUE(arrays.frozen_.empty());
+}
+
+// each lane gives the bits of the per-item code, on counts which fill no,
+// one or several vectors exactly and some which leave a partial one
+TEST(FlexKernelsTest, ResolveFlexItemSizesMatchesScalar) {
+  size_t lanes = kFlexLaneCount;
+  const size_t counts[] = {0,         1,         lanes - 1, lanes,
+                           lanes + 1, 2 * lanes, 3 * lanes + 2, 1000};
+  const FreeSpaceShare shares[] = {kFreeSpaceShareNone, kFreeSpaceShareGrow,
+                                   kFreeSpaceShareShrink};
+  const float free_spaces[] = {-1234.5f / 7.f, -.5f, .0f, 3.f / 7.f,
+                               98765.f / 7.f};
+  for (size_t count : counts) {
+    for (FreeSpaceShare share : shares) {
+      for (float free_space : free_spaces) {
+        for (uint32_t seed = 0; seed < 40; seed += 8) {
+          SCOPED_TRACE(std::to_string(count) + " items, share " +
+                       std::to_string(share) + ", free space " +
+                       std::to_string(free_space));
+          FlexLineArrays expected;
+          FillLine(expected, count, seed);
+          FlexLineArrays actual;
+          FillLine(actual, count, seed);
+          float total_factor = .0f;
+          for (size_t i = 0; i < count; ++i) {
+            if (!expected.frozen_[i]) {
+              total_factor += share == kFreeSpaceShareShrink
+                                  ? expected.flex_shrink_[i] *
+                                        expected.flex_base_size_[i]
+                                  : expected.flex_grow_[i];
+            }
+          }
+          // callers share out nothing without factors
+          FreeSpaceShare used_share =
+              total_factor > 0 ? share : kFreeSpaceShareNone;
+          ResolveOneByOne(expected, used_share, free_space, total_factor);
+          ResolveFlexItemSizes(actual, used_share, free_space, total_factor);
+          for (size_t i = 0; i < count; ++i) {
+            EXPECT_EQ(Bits(expected.used_size_[i]), Bits(actual.used_size_[i]))
+                << "item " << i;
+            if (!expected.frozen_[i]) {
+              EXPECT_EQ(Bits(expected.target_size_[i]),
+                        Bits(actual.target_size_[i]))
+                  << "item " << i;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace starlight
\ No newline at end of file
@@ -0,0 +1,208 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+
+namespace starlight {
+
+namespace {
+
+// a number below `bound` picked by `seed`, the same on every platform
+int Pick(uint32_t seed, int bound) {
+  seed = seed * 2654435761u;
+  seed ^= seed >> 15;
+  seed *= 2246822519u;
+  seed ^= seed >> 13;
+  return static_cast<int>(seed % static_cast<uint32_t>(bound));
+}
+
+// sevenths of a pixel, so that sums of sizes get rounded
+std::string Pixels(int sevenths) {
+  return std::to_string(sevenths / 7.f) + "px";
+}
+
+// a row of `count` items with factors over several magnitudes and either
+// clamp, laid out at `width` by a context of its own
+struct ClampedLine {
+  ClampedLine(int count,
+              int width,
+              const char* wrap,
+              FlexResolution flex_resolution)
+      : tree_(&layout_context_) {
+    layout_context_.SetFlexResolution(flex_resolution);
+    LayoutNode* line = tree_.CreateNode();
+    line->SetStyles("flex-direction: row; align-items: flex-start");
+    line->SetStyle("flex-wrap", wrap);
+    for (int i = 0; i < count; ++i) {
+      uint32_t seed = static_cast<uint32_t>(i * 8);
+      LayoutNode* item = tree_.CreateNode();
+      item->SetStyle("flex-grow", std::to_string((1 << Pick(seed, 10)) / 3.f));
+      item->SetStyle("flex-shrink",
+                     std::to_string((1 << Pick(seed + 1, 10)) / 3.f));
+      item->SetStyle("flex-basis", Pixels(Pick(seed + 2, 2100)));
+      item->SetStyle("height", "10px");
+      if (Pick(seed + 3, 3) != 0) {
+        item->SetStyle("min-width", Pixels(Pick(seed + 4, 1750)));
+      }
+      if (Pick(seed + 5, 3) != 0) {
+        item->SetStyle("max-width", Pixels(Pick(seed + 6, 2800)));
+      }
+      if (Pick(seed + 7, 4) == 0) {
+        item->SetStyle("padding-left", "30px");
+      }
+      line->InsertChild(item);
+    }
+    line->ReLayout(0, 0, width, 100000);
+    for (LayoutNode* item = line->first_child(); item; item = item->next()) {
+      boxes_.push_back(item->offset_left());
+      boxes_.push_back(item->offset_top());
+      boxes_.push_back(item->offset_width());
+    }
+  }
+
+  LayoutContext layout_context_;
+  LayoutTree tree_;
+  // left, top and width of each item
+  std::vector<float> boxes_;
+};
+
+// the items of `styles` in a container of its own, laid out at `size` along
+// the main axis, with or without the fast paths for trivial lines
+struct FastPathLine {
+  FastPathLine(bool fast_paths,
+               FlexResolution flex_resolution,
+               const char* direction,
+               const char* wrap,
+               int size,
+               const std::vector<std::string>& styles)
+      : tree_(&layout_context_) {
+    layout_context_.SetFlexFastPaths(fast_paths);
+    layout_context_.SetFlexResolution(flex_resolution);
+    LayoutNode* line = tree_.CreateNode();
+    line->SetStyles("align-items: flex-start; align-content: flex-start");
+    line->SetStyle("flex-direction", direction);
+    line->SetStyle("flex-wrap", wrap);
+    for (const std::string& style : styles) {
+      LayoutNode* item = tree_.CreateNode();
+      item->SetStyles(style);
+      line->InsertChild(item);
+    }
+    bool row = std::string(direction) == "row";
+    line->ReLayout(0, 0, row ? size : 100000, row ? 100000 : size);
+    for (LayoutNode* item = line->first_child(); item; item = item->next()) {
+      boxes_.push_back(item->offset_left());
+      boxes_.push_back(item->offset_top());
+      boxes_.push_back(item->offset_width());
+      boxes_.push_back(item->offset_height());
+    }
+  }
+
+  LayoutContext layout_context_;
+  LayoutTree tree_;
+  // left, top, width and height of each item
+  std::vector<float> boxes_;
+};
+
+// an item with either factor zero or not, and a min, max or min border box
+// size on the main axis which may hold it off its share of the free space
+std::string TrivialItem(uint32_t seed, bool row) {
+  static const char* const kFactors[] = {"0", "0.4", "1", "3"};
+  std::string width = row ? "width" : "height";
+  std::string left = row ? "left" : "top";
+  std::string style = "flex-grow: " + std::string(kFactors[Pick(seed, 4)]) +
+                      "; flex-shrink: " + kFactors[Pick(seed + 1, 4)] +
+                      "; flex-basis: " + Pixels(Pick(seed + 2, 1400)) +
+                      "; " + (row ? "height" : "width") + ": 10px";
+  switch (Pick(seed + 3, 4)) {
+    case 0:
+      style += "; min-" + width + ": " + Pixels(Pick(seed + 4, 1400));
+      break;
+    case 1:
+      style += "; max-" + width + ": " + Pixels(Pick(seed + 4, 1400));
+      break;
+    case 2:
+      style += "; padding-" + left + ": " + Pixels(Pick(seed + 4, 700)) +
+               "; border-" + left + ": " + Pixels(Pick(seed + 5, 700));
+      break;
+  }
+  return style;
+}
+
+}  // namespace
+
+// the sweep takes sums out of item order, yet it freezes the same items in
+// the same rounds and gives the used sizes of the spec loop bit for bit
+TEST(FlexResolutionTest, SweepMatchesLoop) {
+  const int counts[] = {1, 2, 7, 64, 1000};
+  const char* wraps[] = {"nowrap", "wrap"};
+  for (int count : counts) {
+    // lines which shrink, hardly grow and grow a lot
+    const int widths[] = {20 * count, 150 * count, 600 * count};
+    for (int width : widths) {
+      for (const char* wrap : wraps) {
+        SCOPED_TRACE(std::to_string(count) + " items at " +
+                     std::to_string(width) + " " + wrap);
+        ClampedLine loop(count, width, wrap, kFlexResolutionLoop);
+        ClampedLine adaptive(count, width, wrap, kFlexResolutionAdaptive);
+        ClampedLine sweep(count, width, wrap, kFlexResolutionSweep);
+        EXPECT_EQ(loop.boxes_, adaptive.boxes_);
+        EXPECT_EQ(loop.boxes_, sweep.boxes_);
+      }
+    }
+  }
+}
+
+// the closed forms for lines of inflexible items and lines of a single
+// flexible item give the sizes of the loop, growing and shrinking
+TEST(FlexFastPathsTest, SameAsLoop) {
+  const FlexResolution resolutions[] = {
+      kFlexResolutionLoop, kFlexResolutionAdaptive, kFlexResolutionSweep};
+  const char* directions[] = {"row", "column"};
+  const int sizes[] = {0, 50, 100, 200, 400};
+  for (FlexResolution resolution : resolutions) {
+    for (const char* direction : directions) {
+      bool row = std::string(direction) == "row";
+      for (uint32_t seed = 0; seed < 800; seed += 8) {
+        std::vector<std::string> single = {TrivialItem(seed, row)};
+        // wrapped, most lines hold a single item
+        std::vector<std::string> items;
+        // several items on one line, none of them flexible
+        std::vector<std::string> inflexible;
+        for (uint32_t i = 0; i < 5; ++i) {
+          items.push_back(TrivialItem(seed + i * 8, row));
+          inflexible.push_back(items.back() + "; flex-grow: 0; flex-shrink: 0");
+        }
+        for (int size : sizes) {
+          SCOPED_TRACE(single[0] + " at " + std::to_string(size) + " in a " +
+                       direction);
+          EXPECT_EQ(FastPathLine(false, resolution, direction, "nowrap", size,
+                                 single)
+                        .boxes_,
+                    FastPathLine(true, resolution, direction, "nowrap", size,
+                                 single)
+                        .boxes_);
+          EXPECT_EQ(
+              FastPathLine(false, resolution, direction, "wrap", size, items)
+                  .boxes_,
+              FastPathLine(true, resolution, direction, "wrap", size, items)
+                  .boxes_);
+          EXPECT_EQ(FastPathLine(false, resolution, direction, "nowrap",
+                                 size * 5, inflexible)
+                        .boxes_,
+                    FastPathLine(true, resolution, direction, "nowrap",
+                                 size * 5, inflexible)
+                        .boxes_);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace starlight
\ No newline at end of file
@@ -0,0 +1,47 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include <limits>
+
+#include "gtest/gtest.h"
+
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+#include "layout/style.h"
+
+namespace starlight {
+
+// lines past GridLine::kMaxValue land on it, whether parsed or set as values
+TEST(GridLayoutTest, LinesPastMaxValue) {
+  LayoutContext layout_context;
+  LayoutTree tree(&layout_context);
+  LayoutNode* grid = tree.CreateNode();
+  grid->SetStyle("display", "grid");
+  LayoutNode* before = tree.CreateNode();
+  before->SetStyles(
+      "grid-row-start: 1; grid-column-start: 9999; width: 7px; height: 5px");
+  grid->InsertChild(before);
+  LayoutNode* parsed = tree.CreateNode();
+  parsed->SetStyles(
+      "grid-row-start: 100000; grid-column-start: 100000; width: 10px; "
+      "height: 10px");
+  grid->InsertChild(parsed);
+  LayoutNode* set = tree.CreateNode();
+  set->SetStyles("width: 10px; height: 10px");
+  GridLine far_line(std::numeric_limits<int>::max(), false);
+  set->SetStyle(kStylePropertyGridRowStart, far_line);
+  set->SetStyle(kStylePropertyGridColumnStart, far_line);
+  grid->InsertChild(set);
+
+  // sized to the content, auto tracks do not stretch
+  grid->ReLayout(LayoutConstraints(0, 0, kLayoutModeUndefined,
+                                   kLayoutModeUndefined));
+  EXPECT_EQ(7.f, parsed->offset_left());
+  EXPECT_EQ(5.f, parsed->offset_top());
+  EXPECT_EQ(parsed->offset_left(), set->offset_left());
+  EXPECT_EQ(parsed->offset_top(), set->offset_top());
+  EXPECT_EQ(17.f, grid->offset_width());
+  EXPECT_EQ(15.f, grid->offset_height());
+}
+
+}  // namespace starlight
\ No newline at end of file
@@ -0,0 +1,147 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "base/thread_pool.h"
+#include "layout/layout_batch.h"
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+
+namespace starlight {
+
+namespace {
+
+LayoutNode* AddNode(LayoutTree& tree,
+                    LayoutNode* parent,
+                    const std::string& styles,
+                    std::vector<LayoutNode*>& nodes) {
+  LayoutNode* node = tree.CreateNode();
+  node->SetStyles(styles);
+  if (parent) {
+    parent->InsertChild(node);
+  }
+  nodes.push_back(node);
+  return node;
+}
+
+// a cell with from none to dozens of wrapping items, depending on `index`
+LayoutNode* BuildRoot(LayoutTree& tree,
+                      int index,
+                      std::vector<LayoutNode*>& nodes) {
+  LayoutNode* root = AddNode(
+      tree, nullptr,
+      "flex-direction: row; flex-wrap: wrap; padding: 2.5px; "
+      "align-items: center",
+      nodes);
+  int items = index % 5 * index % 37;
+  for (int i = 0; i < items; ++i) {
+    LayoutNode* item = AddNode(
+        tree, root,
+        "flex-basis: " + std::to_string(15 + (index + i * 11) % 60) +
+            ".3px; height: " + std::to_string(8 + i % 4 * 5) +
+            ".6px; flex-grow: " + std::to_string(i % 3) + "; margin: 1.2px",
+        nodes);
+    if (i % 4 == 0) {
+      AddNode(tree, item, "height: 6.5px; width: 4.75px", nodes);
+    }
+  }
+  return root;
+}
+
+// a width for each root, the height is either given or follows the content
+LayoutConstraints ConstraintsAt(int index) {
+  if (index % 3 == 0) {
+    return LayoutConstraints(200.f + index % 7 * 31.5f, 300.f,
+                             kLayoutModeExact, kLayoutModeExact);
+  }
+  return LayoutConstraints(120.f + index % 11 * 17.25f, .0f, kLayoutModeExact,
+                           kLayoutModeUndefined);
+}
+
+// roots built the same way, laid out either as a batch or alone
+struct Roots {
+  explicit Roots(int count) : tree_(&layout_context_) {
+    for (int i = 0; i < count; ++i) {
+      requests_.emplace_back(BuildRoot(tree_, i, nodes_), ConstraintsAt(i));
+    }
+  }
+
+  LayoutContext layout_context_;
+  LayoutTree tree_;
+  std::vector<LayoutRequest> requests_;
+  // nodes of all roots in the order they were created
+  std::vector<LayoutNode*> nodes_;
+};
+
+void ExpectSameBoxes(const Roots& roots, const Roots& expected) {
+  ASSERT_EQ(expected.nodes_.size(), roots.nodes_.size());
+  for (size_t i = 0; i < roots.nodes_.size(); ++i) {
+    SCOPED_TRACE(i);
+    const LayoutNode* node = roots.nodes_[i];
+    const LayoutNode* expected_node = expected.nodes_[i];
+    EXPECT_EQ(expected_node->offset_left(), node->offset_left());
+    EXPECT_EQ(expected_node->offset_top(), node->offset_top());
+    EXPECT_EQ(expected_node->offset_width(), node->offset_width());
+    EXPECT_EQ(expected_node->offset_height(), node->offset_height());
+  }
+}
+
+void LayOutAlone(Roots& roots) {
+  for (const LayoutRequest& request : roots.requests_) {
+    request.root_->ReLayout(request.constraints_);
+  }
+}
+
+}  // namespace
+
+// every root gets the boxes ReLayout gives it alone, with or without a pool,
+// for batches of one root per chunk and of several, and again after changes
+TEST(LayoutBatchTest, SameAsReLayout) {
+  base::ThreadPool thread_pool(3);
+  base::ThreadPool* pools[] = {nullptr, &thread_pool};
+  const int counts[] = {1, 7, 50, 301};
+  for (base::ThreadPool* pool : pools) {
+    for (int count : counts) {
+      SCOPED_TRACE(std::to_string(count) + (pool ? " roots on a pool"
+                                                 : " roots without a pool"));
+      Roots alone(count);
+      Roots batched(count);
+      LayOutAlone(alone);
+      LayoutBatch(batched.requests_.data(), batched.requests_.size(), pool);
+      ExpectSameBoxes(batched, alone);
+
+      for (Roots* roots : {&alone, &batched}) {
+        for (size_t i = 0; i < roots->nodes_.size(); i += 13) {
+          roots->nodes_[i]->SetStyle("margin", "3.1px");
+        }
+        for (LayoutRequest& request : roots->requests_) {
+          request.constraints_.width_ += 9.5f;
+        }
+      }
+      LayOutAlone(alone);
+      LayoutBatch(batched.requests_.data(), batched.requests_.size(), pool);
+      ExpectSameBoxes(batched, alone);
+    }
+  }
+}
+
+// an empty batch lays nothing out
+TEST(LayoutBatchTest, Empty) {
+  base::ThreadPool thread_pool(3);
+  base::ThreadPool* pools[] = {nullptr, &thread_pool};
+  for (base::ThreadPool* pool : pools) {
+    LayoutBatch(nullptr, 0, pool);
+    Roots roots(3);
+    LayoutBatch(roots.requests_.data(), 0, pool);
+    for (const LayoutNode* node : roots.nodes_) {
+      EXPECT_EQ(.0f, node->offset_width());
+      EXPECT_EQ(.0f, node->offset_height());
+    }
+  }
+}
+
+}  // namespace starlight
\ No newline at end of file
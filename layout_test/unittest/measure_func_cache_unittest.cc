@@ -0,0 +1,168 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include "gtest/gtest.h"
+
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+#include "layout/measure_func_cache.h"
+
+namespace starlight {
+
+namespace {
+
+// the content a context stands for, and how often it was measured
+struct Label {
+  explicit Label(float width) : width_(width), calls_(0) {}
+  float width_;
+  int calls_;
+};
+
+FloatSize MeasureLabel(void* context,
+                       float width,
+                       LayoutMode width_mode,
+                       float height,
+                       LayoutMode height_mode) {
+  Label* label = static_cast<Label*>(context);
+  ++label->calls_;
+  return FloatSize(label->width_, 10.f);
+}
+
+// the same content, measured twice as high
+FloatSize MeasureLargeLabel(void* context,
+                            float width,
+                            LayoutMode width_mode,
+                            float height,
+                            LayoutMode height_mode) {
+  Label* label = static_cast<Label*>(context);
+  ++label->calls_;
+  return FloatSize(label->width_, 20.f);
+}
+
+LayoutConstraints WidthConstraints(float width) {
+  return LayoutConstraints(width, .0f, kLayoutModeAtMost,
+                           kLayoutModeUndefined);
+}
+
+}  // namespace
+
+TEST(MeasureFuncCacheTest, Hits) {
+  MeasureFuncCache cache;
+  Label label(30);
+  Label other_label(30);
+  EXPECT_EQ(30, cache.Measure(MeasureLabel, &label, WidthConstraints(100))
+                    .width_);
+  cache.Measure(MeasureLabel, &label, WidthConstraints(100));
+  EXPECT_EQ(1, label.calls_);
+
+  // any part of the key differing misses
+  cache.Measure(MeasureLabel, &label, WidthConstraints(90));
+  cache.Measure(MeasureLabel, &label,
+                LayoutConstraints(100, .0f, kLayoutModeExact,
+                                  kLayoutModeUndefined));
+  EXPECT_EQ(20, cache.Measure(MeasureLargeLabel, &label, WidthConstraints(100))
+                    .height_);
+  cache.Measure(MeasureLabel, &other_label, WidthConstraints(100));
+  EXPECT_EQ(4, label.calls_);
+  EXPECT_EQ(1, other_label.calls_);
+  EXPECT_EQ(5u, cache.size());
+}
+
+TEST(MeasureFuncCacheTest, EvictLeastRecentlyUsed) {
+  MeasureFuncCache cache;
+  cache.SetCapacity(2);
+  Label first(10);
+  Label second(20);
+  Label third(30);
+  cache.Measure(MeasureLabel, &first, WidthConstraints(100));
+  cache.Measure(MeasureLabel, &second, WidthConstraints(100));
+  // a hit makes the entry the most recently used
+  cache.Measure(MeasureLabel, &first, WidthConstraints(100));
+  cache.Measure(MeasureLabel, &third, WidthConstraints(100));
+  EXPECT_EQ(2u, cache.size());
+
+  cache.Measure(MeasureLabel, &first, WidthConstraints(100));
+  cache.Measure(MeasureLabel, &third, WidthConstraints(100));
+  EXPECT_EQ(1, first.calls_);
+  EXPECT_EQ(1, third.calls_);
+  cache.Measure(MeasureLabel, &second, WidthConstraints(100));
+  EXPECT_EQ(2, second.calls_);
+  EXPECT_EQ(2u, cache.size());
+}
+
+TEST(MeasureFuncCacheTest, Erase) {
+  MeasureFuncCache cache;
+  Label label(10);
+  Label other_label(20);
+  cache.Measure(MeasureLabel, &label, WidthConstraints(100));
+  cache.Measure(MeasureLargeLabel, &label, WidthConstraints(100));
+  cache.Measure(MeasureLabel, &label, WidthConstraints(50));
+  cache.Measure(MeasureLabel, &other_label, WidthConstraints(100));
+
+  // entries of all funcs go
+  cache.Erase(&label);
+  EXPECT_EQ(1u, cache.size());
+  cache.Measure(MeasureLabel, &label, WidthConstraints(100));
+  cache.Measure(MeasureLabel, &other_label, WidthConstraints(100));
+  EXPECT_EQ(4, label.calls_);
+  EXPECT_EQ(1, other_label.calls_);
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.size());
+}
+
+TEST(MeasureFuncCacheTest, SetCapacity) {
+  MeasureFuncCache cache;
+  size_t default_capacity = MeasureFuncCache::kDefaultCapacity;
+  EXPECT_EQ(default_capacity, cache.capacity());
+  Label label(10);
+  for (int width = 1; width <= 3; ++width) {
+    cache.Measure(MeasureLabel, &label, WidthConstraints(width));
+  }
+  // the most recently used entries stay
+  cache.SetCapacity(1);
+  EXPECT_EQ(1u, cache.size());
+  cache.Measure(MeasureLabel, &label, WidthConstraints(3));
+  EXPECT_EQ(3, label.calls_);
+
+  cache.SetCapacity(0);
+  EXPECT_EQ(0u, cache.size());
+  cache.Measure(MeasureLabel, &label, WidthConstraints(3));
+  cache.Measure(MeasureLabel, &label, WidthConstraints(3));
+  EXPECT_EQ(5, label.calls_);
+  EXPECT_EQ(0u, cache.size());
+}
+
+// leaves of a tree showing the same content are measured once, marking one
+// of them changed measures the content again
+TEST(MeasureFuncCacheTest, LeavesShareContent) {
+  LayoutContext layout_context;
+  LayoutTree tree(&layout_context);
+  Label label(30);
+  LayoutNode* root = tree.CreateNode();
+  root->SetStyles("flex-direction: column; align-items: flex-start");
+  LayoutNode* leaves[2];
+  for (LayoutNode*& leaf : leaves) {
+    leaf = tree.CreateNode();
+    leaf->SetMeasureFunc(MeasureLabel);
+    leaf->SetContext(&label);
+  }
+  root->InsertChild(leaves[0]);
+  root->ReLayout(0, 0, 200, 200);
+  int calls = label.calls_;
+  EXPECT_LT(0, calls);
+
+  root->InsertChild(leaves[1]);
+  root->ReLayout(0, 0, 200, 200);
+  EXPECT_EQ(calls, label.calls_);
+  EXPECT_EQ(30, leaves[1]->offset_width());
+
+  label.width_ = 45;
+  leaves[0]->MarkMeasureDirty();
+  root->ReLayout(0, 0, 200, 200);
+  EXPECT_EQ(2 * calls, label.calls_);
+  EXPECT_EQ(45, leaves[0]->offset_width());
+  EXPECT_EQ(10, leaves[1]->offset_top());
+}
+
+}  // namespace starlight
\ No newline at end of file
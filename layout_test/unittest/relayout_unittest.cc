@@ -0,0 +1,608 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+
+namespace starlight {
+
+namespace {
+
+typedef std::function<LayoutNode*(LayoutTree&)> BuildFunc;
+typedef std::function<void(LayoutNode*)> MutateFunc;
+
+// a node with `styles`, appended to `parent` if there is one
+LayoutNode* AddNode(LayoutTree& tree, LayoutNode* parent, const char* styles) {
+  LayoutNode* node = tree.CreateNode();
+  node->SetStyles(styles);
+  if (parent) {
+    parent->InsertChild(node);
+  }
+  return node;
+}
+
+// a node with `styles` inserted into `parent` before its child at `index`, or
+// appended past the last one
+LayoutNode* InsertNode(LayoutNode* parent, int index, const char* styles) {
+  LayoutNode* node = parent->tree()->CreateNode();
+  node->SetStyles(styles);
+  parent->InsertChild(node, index);
+  return node;
+}
+
+// descendant of `root` reached by child indices
+LayoutNode* NodeAt(LayoutNode* root, std::initializer_list<int> path) {
+  LayoutNode* node = root;
+  for (int index : path) {
+    node = node->FindNode(index);
+  }
+  return node;
+}
+
+void ExpectSameBoxes(const LayoutNode* node,
+                     const LayoutNode* expected,
+                     const std::string& path) {
+  EXPECT_EQ(expected->offset_left(), node->offset_left()) << path;
+  EXPECT_EQ(expected->offset_top(), node->offset_top()) << path;
+  EXPECT_EQ(expected->offset_width(), node->offset_width()) << path;
+  EXPECT_EQ(expected->offset_height(), node->offset_height()) << path;
+  ASSERT_EQ(expected->child_count(), node->child_count()) << path;
+  int index = 0;
+  for (const LayoutNode *child = node->first_child(),
+                        *expected_child = expected->first_child();
+       child != nullptr;
+       child = child->next(), expected_child = expected_child->next()) {
+    ExpectSameBoxes(child, expected_child,
+                    path + "/" + std::to_string(index++));
+  }
+}
+
+int measure_calls = 0;
+
+FloatSize MeasureLabel(void* context,
+                       float width,
+                       LayoutMode width_mode,
+                       float height,
+                       LayoutMode height_mode) {
+  ++measure_calls;
+  return FloatSize(60.f, 18.f);
+}
+
+}  // namespace
+
+/**
+ * a tree is laid out, changed and laid out again. its boxes have to match
+ * those of a tree built with the same changes and laid out once, whichever
+ * parts of the last pass the incremental layout kept.
+ */
+class RelayoutTest : public testing::Test {
+ public:
+  RelayoutTest()
+      : tree_(&layout_context_),
+        root_(nullptr),
+        constraints_(400, 600, kLayoutModeExact, kLayoutModeExact) {}
+
+ protected:
+  // builds the tree and lays it out for the first time
+  void Build(BuildFunc build) {
+    build_ = build;
+    root_ = build(tree_);
+    root_->ReLayout(constraints_);
+  }
+
+  void Mutate(MutateFunc mutate) {
+    mutate(root_);
+    mutations_.push_back(mutate);
+  }
+
+  void ExpectSameAsFresh() {
+    LayoutTree fresh_tree(&layout_context_);
+    LayoutNode* fresh_root = build_(fresh_tree);
+    for (const MutateFunc& mutate : mutations_) {
+      mutate(fresh_root);
+    }
+    fresh_root->ReLayout(constraints_);
+    ExpectSameBoxes(root_, fresh_root, "root");
+  }
+
+  // applies `mutate`, if any, and lays the tree out again
+  void Relayout(MutateFunc mutate = nullptr) {
+    if (mutate) {
+      Mutate(mutate);
+    }
+    root_->ReLayout(constraints_);
+    ExpectSameAsFresh();
+  }
+
+  LayoutContext layout_context_;
+  LayoutTree tree_;
+  LayoutNode* root_;
+  LayoutConstraints constraints_;
+  BuildFunc build_;
+  std::vector<MutateFunc> mutations_;
+};
+
+// rows of growing leaves and a nested column in a padded column
+LayoutNode* BuildFeed(LayoutTree& tree) {
+  LayoutNode* feed =
+      AddNode(tree, nullptr, "flex-direction: column; padding: 10px");
+  for (int i = 0; i < 3; ++i) {
+    LayoutNode* row = AddNode(
+        tree, feed, "flex-direction: row; align-items: center; margin: 4px");
+    for (int j = 0; j < 3; ++j) {
+      AddNode(tree, row, "width: 40px; height: 30px; flex-grow: 1");
+    }
+    LayoutNode* column = AddNode(tree, row, "flex-direction: column");
+    AddNode(tree, column, "width: 20px; height: 12px");
+    AddNode(tree, column, "height: 12px");
+  }
+  return feed;
+}
+
+TEST_F(RelayoutTest, LeafStyleChange) {
+  Build(BuildFeed);
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {1, 1})->SetStyle("width", "100px");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {1, 1})->SetStyle("height", "50px");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {2, 3, 0})->SetStyle("margin-left", "8px");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {0, 0})->SetStyle("padding", "6px");
+  });
+}
+
+// nothing but the changed row is measured again
+TEST_F(RelayoutTest, CleanSubtreesAreNotMeasured) {
+  tree_.measure_func_cache().SetCapacity(0);
+  measure_calls = 0;
+  Build([](LayoutTree& tree) {
+    LayoutNode* feed = BuildFeed(tree);
+    for (int i = 1; i < 3; ++i) {
+      AddNode(tree, NodeAt(feed, {i}), "flex-shrink: 0")
+          ->SetMeasureFunc(MeasureLabel);
+    }
+    return feed;
+  });
+  EXPECT_LT(0, measure_calls);
+  Mutate([](LayoutNode* root) {
+    NodeAt(root, {0, 1})->SetStyle("width", "80px");
+  });
+  measure_calls = 0;
+  root_->ReLayout(constraints_);
+  EXPECT_EQ(0, measure_calls);
+  ExpectSameAsFresh();
+}
+
+// constraints seen before are answered from the measure caches, the subtrees
+// are laid out for them again before alignment
+TEST_F(RelayoutTest, PreviousConstraints) {
+  Build([](LayoutTree& tree) {
+    LayoutNode* root = BuildFeed(tree);
+    NodeAt(root, {1})->SetStyle("flex-wrap", "wrap");
+    return root;
+  });
+  const float widths[] = {300, 400, 300, 180, 400};
+  for (float width : widths) {
+    constraints_.width_ = width;
+    Relayout();
+  }
+}
+
+// a change inside an absolutely positioned subtree only lays that subtree out
+// again, with its parent's alignment
+TEST_F(RelayoutTest, ChangeInsideAbsoluteChild) {
+  Build([](LayoutTree& tree) {
+    LayoutNode* root = BuildFeed(tree);
+    LayoutNode* overlay = AddNode(
+        tree, NodeAt(root, {1}),
+        "position: absolute; right: 10px; bottom: 5px; flex-direction: row");
+    AddNode(tree, overlay, "width: 20px; height: 20px");
+    AddNode(tree, overlay, "width: 30px; height: 10px");
+    return root;
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {1, 4, 1})->SetStyle("height", "40px");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {1, 4, 0})->SetStyle("width", "5px");
+  });
+}
+
+// a wrapping container of items of varied sizes, some of them growing
+LayoutNode* BuildWrap(LayoutTree& tree, const char* direction) {
+  LayoutNode* container = AddNode(
+      tree, nullptr,
+      "flex-wrap: wrap; align-content: space-between; align-items: center");
+  container->SetStyle("flex-direction", direction);
+  for (int i = 0; i < 12; ++i) {
+    std::string styles = "width: " + std::to_string(40 + i * 13 % 50) +
+                         "px; height: " + std::to_string(60 + i * 37 % 90) +
+                         "px; margin: 3px";
+    if (i % 4 == 0) {
+      styles += "; flex-grow: 1";
+    }
+    AddNode(tree, container, styles.c_str());
+  }
+  return container;
+}
+
+LayoutNode* BuildWrapRow(LayoutTree& tree) {
+  return BuildWrap(tree, "row");
+}
+
+LayoutNode* BuildWrapColumn(LayoutTree& tree) {
+  return BuildWrap(tree, "column");
+}
+
+TEST_F(RelayoutTest, InsertIntoWrapRow) {
+  Build(BuildWrapRow);
+  Relayout([](LayoutNode* root) {
+    InsertNode(root, 0, "width: 70px; height: 30px");
+  });
+  Relayout([](LayoutNode* root) {
+    InsertNode(root, 6, "width: 300px; height: 40px");
+  });
+  Relayout([](LayoutNode* root) {
+    InsertNode(root, -1, "width: 10px; height: 10px; flex-grow: 2");
+  });
+}
+
+TEST_F(RelayoutTest, RemoveFromWrapRow) {
+  Build(BuildWrapRow);
+  Relayout([](LayoutNode* root) { root->RemoveChild(0); });
+  Relayout([](LayoutNode* root) { root->RemoveChild(5); });
+  Relayout([](LayoutNode* root) {
+    root->RemoveChild(static_cast<int>(root->child_count()) - 1);
+  });
+}
+
+TEST_F(RelayoutTest, InsertIntoAndRemoveFromWrapColumn) {
+  Build(BuildWrapColumn);
+  Relayout([](LayoutNode* root) {
+    InsertNode(root, 3, "width: 50px; height: 250px");
+  });
+  Relayout([](LayoutNode* root) { root->RemoveChild(1); });
+  Relayout([](LayoutNode* root) {
+    InsertNode(root, 9, "width: 20px; height: 20px");
+    root->RemoveChild(10);
+    root->RemoveChild(0);
+  });
+}
+
+TEST_F(RelayoutTest, MoveChild) {
+  Build(BuildWrapRow);
+  Relayout([](LayoutNode* root) { root->InsertChild(root->FindNode(8), 1); });
+  Relayout([](LayoutNode* root) { root->InsertChild(root->FindNode(0), -1); });
+}
+
+TEST_F(RelayoutTest, InsertAndRemoveOrderedChildren) {
+  Build([](LayoutTree& tree) {
+    LayoutNode* root = BuildWrapRow(tree);
+    NodeAt(root, {2})->SetStyle("order", "2");
+    NodeAt(root, {7})->SetStyle("order", "-1");
+    return root;
+  });
+  Relayout([](LayoutNode* root) {
+    InsertNode(root, -1, "width: 60px; height: 20px; order: -2");
+  });
+  Relayout([](LayoutNode* root) {
+    InsertNode(root, 4, "width: 60px; height: 20px; order: 1");
+  });
+  Relayout([](LayoutNode* root) { root->RemoveChild(2); });
+}
+
+TEST_F(RelayoutTest, InsertAndRemoveOutOfFlowChildren) {
+  Build(BuildWrapRow);
+  Relayout([](LayoutNode* root) {
+    InsertNode(root, 2,
+               "position: absolute; width: 30px; height: 30px; right: 4px");
+  });
+  Relayout([](LayoutNode* root) {
+    InsertNode(root, 5, "display: none; width: 300px; height: 30px");
+  });
+  Relayout([](LayoutNode* root) { root->RemoveChild(5); });
+  Relayout([](LayoutNode* root) { root->RemoveChild(2); });
+}
+
+TEST_F(RelayoutTest, AlignmentChanges) {
+  Build(BuildFeed);
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {0})->SetStyle("justify-content", "space-around");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {1})->SetStyle("align-items", "flex-end");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {1, 3})->SetStyle("align-self", "stretch");
+  });
+  Relayout([](LayoutNode* root) {
+    root->SetStyles("justify-content: flex-end; align-items: center");
+  });
+}
+
+TEST_F(RelayoutTest, SelfSizeChanges) {
+  Build(BuildFeed);
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {0, 2})->SetStyle("margin", "5px 9px");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {1, 0})->SetStyle("flex-grow", "3");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {1, 1})->SetStyle("flex-basis", "120px");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {2, 3})->SetStyle("min-width", "90px");
+  });
+}
+
+TEST_F(RelayoutTest, ChildrenSizeChanges) {
+  Build(BuildFeed);
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {0})->SetStyle("padding", "7px 3px");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {1})->SetStyle("flex-direction", "column-reverse");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {2})->SetStyles("flex-wrap: wrap; width: 120px");
+  });
+}
+
+TEST_F(RelayoutTest, DisplayPositionAndOrderChanges) {
+  Build(BuildFeed);
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {0, 1})->SetStyle("display", "none");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {1, 2})->SetStyles("position: absolute; left: 10px");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {2, 0})->SetStyle("order", "1");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {0, 1})->SetStyle("display", "flex");
+    NodeAt(root, {1, 2})->SetStyle("position", "relative");
+  });
+}
+
+// auto margins take their share of the free space in every alignment, one
+// running alone starts from the margins of the style
+TEST_F(RelayoutTest, AlignmentWithAutoMargins) {
+  Build([](LayoutTree& tree) {
+    LayoutNode* root = AddNode(tree, nullptr, "flex-direction: column");
+    LayoutNode* row = AddNode(tree, root, "flex-direction: row; height: 80px");
+    AddNode(tree, row, "width: 50px; height: 20px; margin-left: auto");
+    AddNode(tree, row,
+            "width: 50px; height: 20px; margin-left: 40px; margin-right: auto");
+    AddNode(tree, row, "width: 50px; height: 20px; margin: auto 8px");
+    LayoutNode* column =
+        AddNode(tree, root, "flex-direction: column; height: 200px");
+    AddNode(tree, column, "height: 30px; margin-bottom: auto");
+    AddNode(tree, column, "height: 30px; margin: auto 5px 4px");
+    return root;
+  });
+  EXPECT_EQ(97, NodeAt(root_, {0, 0})->offset_left());
+  EXPECT_EQ(187, NodeAt(root_, {0, 1})->offset_left());
+  EXPECT_EQ(342, NodeAt(root_, {0, 2})->offset_left());
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {0})->SetStyle("justify-content", "center");
+  });
+  Relayout([](LayoutNode* root) { root->SetStyle("left", "12px"); });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {0})->SetStyle("align-items", "flex-end");
+    NodeAt(root, {1})->SetStyle("justify-content", "space-between");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {1, 1})->SetStyle("align-self", "center");
+  });
+}
+
+// insets only move an absolutely positioned child, its size and its subtree
+// are kept
+TEST_F(RelayoutTest, AbsoluteChildChanges) {
+  Build([](LayoutTree& tree) {
+    LayoutNode* root = BuildFeed(tree);
+    LayoutNode* overlay =
+        AddNode(tree, NodeAt(root, {0}),
+                "position: absolute; left: 10px; top: 5px; flex-direction: "
+                "column; align-items: center");
+    AddNode(tree, overlay, "width: 20px; height: 20px");
+    AddNode(tree, overlay, "width: 36px; height: 10px");
+    return root;
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {0, 4})->SetStyle("left", "25px");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {0, 4})->SetStyles("top: auto; bottom: 3px");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {0, 4})->SetStyle("align-items", "flex-end");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {0, 4})->SetStyle("width", "90px");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {0, 4})->SetStyle("right", "2px");
+  });
+}
+
+// lines before the first changed item are kept, lines after the changes are
+// kept once a line starts at the same item again
+TEST_F(RelayoutTest, ItemChangesInLines) {
+  Build(BuildWrapRow);
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {9})->SetStyle("width", "150px");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {1})->SetStyle("width", "20px");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {5})->SetStyle("margin-right", "40px");
+  });
+  Relayout([](LayoutNode* root) {
+    // cross size only, no line is broken differently
+    NodeAt(root, {6})->SetStyle("height", "130px");
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {3})->SetStyle("flex-basis", "380px");
+    NodeAt(root, {10})->SetStyle("min-width", "200px");
+  });
+}
+
+TEST_F(RelayoutTest, ItemChangesInReversedLines) {
+  Build([](LayoutTree& tree) {
+    LayoutNode* root = BuildWrapColumn(tree);
+    root->SetStyles("flex-wrap: wrap-reverse; align-content: center");
+    return root;
+  });
+  Relayout([](LayoutNode* root) {
+    NodeAt(root, {2})->SetStyle("height", "200px");
+  });
+  Relayout([](LayoutNode* root) {
+    InsertNode(root, 6, "width: 45px; height: 100px");
+    root->RemoveChild(9);
+  });
+  Relayout([](LayoutNode* root) {
+    root->SetStyle("flex-direction", "row-reverse");
+  });
+}
+
+TEST_F(RelayoutTest, LinesAtOtherSizes) {
+  Build(BuildWrapRow);
+  const float widths[] = {250, 400, 610, 400};
+  for (float width : widths) {
+    constraints_.width_ = width;
+    Relayout();
+  }
+  Relayout([](LayoutNode* root) { root->SetStyle("flex-wrap", "nowrap"); });
+  Relayout([](LayoutNode* root) { root->SetStyle("flex-wrap", "wrap"); });
+}
+
+// removing the last item drops its line, the container shrinks to nothing
+TEST_F(RelayoutTest, RemoveLastItem) {
+  constraints_.height_mode_ = kLayoutModeUndefined;
+  Build([](LayoutTree& tree) {
+    LayoutNode* root = AddNode(tree, nullptr, "flex-direction: column");
+    LayoutNode* row = AddNode(tree, root, "flex-direction: row");
+    AddNode(tree, row, "width: 30px; height: 10px");
+    AddNode(tree, root, "height: 10px");
+    return root;
+  });
+  EXPECT_EQ(20, root_->offset_height());
+  Relayout([](LayoutNode* root) { NodeAt(root, {0})->RemoveChild(0); });
+  EXPECT_EQ(0, NodeAt(root_, {0})->offset_height());
+  Relayout([](LayoutNode* root) { root->RemoveChild(1); });
+  Relayout([](LayoutNode* root) { root->RemoveChild(0); });
+  EXPECT_EQ(0, root_->offset_height());
+  Relayout([](LayoutNode* root) {
+    AddNode(*root->tree(), root, "height: 15px");
+  });
+}
+
+// a column sized by its content, as a feed which items are appended to
+LayoutNode* BuildList(LayoutTree& tree) {
+  LayoutNode* list = AddNode(tree, nullptr, "flex-direction: column");
+  for (int i = 0; i < 4; ++i) {
+    AddNode(tree, list, "height: 30px; margin: 2px 6px");
+  }
+  return list;
+}
+
+// a card of a row and a line of text, appended to lists
+void AppendCard(LayoutNode* list) {
+  LayoutTree& tree = *list->tree();
+  LayoutNode* card =
+      AddNode(tree, list, "flex-direction: column; padding: 8px");
+  LayoutNode* header =
+      AddNode(tree, card, "flex-direction: row; align-items: center");
+  AddNode(tree, header, "width: 24px; height: 24px");
+  AddNode(tree, header, "flex-grow: 1; height: 16px; margin-left: 6px");
+  AddNode(tree, card, "width: 180px; height: 14px; margin-top: 4px");
+}
+
+// appended items are measured alone while the items before keep their place
+TEST_F(RelayoutTest, AppendToColumn) {
+  constraints_.height_mode_ = kLayoutModeUndefined;
+  Build(BuildList);
+  for (int i = 0; i < 3; ++i) {
+    Relayout([](LayoutNode* root) {
+      AddNode(*root->tree(), root, "height: 40px; margin: 5px 4px 3px");
+    });
+  }
+  Relayout([](LayoutNode* root) {
+    AddNode(*root->tree(), root, "width: 100px; height: 10px");
+    AddNode(*root->tree(), root, "height: 12px; max-width: 50%");
+  });
+  Relayout(AppendCard);
+  Relayout(AppendCard);
+}
+
+TEST_F(RelayoutTest, AppendToAlignedColumn) {
+  constraints_.height_mode_ = kLayoutModeUndefined;
+  Build([](LayoutTree& tree) {
+    LayoutNode* root = BuildList(tree);
+    root->SetStyle("align-items", "center");
+    NodeAt(root, {1})->SetStyle("width", "120px");
+    return root;
+  });
+  Relayout([](LayoutNode* root) {
+    AddNode(*root->tree(), root, "width: 60px; height: 40px");
+  });
+  Relayout(AppendCard);
+  // the items before move, they are laid out again
+  Relayout([](LayoutNode* root) {
+    root->SetStyle("justify-content", "center");
+    root->SetStyle("min-height", "900px");
+  });
+  Relayout([](LayoutNode* root) {
+    AddNode(*root->tree(), root, "width: 60px; height: 40px");
+  });
+}
+
+// appended items which change the items before, or change how the lines
+// are broken, lay the column out in full
+TEST_F(RelayoutTest, AppendOtherItems) {
+  constraints_.height_mode_ = kLayoutModeUndefined;
+  Build(BuildList);
+  Relayout([](LayoutNode* root) {
+    AddNode(*root->tree(), root, "height: 20px; margin-top: auto");
+  });
+  Relayout([](LayoutNode* root) {
+    AddNode(*root->tree(), root, "height: 20px; flex-grow: 1");
+  });
+  Relayout([](LayoutNode* root) {
+    AddNode(*root->tree(), root, "position: absolute; bottom: 0; height: 8px");
+  });
+  Relayout([](LayoutNode* root) {
+    AddNode(*root->tree(), root, "display: none; height: 20px");
+    AddNode(*root->tree(), root, "height: 20px");
+  });
+}
+
+TEST_F(RelayoutTest, AppendAfterRemoval) {
+  constraints_.height_mode_ = kLayoutModeUndefined;
+  Build(BuildList);
+  Relayout([](LayoutNode* root) {
+    root->RemoveChild(1);
+    AddNode(*root->tree(), root, "height: 50px");
+  });
+  Relayout([](LayoutNode* root) {
+    root->RemoveChild(static_cast<int>(root->child_count()) - 1);
+  });
+  Relayout(AppendCard);
+}
+
+}  // namespace starlight
\ No newline at end of file
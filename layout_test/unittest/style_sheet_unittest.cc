@@ -0,0 +1,266 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+#include "layout/style.h"
+#include "layout/style_sheet.h"
+
+namespace starlight {
+
+namespace {
+
+enum Rule {
+  kRuleCard,
+  kRuleHeader,
+  kRuleIcon,
+  kRuleTitle,
+  kRuleGrid,
+  kRuleCell,
+  kRuleBadge,
+};
+
+std::vector<StyleRule> CardRules() {
+  return {
+      {"card",
+       "flex-direction: column; padding: 8px; margin: 4px 2px; "
+       "align-items: center"},
+      {"header",
+       "flex-direction: row; justify-content: space-between; width: 80%"},
+      {"icon", "width: 24px; height: 24px; flex-shrink: 0; margin-right: auto"},
+      {"title",
+       "flex-grow: 1; height: 16px; min-width: 40px; max-width: 120px"},
+      {"grid",
+       "display: grid; grid-template-columns: 40px 1fr repeat(2, 30px); "
+       "grid-template-rows: 20px auto; padding: 2px; border: 1px"},
+      {"cell", "grid-column: 2 / span 2; grid-row: 2; height: 30px"},
+      {"badge",
+       "position: absolute; top: 2px; right: 2px; width: 10px; height: 10px; "
+       "order: -1"},
+  };
+}
+
+typedef std::function<void(LayoutNode*, Rule)> ApplyFunc;
+
+// a card of all rules laid out, its nodes in the order they were created
+std::vector<LayoutNode*> LayOutCard(LayoutTree& tree, const ApplyFunc& apply) {
+  std::vector<LayoutNode*> nodes;
+  auto add_node = [&tree, &apply, &nodes](LayoutNode* parent, Rule rule) {
+    LayoutNode* node = tree.CreateNode();
+    apply(node, rule);
+    if (parent) {
+      parent->InsertChild(node);
+    }
+    nodes.push_back(node);
+    return node;
+  };
+  LayoutNode* card = add_node(nullptr, kRuleCard);
+  LayoutNode* header = add_node(card, kRuleHeader);
+  add_node(header, kRuleIcon);
+  add_node(header, kRuleTitle);
+  add_node(header, kRuleBadge);
+  LayoutNode* grid = add_node(card, kRuleGrid);
+  add_node(grid, kRuleCell);
+  add_node(grid, kRuleIcon);
+  add_node(grid, kRuleTitle);
+  card->ReLayout(0, 0, 300, 400);
+  return nodes;
+}
+
+// `blob` with the bytes of `value` written at `offset`
+template <typename T>
+std::vector<uint8_t> Patched(std::vector<uint8_t> blob,
+                             size_t offset,
+                             T value) {
+  std::memcpy(blob.data() + offset, &value, sizeof(value));
+  return blob;
+}
+
+bool IsAccepted(const std::vector<uint8_t>& blob) {
+  LayoutContext layout_context;
+  return StyleSheet::Create(&layout_context, blob.data(), blob.size()) !=
+         nullptr;
+}
+
+}  // namespace
+
+TEST(StyleSheetTest, FindRules) {
+  std::vector<uint8_t> blob = StyleSheet::Compile(CardRules());
+  LayoutContext layout_context;
+  std::unique_ptr<StyleSheet> style_sheet =
+      StyleSheet::Create(&layout_context, blob.data(), blob.size());
+  ASSERT_NE(nullptr, style_sheet);
+  EXPECT_EQ(7u, style_sheet->rule_count());
+  EXPECT_EQ(0u, style_sheet->FindRule("card"));
+  EXPECT_EQ(5u, style_sheet->FindRule("cell"));
+  EXPECT_EQ(6u, style_sheet->FindRule("badge"));
+  EXPECT_EQ(7u, style_sheet->FindRule("car"));
+  EXPECT_EQ(7u, style_sheet->FindRule(""));
+  EXPECT_EQ(nullptr, style_sheet->GetStyle(7));
+}
+
+TEST(StyleSheetTest, EmptyStyleSheet) {
+  std::vector<uint8_t> blob = StyleSheet::Compile({});
+  LayoutContext layout_context;
+  std::unique_ptr<StyleSheet> style_sheet =
+      StyleSheet::Create(&layout_context, blob.data(), blob.size());
+  ASSERT_NE(nullptr, style_sheet);
+  EXPECT_EQ(0u, style_sheet->rule_count());
+  EXPECT_EQ(0u, style_sheet->FindRule("card"));
+}
+
+TEST(StyleSheetTest, CompileRejectsBadNames) {
+  EXPECT_TRUE(StyleSheet::Compile({{"", "width: 1px"}}).empty());
+  EXPECT_TRUE(
+      StyleSheet::Compile({{std::string("a\0b", 3), "width: 1px"}}).empty());
+}
+
+// rules resolve to the styles SetStyles parses, shared with nodes styled so
+TEST(StyleSheetTest, SameLayoutAsSetStyles) {
+  std::vector<StyleRule> rules = CardRules();
+  std::vector<uint8_t> blob = StyleSheet::Compile(rules);
+  LayoutContext layout_context;
+  std::unique_ptr<StyleSheet> style_sheet =
+      StyleSheet::Create(&layout_context, blob.data(), blob.size());
+  ASSERT_NE(nullptr, style_sheet);
+
+  LayoutTree parsed_tree(&layout_context);
+  std::vector<LayoutNode*> parsed =
+      LayOutCard(parsed_tree, [&rules](LayoutNode* node, Rule rule) {
+        node->SetStyles(rules[rule].declarations_);
+      });
+  LayoutTree applied_tree(&layout_context);
+  std::vector<LayoutNode*> applied =
+      LayOutCard(applied_tree, [&style_sheet](LayoutNode* node, Rule rule) {
+        EXPECT_TRUE(node->ApplyStyleRule(*style_sheet, rule));
+      });
+
+  ASSERT_EQ(parsed.size(), applied.size());
+  for (size_t i = 0; i < parsed.size(); ++i) {
+    SCOPED_TRACE(i);
+    EXPECT_EQ(parsed[i]->css_style(), applied[i]->css_style());
+    EXPECT_EQ(parsed[i]->offset_left(), applied[i]->offset_left());
+    EXPECT_EQ(parsed[i]->offset_top(), applied[i]->offset_top());
+    EXPECT_EQ(parsed[i]->offset_width(), applied[i]->offset_width());
+    EXPECT_EQ(parsed[i]->offset_height(), applied[i]->offset_height());
+  }
+  // the node has the rule's style already
+  EXPECT_FALSE(applied[0]->ApplyStyleRule(*style_sheet, kRuleCard));
+  EXPECT_FALSE(applied[0]->ApplyStyleRule(*style_sheet, 7));
+}
+
+TEST(StyleSheetTest, MapFile) {
+  std::vector<uint8_t> blob = StyleSheet::Compile(CardRules());
+  std::string path = testing::TempDir() + "style_sheet_unittest.slss";
+  FILE* file = fopen(path.c_str(), "wb");
+  ASSERT_NE(nullptr, file);
+  fwrite(blob.data(), 1, blob.size(), file);
+  fclose(file);
+
+  LayoutContext layout_context;
+  std::unique_ptr<StyleSheet> style_sheet =
+      StyleSheet::MapFile(&layout_context, path.c_str());
+  ASSERT_NE(nullptr, style_sheet);
+  EXPECT_EQ(4u, style_sheet->FindRule("grid"));
+  EXPECT_NE(nullptr, style_sheet->GetStyle(kRuleGrid));
+  style_sheet.reset();
+  remove(path.c_str());
+  EXPECT_EQ(nullptr, StyleSheet::MapFile(&layout_context, path.c_str()));
+}
+
+TEST(StyleSheetTest, RejectMalformedBlobs) {
+  std::vector<uint8_t> blob = StyleSheet::Compile(CardRules());
+  ASSERT_TRUE(IsAccepted(blob));
+
+  EXPECT_FALSE(IsAccepted(std::vector<uint8_t>()));
+  EXPECT_FALSE(IsAccepted(
+      std::vector<uint8_t>(blob.begin(), blob.begin() + 4)));
+  EXPECT_FALSE(
+      IsAccepted(std::vector<uint8_t>(blob.begin(), blob.end() - 1)));
+  std::vector<uint8_t> longer = blob;
+  longer.push_back(0);
+  EXPECT_FALSE(IsAccepted(longer));
+
+  EXPECT_FALSE(IsAccepted(
+      Patched(blob, offsetof(StyleSheetHeader, magic_), uint32_t(0))));
+  EXPECT_FALSE(IsAccepted(
+      Patched(blob, offsetof(StyleSheetHeader, version_), uint32_t(2))));
+  EXPECT_FALSE(
+      IsAccepted(Patched(blob, offsetof(StyleSheetHeader, record_size_),
+                         uint32_t(sizeof(StyleRecord) - 4))));
+  EXPECT_FALSE(
+      IsAccepted(Patched(blob, offsetof(StyleSheetHeader, rule_count_),
+                         uint32_t(0xffffffff))));
+}
+
+// a record has to hold values the parser can produce
+TEST(StyleSheetTest, RejectOutOfRangeValues) {
+  std::vector<uint8_t> blob = StyleSheet::Compile(CardRules());
+  // the second record
+  size_t record = sizeof(StyleSheetHeader) + sizeof(StyleRecord);
+  EXPECT_TRUE(IsAccepted(
+      Patched(blob, record + offsetof(StyleRecord, display_), uint8_t(1))));
+  EXPECT_FALSE(IsAccepted(
+      Patched(blob, record + offsetof(StyleRecord, display_), uint8_t(9))));
+  EXPECT_FALSE(IsAccepted(Patched(
+      blob, record + offsetof(StyleRecord, align_self_), uint8_t(200))));
+  EXPECT_FALSE(IsAccepted(Patched(blob,
+                                  record + offsetof(StyleRecord, width_) +
+                                      offsetof(LengthRecord, type_),
+                                  uint32_t(17))));
+  EXPECT_FALSE(IsAccepted(Patched(blob,
+                                  record + offsetof(StyleRecord, margin_) +
+                                      offsetof(LengthRecord, type_),
+                                  uint32_t(0xffffffff))));
+
+  size_t columns = record + offsetof(StyleRecord, grid_template_columns_);
+  EXPECT_FALSE(IsAccepted(Patched(
+      blob, columns + offsetof(GridTrackListRecord, count_), uint32_t(25))));
+  EXPECT_FALSE(IsAccepted(Patched(
+      Patched(blob, columns + offsetof(GridTrackListRecord, count_),
+              uint32_t(1)),
+      columns + offsetof(GridTrackListRecord, tracks_) +
+          offsetof(GridTrackRecord, type_),
+      uint32_t(9))));
+
+  size_t row_start = record + offsetof(StyleRecord, grid_row_start_);
+  EXPECT_TRUE(IsAccepted(Patched(
+      blob, row_start + offsetof(GridLineRecord, value_), int32_t(3))));
+  EXPECT_FALSE(IsAccepted(Patched(
+      blob, row_start + offsetof(GridLineRecord, value_), int32_t(-3))));
+  EXPECT_FALSE(IsAccepted(Patched(
+      blob, row_start + offsetof(GridLineRecord, value_),
+      int32_t(GridLine::kMaxValue + 1))));
+  // a span of no tracks
+  EXPECT_FALSE(IsAccepted(Patched(
+      blob, row_start + offsetof(GridLineRecord, span_), uint32_t(1))));
+}
+
+TEST(StyleSheetTest, RejectBadNames) {
+  std::vector<uint8_t> blob = StyleSheet::Compile(CardRules());
+  // the last name is left unterminated
+  std::vector<uint8_t> unterminated = blob;
+  unterminated.back() = 'x';
+  EXPECT_FALSE(IsAccepted(unterminated));
+
+  size_t offsets = sizeof(StyleSheetHeader) + 7 * sizeof(StyleRecord);
+  uint32_t names_size = 0;
+  std::memcpy(&names_size,
+              blob.data() + offsetof(StyleSheetHeader, names_size_),
+              sizeof(names_size));
+  EXPECT_TRUE(IsAccepted(Patched(blob, offsets, names_size - 1)));
+  EXPECT_FALSE(IsAccepted(Patched(blob, offsets, names_size)));
+  EXPECT_FALSE(IsAccepted(Patched(blob, offsets + 6 * sizeof(uint32_t),
+                                  uint32_t(0x80000000))));
+}
+
+}  // namespace starlight
\ No newline at end of file
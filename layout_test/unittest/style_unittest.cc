@@ -0,0 +1,311 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+#include "layout/style.h"
+
+namespace starlight {
+
+namespace {
+
+// `count` fixed tracks of 1px separated by spaces
+std::string FixedTracks(size_t count) {
+  std::string tracks;
+  for (size_t i = 0; i < count; ++i) {
+    tracks += i == 0 ? "1px" : " 1px";
+  }
+  return tracks;
+}
+
+// a laid out container of in-flow and out-of-flow items, for changing one of
+// its nodes through different setters
+struct StyledTree {
+  StyledTree() : tree_(&layout_context_) {
+    LayoutNode* root = AddNode(nullptr, "flex-direction: column");
+    LayoutNode* container =
+        AddNode(root,
+                "flex-direction: row; flex-wrap: wrap; padding: 4px; "
+                "height: 90px");
+    LayoutNode* item = AddNode(container, "width: 50px; height: 20px");
+    AddNode(item, "width: 10px; height: 5px");
+    AddNode(container, "flex-grow: 1; margin: 2px; align-self: center");
+    AddNode(container, "position: absolute; width: 30px; height: 10px");
+    root->ReLayout(0, 0, 300, 400);
+  }
+
+  LayoutNode* AddNode(LayoutNode* parent, const char* styles) {
+    LayoutNode* node = tree_.CreateNode();
+    node->SetStyles(styles);
+    if (parent) {
+      parent->InsertChild(node);
+    }
+    nodes_.push_back(node);
+    return node;
+  }
+
+  LayoutContext layout_context_;
+  LayoutTree tree_;
+  // nodes in the order they were created, the root first
+  std::vector<LayoutNode*> nodes_;
+};
+
+// the same phases are scheduled and give the same boxes. a dirty node is
+// aligned again whether it needs alignment or not
+void ExpectSameLayout(StyledTree& tree, StyledTree& expected) {
+  for (size_t i = 0; i < tree.nodes_.size(); ++i) {
+    EXPECT_EQ(expected.nodes_[i]->dirty(), tree.nodes_[i]->dirty()) << i;
+    if (!expected.nodes_[i]->dirty()) {
+      EXPECT_EQ(expected.nodes_[i]->needs_alignment(),
+                tree.nodes_[i]->needs_alignment())
+          << i;
+    }
+  }
+  expected.nodes_[0]->ReLayout(0, 0, 300, 400);
+  tree.nodes_[0]->ReLayout(0, 0, 300, 400);
+  for (size_t i = 0; i < tree.nodes_.size(); ++i) {
+    const LayoutNode* node = tree.nodes_[i];
+    const LayoutNode* expected_node = expected.nodes_[i];
+    EXPECT_EQ(expected_node->offset_left(), node->offset_left()) << i;
+    EXPECT_EQ(expected_node->offset_top(), node->offset_top()) << i;
+    EXPECT_EQ(expected_node->offset_width(), node->offset_width()) << i;
+    EXPECT_EQ(expected_node->offset_height(), node->offset_height()) << i;
+  }
+}
+
+// `value` set through a typed setter changes styles and nodes the way its
+// string form does, on each node of a StyledTree
+template <typename Value>
+void ExpectTypedSameAsString(StyleProperty property,
+                             const Value& value,
+                             const char* name,
+                             const char* string_value) {
+  size_t count = StyledTree().nodes_.size();
+  for (size_t i = 0; i < count; ++i) {
+    SCOPED_TRACE(std::string(name) + ": " + string_value + " on node " +
+                 std::to_string(i));
+    StyledTree typed;
+    StyledTree parsed;
+    CSSStyle typed_style(*typed.nodes_[i]->css_style());
+    CSSStyle parsed_style(*parsed.nodes_[i]->css_style());
+    EXPECT_EQ(parsed_style.SetStyle(name, string_value),
+              typed_style.SetStyle(property, value));
+    EXPECT_TRUE(parsed_style == typed_style);
+    EXPECT_EQ(kStyleChangeNone, typed_style.SetStyle(property, value));
+
+    typed.nodes_[i]->SetStyle(property, value);
+    parsed.nodes_[i]->SetStyle(name, string_value);
+    EXPECT_TRUE(*parsed.nodes_[i]->css_style() ==
+                *typed.nodes_[i]->css_style());
+    ExpectSameLayout(typed, parsed);
+  }
+}
+
+}  // namespace
+
+TEST(CSSStyleTest, GridTemplateTracks) {
+  CSSStyle style;
+  style.SetStyle("grid-template-columns", "50px repeat(2, 1fr auto)");
+  const GridTrackList& tracks = style.grid_template_columns();
+  ASSERT_EQ(5u, tracks.count_);
+  EXPECT_EQ(GridTrackSize(kGridTrackFixed, 50.f), tracks.tracks_[0]);
+  EXPECT_EQ(GridTrackSize(kGridTrackFraction, 1.f), tracks.tracks_[1]);
+  EXPECT_EQ(GridTrackSize(kGridTrackAuto, .0f), tracks.tracks_[2]);
+  EXPECT_EQ(tracks.tracks_[1], tracks.tracks_[3]);
+  EXPECT_EQ(tracks.tracks_[2], tracks.tracks_[4]);
+
+  style.SetStyle("grid-template-columns", "none");
+  EXPECT_EQ(0u, style.grid_template_columns().count_);
+}
+
+// copies share the track lists, `none` is the same value as the default
+TEST(CSSStyleTest, GridTemplateTracksCompare) {
+  CSSStyle style;
+  style.SetStyle("grid-template-columns", "1fr 2fr");
+  CSSStyle copy = style;
+  EXPECT_TRUE(copy == style);
+  EXPECT_EQ(style.Hash(), copy.Hash());
+  copy.SetStyle("grid-template-columns", "1fr 3fr");
+  EXPECT_FALSE(copy == style);
+  EXPECT_EQ(GridTrackSize(kGridTrackFraction, 2.f),
+            style.grid_template_columns().tracks_[1]);
+
+  style.SetStyle("grid-template-columns", "none");
+  EXPECT_TRUE(style == CSSStyle());
+  EXPECT_EQ(CSSStyle().Hash(), style.Hash());
+}
+
+TEST(CSSStyleTest, GridTemplateTracksUpToMaxCount) {
+  size_t max_count = GridTrackList::kMaxCount;
+  CSSStyle style;
+  style.SetStyle("grid-template-rows",
+                 "repeat(" + std::to_string(max_count / 2) + ", 1px 2px)");
+  EXPECT_EQ(max_count, style.grid_template_rows().count_);
+
+  style.SetStyle("grid-template-columns", FixedTracks(max_count));
+  EXPECT_EQ(max_count, style.grid_template_columns().count_);
+}
+
+// too many tracks leave the last value in place
+TEST(CSSStyleTest, GridTemplateTracksPastMaxCount) {
+  CSSStyle style;
+  style.SetStyle("grid-template-columns", "10px 20px");
+  const char* values[] = {
+      "10px 10px repeat(9223372036854775807, 1px 1px)",
+      "repeat(4611686018427387904, 1px 1px 1px 1px)",
+      "1px repeat(12, 1px 1px)",
+  };
+  for (const char* value : values) {
+    style.SetStyle("grid-template-columns", value);
+    EXPECT_EQ(2u, style.grid_template_columns().count_) << value;
+  }
+
+  std::string past_max = FixedTracks(GridTrackList::kMaxCount + 1);
+  style.SetStyle("grid-template-columns", past_max);
+  EXPECT_EQ(2u, style.grid_template_columns().count_);
+  style.SetStyle("grid-template-columns", "repeat(1, " + past_max + ")");
+  EXPECT_EQ(2u, style.grid_template_columns().count_);
+}
+
+TEST(CSSStyleTest, GridLines) {
+  CSSStyle style;
+  style.SetStyle("grid-row-start", "3");
+  EXPECT_EQ(GridLine(3, false), style.grid_row_start());
+  style.SetStyle("grid-row-end", "span 2");
+  EXPECT_EQ(GridLine(2, true), style.grid_row_end());
+
+  style.SetStyle("grid-column-start", "100000");
+  EXPECT_EQ(GridLine(GridLine::kMaxValue, false), style.grid_column_start());
+  style.SetStyle("grid-column-end", "span 2147483647");
+  EXPECT_EQ(GridLine(GridLine::kMaxValue, true), style.grid_column_end());
+
+  // not an int, the last value stays
+  style.SetStyle("grid-row-start", "2147483648");
+  EXPECT_EQ(GridLine(3, false), style.grid_row_start());
+  style.SetStyle("grid-row-end", "span 0");
+  EXPECT_EQ(GridLine(2, true), style.grid_row_end());
+}
+
+TEST(CSSStyleTest, FlexBasis) {
+  CSSStyle style;
+  EXPECT_EQ(kStyleChangeSelfSize, style.SetStyle("flex-basis", "120px"));
+  EXPECT_EQ(Length(base::kLengthFixed, 120.f), style.flex_basis());
+  EXPECT_EQ(kStyleChangeNone, style.SetStyle("flex-basis", "120px"));
+  style.SetStyle("flexBasis", "auto");
+  EXPECT_TRUE(style.flex_basis().IsAuto());
+}
+
+// typed values change the style and schedule layout as their strings do
+TEST(CSSStyleTest, TypedSetters) {
+  using base::Length;
+  ExpectTypedSameAsString(kStylePropertyWidth,
+                          Length(base::kLengthFixed, 120.f), "width", "120px");
+  ExpectTypedSameAsString(kStylePropertyMaxHeight,
+                          Length(base::kLengthFixed, 12.f), "max-height",
+                          "12px");
+  ExpectTypedSameAsString(kStylePropertyPadding,
+                          Length(base::kLengthFixed, 6.f), "padding", "6px");
+  ExpectTypedSameAsString(kStylePropertyMarginLeft, Length(base::kLengthAuto),
+                          "margin-left", "auto");
+  ExpectTypedSameAsString(kStylePropertyLeft, Length(base::kLengthFixed, 5.f),
+                          "left", "5px");
+  ExpectTypedSameAsString(kStylePropertyFlexBasis,
+                          Length(base::kLengthFixed, 40.f), "flex-basis",
+                          "40px");
+  ExpectTypedSameAsString(kStylePropertyBorderLeft, 3.f, "border-left", "3px");
+  ExpectTypedSameAsString(kStylePropertyFlex, 2.f, "flex", "2");
+  ExpectTypedSameAsString(kStylePropertyFlexShrink, .0f, "flex-shrink", "0");
+  ExpectTypedSameAsString(kStylePropertyOrder, 1, "order", "1");
+  ExpectTypedSameAsString(kStylePropertyPosition, kPositionAbsolute, "position",
+                          "absolute");
+  ExpectTypedSameAsString(kStylePropertyDisplay, kDisplayNone, "display",
+                          "none");
+  ExpectTypedSameAsString(kStylePropertyFlexDirection, kFlexDirectionColumn,
+                          "flex-direction", "column");
+  ExpectTypedSameAsString(kStylePropertyFlexWrap, kFlexWrapNoWrap, "flex-wrap",
+                          "nowrap");
+  ExpectTypedSameAsString(kStylePropertyJustifyContent, kJustifyContentCenter,
+                          "justify-content", "center");
+  ExpectTypedSameAsString(kStylePropertyAlignItems, kAlignItemsFlexEnd,
+                          "align-items", "flex-end");
+  ExpectTypedSameAsString(kStylePropertyAlignSelf, kAlignSelfFlexEnd,
+                          "align-self", "flex-end");
+  ExpectTypedSameAsString(kStylePropertyAlignSelf, kAlignSelfStretch,
+                          "align-self", "stretch");
+  ExpectTypedSameAsString(kStylePropertyAlignContent,
+                          kAlignContentSpaceBetween, "align-content",
+                          "space-between");
+
+  CSSStyle tracks;
+  tracks.SetStyle("grid-template-columns", "20px 1fr");
+  ExpectTypedSameAsString(kStylePropertyGridTemplateColumns,
+                          tracks.grid_template_columns(),
+                          "grid-template-columns", "20px 1fr");
+  ExpectTypedSameAsString(kStylePropertyGridColumnEnd, GridLine(2, true),
+                          "grid-column-end", "span 2");
+}
+
+// a block changes the style, reports its changes and schedules layout as its
+// declarations set one by one do, given as text or as declarations
+TEST(CSSStyleTest, SetStyles) {
+  const struct {
+    const char* text_;
+    std::vector<StyleDeclaration> declarations_;
+  } blocks[] = {
+      {"width: 80px; padding: 3px; justify-content: center",
+       {{"width", "80px"}, {"padding", "3px"}, {"justify-content", "center"}}},
+      {" align-items : flex-end ;; margin-left:auto;",
+       {{"align-items", "flex-end"}, {"margin-left", "auto"}}},
+      {"bogus; height 5px; unknown-name: 3px; left: 7px",
+       {{"unknown-name", "3px"}, {"left", "7px"}}},
+      {"flex-direction: column; flex-direction: row",
+       {{"flex-direction", "column"}, {"flex-direction", "row"}}},
+      {"align-self: stretch; top: 2px; flex-grow: 2",
+       {{"align-self", "stretch"}, {"top", "2px"}, {"flex-grow", "2"}}},
+      {"width: 50px; height: 20px", {{"width", "50px"}, {"height", "20px"}}},
+      {"", {}},
+  };
+  size_t count = StyledTree().nodes_.size();
+  for (const auto& block : blocks) {
+    for (size_t i = 0; i < count; ++i) {
+      SCOPED_TRACE(std::string(block.text_) + " on node " + std::to_string(i));
+      StyledTree one_by_one;
+      StyledTree texts;
+      CSSStyle expected_style(*one_by_one.nodes_[i]->css_style());
+      CSSStyle style(expected_style);
+      unsigned changes = 0;
+      for (const StyleDeclaration& declaration : block.declarations_) {
+        changes |= StyleChangeBit(
+            expected_style.SetStyle(declaration.name_, declaration.value_));
+      }
+      EXPECT_EQ(changes, style.SetStyles(block.text_));
+      EXPECT_TRUE(expected_style == style);
+
+      for (const StyleDeclaration& declaration : block.declarations_) {
+        one_by_one.nodes_[i]->SetStyle(declaration.name_, declaration.value_);
+      }
+      EXPECT_EQ(changes != 0, texts.nodes_[i]->SetStyles(block.text_));
+      EXPECT_TRUE(*one_by_one.nodes_[i]->css_style() ==
+                  *texts.nodes_[i]->css_style());
+      ExpectSameLayout(texts, one_by_one);
+
+      StyledTree one_by_one_again;
+      StyledTree declarations;
+      for (const StyleDeclaration& declaration : block.declarations_) {
+        one_by_one_again.nodes_[i]->SetStyle(declaration.name_,
+                                             declaration.value_);
+      }
+      EXPECT_EQ(changes != 0,
+                declarations.nodes_[i]->SetStyles(block.declarations_.data(),
+                                                  block.declarations_.size()));
+      ExpectSameLayout(declarations, one_by_one_again);
+    }
+  }
+}
+
+}  // namespace starlight
\ No newline at end of file
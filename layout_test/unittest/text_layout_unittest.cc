@@ -0,0 +1,164 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+#include "layout/text_layout.h"
+
+namespace starlight {
+
+namespace {
+
+// latin-1 glyphs 10px wide, spaces 5px and `é` 7px, anything else 20px
+FontMetrics TestFont() {
+  FontMetrics font;
+  font.advances_.assign(0x100, 10.f);
+  font.advances_[' '] = 5.f;
+  font.advances_[0xE9] = 7.f;
+  font.default_advance_ = 20.f;
+  font.line_height_ = 16.f;
+  return font;
+}
+
+typedef std::vector<size_t> Starts;
+
+}  // namespace
+
+TEST(TextLayoutTest, Unbroken) {
+  TextLayout text("hello world", TestFont());
+  FloatSize size = text.Measure(.0f, kLayoutModeUndefined);
+  EXPECT_EQ(105, size.width_);
+  EXPECT_EQ(16, size.height_);
+  EXPECT_EQ(Starts({0}), text.LineStarts(.0f, kLayoutModeUndefined));
+  // the width is not read without a mode
+  EXPECT_EQ(105, text.Measure(20, kLayoutModeUndefined).width_);
+}
+
+TEST(TextLayoutTest, Empty) {
+  TextLayout text("", TestFont());
+  FloatSize size = text.Measure(100, kLayoutModeAtMost);
+  EXPECT_EQ(0, size.width_);
+  EXPECT_EQ(0, size.height_);
+  EXPECT_TRUE(text.LineStarts(100, kLayoutModeAtMost).empty());
+}
+
+TEST(TextLayoutTest, BreakAtSpaces) {
+  TextLayout text("hello world again", TestFont());
+  FloatSize size = text.Measure(110, kLayoutModeAtMost);
+  EXPECT_EQ(105, size.width_);
+  EXPECT_EQ(32, size.height_);
+  EXPECT_EQ(Starts({0, 12}), text.LineStarts(110, kLayoutModeAtMost));
+
+  EXPECT_EQ(Starts({0, 6, 12}), text.LineStarts(104, kLayoutModeExact));
+  EXPECT_EQ(50, text.Measure(104, kLayoutModeExact).width_);
+}
+
+// spaces ending a line hang past it, they neither break nor widen the line
+TEST(TextLayoutTest, HangingSpaces) {
+  TextLayout text("ab    cd  ", TestFont());
+  EXPECT_EQ(60, text.Measure(.0f, kLayoutModeUndefined).width_);
+  EXPECT_EQ(Starts({0, 6}), text.LineStarts(30, kLayoutModeAtMost));
+  EXPECT_EQ(20, text.Measure(30, kLayoutModeAtMost).width_);
+  EXPECT_EQ(Starts({0, 6}), text.LineStarts(20, kLayoutModeAtMost));
+}
+
+// a word wider than the line takes a line of its own and overflows it
+TEST(TextLayoutTest, LongWords) {
+  TextLayout text("a abcdefghij b", TestFont());
+  EXPECT_EQ(Starts({0, 2, 13}), text.LineStarts(50, kLayoutModeAtMost));
+  FloatSize size = text.Measure(50, kLayoutModeAtMost);
+  EXPECT_EQ(100, size.width_);
+  EXPECT_EQ(48, size.height_);
+}
+
+TEST(TextLayoutTest, LineFeeds) {
+  TextLayout text("ab\ncd ef", TestFont());
+  EXPECT_EQ(Starts({0, 3}), text.LineStarts(.0f, kLayoutModeUndefined));
+  EXPECT_EQ(45, text.Measure(.0f, kLayoutModeUndefined).width_);
+  EXPECT_EQ(Starts({0, 3, 6}), text.LineStarts(30, kLayoutModeAtMost));
+
+  // empty lines, spaces opening a line take their width
+  TextLayout lines("\nab\n\n  cd", TestFont());
+  EXPECT_EQ(Starts({0, 1, 4, 5}),
+            lines.LineStarts(.0f, kLayoutModeUndefined));
+  FloatSize size = lines.Measure(.0f, kLayoutModeUndefined);
+  EXPECT_EQ(30, size.width_);
+  EXPECT_EQ(64, size.height_);
+}
+
+// lines break before and after every ideograph, without spaces
+TEST(TextLayoutTest, IdeographicBreaks) {
+  // 3 bytes each
+  TextLayout text("\xE4\xB8\xAD\xE6\x96\x87\xE5\xAD\x97", TestFont());
+  EXPECT_EQ(60, text.Measure(.0f, kLayoutModeUndefined).width_);
+  EXPECT_EQ(Starts({0, 6}), text.LineStarts(45, kLayoutModeAtMost));
+  EXPECT_EQ(40, text.Measure(45, kLayoutModeAtMost).width_);
+
+  TextLayout mixed("ab\xE4\xB8\xAD" "cd", TestFont());
+  EXPECT_EQ(Starts({0, 2, 5}), mixed.LineStarts(30, kLayoutModeAtMost));
+  EXPECT_EQ(Starts({0, 5}), mixed.LineStarts(40, kLayoutModeAtMost));
+
+  // U+20000, 4 bytes
+  TextLayout supplementary("a\xF0\xA0\x80\x80" "b", TestFont());
+  EXPECT_EQ(40, supplementary.Measure(.0f, kLayoutModeUndefined).width_);
+  EXPECT_EQ(Starts({0, 1, 5}),
+            supplementary.LineStarts(25, kLayoutModeAtMost));
+}
+
+TEST(TextLayoutTest, DecodeUtf8) {
+  EXPECT_EQ(27, TextLayout("a\xC3\xA9" "b", TestFont())
+                    .Measure(.0f, kLayoutModeUndefined)
+                    .width_);
+  // malformed sequences decode to one replacement character per byte: a
+  // truncated sequence, a stray trail byte, a lead byte of no sequence and a
+  // lead byte not followed by a trail byte
+  EXPECT_EQ(40, TextLayout("\xE4\xB8", TestFont())
+                    .Measure(.0f, kLayoutModeUndefined)
+                    .width_);
+  EXPECT_EQ(40, TextLayout("a\xA9" "b", TestFont())
+                    .Measure(.0f, kLayoutModeUndefined)
+                    .width_);
+  EXPECT_EQ(20, TextLayout("\xFF", TestFont())
+                    .Measure(.0f, kLayoutModeUndefined)
+                    .width_);
+  EXPECT_EQ(30, TextLayout("\xC3" "A", TestFont())
+                    .Measure(.0f, kLayoutModeUndefined)
+                    .width_);
+}
+
+// breaks of more widths than are cached are computed again alike
+TEST(TextLayoutTest, CachedWidths) {
+  TextLayout text("one two three four five six", TestFont());
+  const float widths[] = {60, 80, 100, 120, 140, 60, 140, 80};
+  std::vector<Starts> expected;
+  for (float width : widths) {
+    TextLayout fresh("one two three four five six", TestFont());
+    expected.push_back(fresh.LineStarts(width, kLayoutModeAtMost));
+  }
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i], text.LineStarts(widths[i], kLayoutModeAtMost))
+        << widths[i];
+  }
+}
+
+// a text leaf stretched across a column is as high as its lines
+TEST(TextLayoutTest, TextLeaf) {
+  LayoutContext layout_context;
+  int font = layout_context.RegisterFont(TestFont());
+  LayoutTree tree(&layout_context);
+  LayoutNode* root = tree.CreateNode();
+  root->SetStyle("flex-direction", "column");
+  LayoutNode* leaf = tree.CreateNode();
+  leaf->SetText("hello world again", font);
+  leaf->SetStyle("padding", "2px");
+  root->InsertChild(leaf);
+  root->ReLayout(0, 0, 114, 200);
+  EXPECT_EQ(114, leaf->offset_width());
+  EXPECT_EQ(36, leaf->offset_height());
+}
+
+}  // namespace starlight
\ No newline at end of file
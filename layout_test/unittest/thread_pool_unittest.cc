@@ -0,0 +1,230 @@
+// Copyright 2020 Infinite Synthesis(T.C.V.). All rights reserved.
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "base/thread_pool.h"
+#include "layout/layout_context.h"
+#include "layout/layout_node.h"
+#include "layout/layout_tree.h"
+
+namespace base {
+
+namespace {
+
+// leaves below `depth` levels of groups forking two tasks each
+int CountLeaves(ThreadPool* pool, int depth) {
+  if (depth == 0) {
+    return 1;
+  }
+  int counts[2] = {0, 0};
+  TaskGroup group(pool);
+  for (int& count : counts) {
+    group.Run([pool, depth, &count] { count = CountLeaves(pool, depth - 1); });
+  }
+  group.Wait();
+  return counts[0] + counts[1];
+}
+
+}  // namespace
+
+TEST(ThreadPoolTest, RunWithoutPool) {
+  EXPECT_EQ(nullptr, ThreadPool::Current());
+  int runs = 0;
+  TaskGroup group(nullptr);
+  group.Run([&runs] { ++runs; });
+  // tasks without a pool have run before Run returns
+  EXPECT_EQ(1, runs);
+  group.Wait();
+  EXPECT_EQ(1, runs);
+}
+
+TEST(ThreadPoolTest, Scope) {
+  ThreadPool pool(2);
+  ThreadPool other_pool(1);
+  EXPECT_EQ(2u, pool.thread_count());
+  {
+    ThreadPool::Scope scope(&pool);
+    EXPECT_EQ(&pool, ThreadPool::Current());
+    {
+      ThreadPool::Scope inner_scope(&other_pool);
+      EXPECT_EQ(&other_pool, ThreadPool::Current());
+    }
+    EXPECT_EQ(&pool, ThreadPool::Current());
+
+    // workers see their own pool
+    std::atomic<int> wrong_pools(0);
+    TaskGroup group(&pool);
+    for (int i = 0; i < 64; ++i) {
+      group.Run([&pool, &wrong_pools] {
+        wrong_pools += ThreadPool::Current() != &pool;
+      });
+    }
+    group.Wait();
+    EXPECT_EQ(0, wrong_pools.load());
+  }
+  EXPECT_EQ(nullptr, ThreadPool::Current());
+}
+
+TEST(ThreadPoolTest, RunAllTasks) {
+  ThreadPool pool(4);
+  ThreadPool::Scope scope(&pool);
+  std::atomic<int> runs(0);
+  {
+    TaskGroup group(&pool);
+    for (int i = 0; i < 1000; ++i) {
+      group.Run([&runs] { ++runs; }, i % 3 != 0);
+    }
+    group.Wait();
+    EXPECT_EQ(1000, runs.load());
+  }
+  // the destructor waits as well
+  {
+    TaskGroup group(&pool);
+    for (int i = 0; i < 1000; ++i) {
+      group.Run([&runs] { ++runs; });
+    }
+  }
+  EXPECT_EQ(2000, runs.load());
+}
+
+// tasks fork groups of their own and wait for them, running queued tasks
+// meanwhile instead of blocking their worker
+TEST(ThreadPoolTest, NestedRun) {
+  ThreadPool pool(3);
+  ThreadPool::Scope scope(&pool);
+  EXPECT_EQ(1 << 12, CountLeaves(&pool, 12));
+
+  ThreadPool single_pool(1);
+  ThreadPool::Scope single_scope(&single_pool);
+  EXPECT_EQ(1 << 10, CountLeaves(&single_pool, 10));
+}
+
+// two tasks which only finish once both have started have to run at the same
+// time: while the forking thread waits on one, a worker steals the other
+TEST(ThreadPoolTest, StealTasks) {
+  ThreadPool pool(2);
+  ThreadPool::Scope scope(&pool);
+  std::atomic<int> started(0);
+  std::atomic<int> met(0);
+  auto meet = [&started, &met] {
+    ++started;
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (started.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::yield();
+    }
+    met += started.load() == 2;
+  };
+  TaskGroup group(&pool);
+  group.Run(meet);
+  group.Run(meet);
+  group.Wait();
+  EXPECT_EQ(2, met.load());
+}
+
+}  // namespace base
+
+namespace starlight {
+
+namespace {
+
+LayoutNode* AddNode(LayoutTree& tree,
+                    LayoutNode* parent,
+                    const std::string& styles) {
+  LayoutNode* node = tree.CreateNode();
+  node->SetStyles(styles);
+  if (parent) {
+    parent->InsertChild(node);
+  }
+  return node;
+}
+
+// a feed of wrapping cards of flexible, clamped items at fractional sizes,
+// its nodes in the order they were created
+std::vector<LayoutNode*> BuildFeed(LayoutTree& tree) {
+  std::vector<LayoutNode*> nodes;
+  LayoutNode* feed = AddNode(tree, nullptr, "flex-direction: column");
+  nodes.push_back(feed);
+  for (int i = 0; i < 40; ++i) {
+    LayoutNode* card = AddNode(
+        tree, feed,
+        "flex-direction: row; flex-wrap: wrap; padding: 3.3px; "
+        "align-items: center; justify-content: space-around");
+    nodes.push_back(card);
+    for (int j = 0; j < 9; ++j) {
+      std::string styles =
+          "flex-basis: " + std::to_string(20 + (i * 7 + j * 13) % 70) +
+          ".7px; height: " + std::to_string(10 + (i + j) % 5 * 3) +
+          ".1px; flex-grow: " + std::to_string(j % 3) +
+          "; flex-shrink: " + std::to_string(1 + j % 2) + "; margin: 1.9px";
+      if (j % 4 == 1) {
+        styles += "; max-width: 61.3px";
+      }
+      if (j % 4 == 2) {
+        styles += "; min-width: 47.9px";
+      }
+      LayoutNode* item = AddNode(tree, card, styles);
+      nodes.push_back(item);
+      if (j % 3 == 0) {
+        LayoutNode* column = AddNode(tree, item, "flex-direction: column");
+        nodes.push_back(column);
+        nodes.push_back(AddNode(tree, column, "height: 5.5px; width: 9.2px"));
+        nodes.push_back(AddNode(tree, column, "height: 7.25px"));
+      }
+    }
+  }
+  return nodes;
+}
+
+void ExpectSameBoxes(const std::vector<LayoutNode*>& nodes,
+                     const std::vector<LayoutNode*>& expected) {
+  ASSERT_EQ(expected.size(), nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    SCOPED_TRACE(i);
+    EXPECT_EQ(expected[i]->offset_left(), nodes[i]->offset_left());
+    EXPECT_EQ(expected[i]->offset_top(), nodes[i]->offset_top());
+    EXPECT_EQ(expected[i]->offset_width(), nodes[i]->offset_width());
+    EXPECT_EQ(expected[i]->offset_height(), nodes[i]->offset_height());
+  }
+}
+
+}  // namespace
+
+// subtrees laid out on the threads of a pool give the boxes of the serial
+// pass bit for bit, also when only parts are laid out again
+TEST(ParallelLayoutTest, SameAsSerial) {
+  LayoutContext layout_context;
+  LayoutTree serial_tree(&layout_context);
+  std::vector<LayoutNode*> serial = BuildFeed(serial_tree);
+  LayoutTree parallel_tree(&layout_context);
+  std::vector<LayoutNode*> parallel = BuildFeed(parallel_tree);
+  LayoutTree scoped_tree(&layout_context);
+  std::vector<LayoutNode*> scoped = BuildFeed(scoped_tree);
+  base::ThreadPool pool(3);
+
+  const int widths[] = {360, 517, 360, 240};
+  for (int width : widths) {
+    SCOPED_TRACE(width);
+    serial[0]->ReLayout(0, 0, width, 5000);
+    parallel[0]->ReLayout(0, 0, width, 5000, &pool);
+    {
+      base::ThreadPool::Scope scope(&pool);
+      scoped[0]->ReLayout(0, 0, width, 5000);
+    }
+    ExpectSameBoxes(parallel, serial);
+    ExpectSameBoxes(scoped, serial);
+
+    for (std::vector<LayoutNode*>* nodes : {&serial, &parallel, &scoped}) {
+      (*nodes)[width % 97]->SetStyle("flex-grow", "3");
+      (*nodes)[width % 89]->SetStyle("margin", "4.4px");
+    }
+  }
+}
+
+}  // namespace starlight
\ No newline at end of file